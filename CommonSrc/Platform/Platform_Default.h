@@ -24,6 +24,11 @@ limitations under the License.
 // This should select proper header file for the platform/compiler.
 #include <Kernel/OVR_Types.h>
 
+// Records commands without drawing; selected with "-r null" on every platform.
+#include "../Render/Render_Null_Device.h"
+// Draws on the CPU; selected with "-r soft" on every platform.
+#include "../Render/Render_Soft_Device.h"
+
 #if defined(OVR_OS_WIN32)
   #include "Win32_Platform.h"
 
@@ -36,19 +41,25 @@ limitations under the License.
 // while avoiding linking extra classes.
   #define OVR_DEFAULT_RENDER_DEVICE_SET                                                    \
         SetupGraphicsDeviceSet("D3D11", &OVR::Render::D3D11::RenderDevice::CreateDevice,       \
-        SetupGraphicsDeviceSet("D3D10", &OVR::Render::D3D10::RenderDevice::CreateDevice) )
+        SetupGraphicsDeviceSet("D3D10", &OVR::Render::D3D10::RenderDevice::CreateDevice,       \
+        SetupGraphicsDeviceSet("Soft",  &OVR::Render::Soft::RenderDevice::CreateDevice,        \
+        SetupGraphicsDeviceSet("Null",  &OVR::Render::Null::RenderDevice::CreateDevice) ) ) )
 
 #elif defined(OVR_OS_MAC) && !defined(OVR_MAC_X11)
   #include "MacOS_Platform.h"
 
   #define OVR_DEFAULT_RENDER_DEVICE_SET                                         \
-    SetupGraphicsDeviceSet("GL", &OVR::Render::GL::MacOS::RenderDevice::CreateDevice)
+    SetupGraphicsDeviceSet("GL", &OVR::Render::GL::MacOS::RenderDevice::CreateDevice,   \
+    SetupGraphicsDeviceSet("Soft", &OVR::Render::Soft::RenderDevice::CreateDevice,    \
+    SetupGraphicsDeviceSet("Null", &OVR::Render::Null::RenderDevice::CreateDevice) ) )
 
 #else
 
   #include "X11_Platform.h"
 
   #define OVR_DEFAULT_RENDER_DEVICE_SET                                         \
-    SetupGraphicsDeviceSet("GL", &OVR::Render::GL::X11::RenderDevice::CreateDevice)
+    SetupGraphicsDeviceSet("GL", &OVR::Render::GL::X11::RenderDevice::CreateDevice,     \
+    SetupGraphicsDeviceSet("Soft", &OVR::Render::Soft::RenderDevice::CreateDevice,    \
+    SetupGraphicsDeviceSet("Null", &OVR::Render::Null::RenderDevice::CreateDevice) ) )
 
 #endif
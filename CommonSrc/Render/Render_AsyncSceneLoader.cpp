@@ -0,0 +1,250 @@
+/************************************************************************************
+
+Filename    :   Render_AsyncSceneLoader.cpp
+Content     :   Loads scene files on a background thread while rendering continues
+Created     :   October 17, 2026
+Authors     :
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************************/
+
+#include "Render_AsyncSceneLoader.h"
+#include "Render_CompiledScene.h"
+#include <Kernel/OVR_Log.h>
+#include <Kernel/OVR_Timer.h>
+
+#ifdef OVR_DEFINE_NEW
+#undef new
+#endif
+
+namespace OVR { namespace Render {
+
+AsyncSceneLoader::AsyncSceneLoader(WorkerPool* workers, TextureCache* textureCache)
+    : pWorkers(workers), State(Load_Idle),
+      ThreadRunning(false), ParseDone(false), ParseFailed(false), Cancel(false),
+      TexturesDecoded(0), TexturesCreated(0), ModelsAdded(0)
+{
+    Handler.SetTextureCache(textureCache);
+}
+
+AsyncSceneLoader::~AsyncSceneLoader()
+{
+    {
+        Mutex::Locker lock(&Lock);
+        Cancel = true;
+    }
+    WaitForThread();
+}
+
+bool AsyncSceneLoader::Start(const char* fileName)
+{
+    if (State == Load_Running)
+    {
+        return false;
+    }
+
+    FileName        = fileName;
+    State           = Load_Running;
+    ParseDone       = false;
+    ParseFailed     = false;
+    Cancel          = false;
+    TexturesDecoded = 0;
+    TexturesCreated = 0;
+    ModelsAdded     = 0;
+    TextureReady.Clear();
+
+    ThreadRunning = true;
+    Ptr<LoaderThread> thread = *new LoaderThread(this);
+    if (!thread->Start())
+    {
+        ThreadRunning = false;
+        State         = Load_Failed;
+        return false;
+    }
+    return true;
+}
+
+int AsyncSceneLoader::LoaderThread::Run()
+{
+    pLoader->LoadInBackground();
+    return 0;
+}
+
+void AsyncSceneLoader::LoadInBackground()
+{
+    bool parsed = ParseSceneFile(&Handler, FileName.ToCStr(), pWorkers);
+
+    UPInt textureCount = parsed ? Handler.GetTextureCount() : 0;
+    {
+        Mutex::Locker lock(&Lock);
+        TextureReady.Resize(textureCount);
+        for (UPInt i = 0; i < textureCount; i++)
+        {
+            TextureReady[i] = false;
+        }
+        ParseFailed = !parsed;
+        ParseDone   = true;
+    }
+
+    // Textures are decoded in index order as far as possible, which is the
+    // order Update creates them in.
+    if (pWorkers)
+    {
+        pWorkers->ParallelFor(textureCount, LoadTextureJob, this);
+    }
+    else
+    {
+        for (UPInt i = 0; i < textureCount; i++)
+        {
+            LoadTextureJob(this, i);
+        }
+    }
+
+    Mutex::Locker lock(&Lock);
+    ThreadRunning = false;
+    ThreadDone.NotifyAll();
+}
+
+void AsyncSceneLoader::LoadTextureJob(void* context, UPInt index)
+{
+    AsyncSceneLoader* loader = (AsyncSceneLoader*)context;
+    {
+        Mutex::Locker lock(&loader->Lock);
+        if (loader->Cancel)
+            return;
+    }
+
+    loader->Handler.LoadTextureData(index);
+
+    Mutex::Locker lock(&loader->Lock);
+    loader->TextureReady[index] = true;
+    loader->TexturesDecoded.ExchangeAdd_Sync(1);
+}
+
+void AsyncSceneLoader::WaitForThread()
+{
+    Mutex::Locker lock(&Lock);
+    while (ThreadRunning)
+    {
+        ThreadDone.Wait(&Lock);
+    }
+}
+
+AsyncSceneLoader::LoadState AsyncSceneLoader::Update(RenderDevice* pRender, Scene* pScene,
+                                                     Array<Ptr<CollisionModel> >* pCollisions,
+                                                     Array<Ptr<CollisionModel> >* pGroundCollisions,
+                                                     double budgetSeconds)
+{
+    if (State != Load_Running)
+    {
+        return State;
+    }
+
+    {
+        Mutex::Locker lock(&Lock);
+        if (!ParseDone)
+            return State;
+        if (ParseFailed)
+            State = Load_Failed;
+    }
+    if (State == Load_Failed)
+    {
+        WaitForThread();
+        return State;
+    }
+
+    const UInt64 budgetTicks = (UInt64)(budgetSeconds * Timer::MksPerSecond);
+    const UInt64 startTicks  = Timer::GetTicks();
+    bool         firstItem   = true;
+
+    // Textures first, since the model fills refer to them.
+    const UPInt textureCount = Handler.GetTextureCount();
+    while (TexturesCreated < textureCount)
+    {
+        {
+            Mutex::Locker lock(&Lock);
+            if (!TextureReady[TexturesCreated])
+                return State;
+        }
+        if (!firstItem && Timer::GetTicks() - startTicks > budgetTicks)
+            return State;
+
+        Handler.CreateTexture(pRender, TexturesCreated++);
+        firstItem = false;
+    }
+
+    while (ModelsAdded < Handler.GetModelCount())
+    {
+        if (!firstItem && Timer::GetTicks() - startTicks > budgetTicks)
+            return State;
+
+        Handler.AddModel(pRender, pScene, ModelsAdded++);
+        firstItem = false;
+    }
+
+    // All textures are decoded by now, so the thread is finishing up.
+    WaitForThread();
+    Handler.AddCollisionModels(pCollisions, pGroundCollisions);
+    State = Load_Finished;
+    return State;
+}
+
+float AsyncSceneLoader::GetProgress() const
+{
+    // Phase weights roughly follow where the time goes for Tuscany.
+    static const float parseWeight         = 0.4f;
+    static const float textureDecodeWeight = 0.3f;
+    static const float textureCreateWeight = 0.2f;
+    static const float modelAddWeight      = 0.1f;
+
+    if (State == Load_Finished)
+        return 1.0f;
+    if (State != Load_Running)
+        return 0.0f;
+
+    int modelsToDecode = Handler.GetModelsToDecode();
+    if (modelsToDecode == 0)
+        return 0.0f;
+
+    float progress = parseWeight * Handler.GetModelsDecoded() / modelsToDecode;
+
+    UPInt textureCount;
+    {
+        Mutex::Locker lock(&Lock);
+        if (!ParseDone)
+            return progress;
+        textureCount = TextureReady.GetSize();
+    }
+
+    progress = parseWeight;
+    if (textureCount > 0)
+    {
+        progress += textureDecodeWeight * (int)TexturesDecoded / textureCount;
+        progress += textureCreateWeight * TexturesCreated / textureCount;
+    }
+    else
+    {
+        progress += textureDecodeWeight + textureCreateWeight;
+    }
+    progress += modelAddWeight * ModelsAdded / modelsToDecode;
+    return Alg::Min(progress, 1.0f);
+}
+
+}} // OVR::Render
+
+#ifdef OVR_DEFINE_NEW
+#define new OVR_DEFINE_NEW
+#endif
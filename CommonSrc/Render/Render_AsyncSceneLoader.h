@@ -0,0 +1,108 @@
+/************************************************************************************
+
+Filename    :   Render_AsyncSceneLoader.h
+Content     :   Loads scene files on a background thread while rendering continues
+Created     :   October 17, 2026
+Authors     :
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************************/
+
+#ifndef INC_Render_AsyncSceneLoader_h
+#define INC_Render_AsyncSceneLoader_h
+
+#include "Render_XmlSceneLoader.h"
+
+namespace OVR { namespace Render {
+
+// AsyncSceneLoader reads and parses a scene file and decodes its textures on a
+// background thread. The rendering thread calls Update once per frame to create
+// the GPU textures and add the models to the scene as they become ready, doing
+// no more than a given amount of work per frame.
+class AsyncSceneLoader : public RefCountBase<AsyncSceneLoader>
+{
+public:
+    enum LoadState
+    {
+        Load_Idle,
+        Load_Running,
+        Load_Finished,
+        Load_Failed
+    };
+
+    // pWorkers, if given, is used by the background thread for model and texture decoding;
+    // pTextureCache, if given, supplies and keeps the decoded textures.
+    AsyncSceneLoader(WorkerPool* pWorkers = NULL, TextureCache* pTextureCache = NULL);
+    ~AsyncSceneLoader();
+
+    // Applied to the scene's textures on the loader thread; call before Start.
+    void      SetTextureCompression(TextureCompression quality) { Handler.SetTextureCompression(quality); }
+
+    // Starts loading fileName; the compiled scene is used if it is current.
+    bool      Start(const char* fileName);
+
+    // Creates GPU resources for whatever the background thread has finished and
+    // adds it to the scene, stopping once budgetSeconds have been spent (at least one
+    // item is always processed). Collision hulls are added in the final step.
+    LoadState Update(RenderDevice* pRender, Scene* pScene,
+                     Array<Ptr<CollisionModel> >* pCollisions,
+                     Array<Ptr<CollisionModel> >* pGroundCollisions,
+                     double budgetSeconds);
+
+    LoadState GetState() const { return State; }
+
+    // Fraction of the load completed, from 0 to 1, counting model decoding, texture
+    // decoding, texture creation and model setup.
+    float     GetProgress() const;
+
+private:
+    class LoaderThread : public Thread
+    {
+    public:
+        LoaderThread(AsyncSceneLoader* loader) : pLoader(loader) { }
+        virtual int Run();
+    private:
+        AsyncSceneLoader* pLoader;
+    };
+
+    void        LoadInBackground();
+    static void LoadTextureJob(void* context, UPInt index);
+    void        WaitForThread();
+
+    XmlHandler          Handler;
+    Ptr<WorkerPool>     pWorkers;
+    String              FileName;
+    LoadState           State;
+
+    // Shared with the background thread, protected by Lock.
+    mutable Mutex       Lock;
+    WaitCondition       ThreadDone;
+    bool                ThreadRunning;
+    bool                ParseDone;
+    bool                ParseFailed;
+    bool                Cancel;
+    Array<bool>         TextureReady;
+
+    AtomicInt<SInt32>   TexturesDecoded;
+
+    // Rendering thread progress.
+    UPInt               TexturesCreated;
+    UPInt               ModelsAdded;
+};
+
+}} // OVR::Render
+
+#endif // INC_Render_AsyncSceneLoader_h
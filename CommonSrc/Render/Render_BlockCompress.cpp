@@ -0,0 +1,688 @@
+/************************************************************************************
+
+Filename    :   Render_BlockCompress.cpp
+Content     :   BC1/BC3 (DXT1/DXT5) texture compression and decompression
+Created     :   October 17, 2026
+Authors     :
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************************/
+
+#include "Render_Device.h"
+#include "Render_WorkerPool.h"
+#include "Render_Simd.h"
+
+#include <math.h>
+
+namespace OVR { namespace Render {
+
+// Blocks are 4x4 pixels, held as 16 RGBA pixels in row order. Blocks that extend
+// past the image edge repeat the last row and column.
+//
+// Color endpoints come from the bounding box of the block and, except with Fast,
+// also from the pixels furthest apart along its principal axis, keeping the better
+// of the two; each is improved by least-squares fitting to the chosen indices. Every pixel always gets
+// the index of the nearest palette color; that search and the bounding box are
+// done with SSE2 and give exactly the same result as the scalar code.
+
+struct ColorBlock
+{
+    UInt16 Color0, Color1;
+    UInt32 Indices;
+    int    Error;         // Sum of squared RGB differences.
+};
+
+// *** 565 conversion
+
+static inline UInt16 PackColor565(int r, int g, int b)
+{
+    return (UInt16)((((r * 31 + 127) / 255) << 11) | (((g * 63 + 127) / 255) << 5) | ((b * 31 + 127) / 255));
+}
+
+static inline void UnpackColor565(UInt16 c, int* rgb)
+{
+    int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+    rgb[0] = (r << 3) | (r >> 2);
+    rgb[1] = (g << 2) | (g >> 4);
+    rgb[2] = (b << 3) | (b >> 2);
+}
+
+// Palette of the 4-color mode, as RGB0 bytes.
+static void GetColorPalette(UInt16 color0, UInt16 color1, UByte palette[4][4])
+{
+    int c0[3], c1[3];
+    UnpackColor565(color0, c0);
+    UnpackColor565(color1, c1);
+    for (int i = 0; i < 3; i++)
+    {
+        palette[0][i] = (UByte)c0[i];
+        palette[1][i] = (UByte)c1[i];
+        palette[2][i] = (UByte)((2 * c0[i] + c1[i]) / 3);
+        palette[3][i] = (UByte)((c0[i] + 2 * c1[i]) / 3);
+    }
+    palette[0][3] = palette[1][3] = palette[2][3] = palette[3][3] = 0;
+}
+
+// *** Nearest palette color search
+
+#if defined(OVR_RENDER_SSE2)
+
+// Four pixels at a time: with alpha zeroed, madd of the 16-bit RGBA difference with
+// itself gives dr^2 + dg^2 and db^2 per pixel, which are then added pairwise.
+static int FindColorIndices(const UByte* block, const UByte palette[4][4], UInt32* indices)
+{
+    const __m128i zero    = _mm_setzero_si128();
+    const __m128i rgbMask = _mm_set1_epi32(0x00FFFFFF);
+
+    __m128i pal[4];
+    for (int k = 0; k < 4; k++)
+    {
+        UInt32 c;
+        memcpy(&c, palette[k], 4);
+        pal[k] = _mm_unpacklo_epi8(_mm_set1_epi32((int)c), zero);
+    }
+
+    UInt32 packed = 0;
+    int    error  = 0;
+    for (int g = 0; g < 4; g++)
+    {
+        __m128i pixels = _mm_and_si128(_mm_loadu_si128((const __m128i*)(block + g * 16)), rgbMask);
+        __m128i lo     = _mm_unpacklo_epi8(pixels, zero);
+        __m128i hi     = _mm_unpackhi_epi8(pixels, zero);
+
+        __m128i bestDist = _mm_set1_epi32(0x7FFFFFFF);
+        __m128i best     = zero;
+        for (int k = 0; k < 4; k++)
+        {
+            __m128i dlo = _mm_sub_epi16(lo, pal[k]);
+            __m128i dhi = _mm_sub_epi16(hi, pal[k]);
+            __m128  slo = _mm_castsi128_ps(_mm_madd_epi16(dlo, dlo));
+            __m128  shi = _mm_castsi128_ps(_mm_madd_epi16(dhi, dhi));
+            __m128i dist = _mm_add_epi32(_mm_castps_si128(_mm_shuffle_ps(slo, shi, _MM_SHUFFLE(2, 0, 2, 0))),
+                                         _mm_castps_si128(_mm_shuffle_ps(slo, shi, _MM_SHUFFLE(3, 1, 3, 1))));
+            __m128i closer = _mm_cmplt_epi32(dist, bestDist);
+            bestDist = _mm_or_si128(_mm_and_si128(closer, dist), _mm_andnot_si128(closer, bestDist));
+            best     = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32(k)), _mm_andnot_si128(closer, best));
+        }
+
+        int bestIndex[4], bestError[4];
+        _mm_storeu_si128((__m128i*)bestIndex, best);
+        _mm_storeu_si128((__m128i*)bestError, bestDist);
+        for (int i = 0; i < 4; i++)
+        {
+            packed |= (UInt32)bestIndex[i] << ((g * 4 + i) * 2);
+            error  += bestError[i];
+        }
+    }
+    *indices = packed;
+    return error;
+}
+
+// Per-channel minimum and maximum of the 16 pixels.
+static void GetBlockBounds(const UByte* block, UByte* minColor, UByte* maxColor)
+{
+    __m128i p0 = _mm_loadu_si128((const __m128i*)(block));
+    __m128i p1 = _mm_loadu_si128((const __m128i*)(block + 16));
+    __m128i p2 = _mm_loadu_si128((const __m128i*)(block + 32));
+    __m128i p3 = _mm_loadu_si128((const __m128i*)(block + 48));
+    __m128i mn = _mm_min_epu8(_mm_min_epu8(p0, p1), _mm_min_epu8(p2, p3));
+    __m128i mx = _mm_max_epu8(_mm_max_epu8(p0, p1), _mm_max_epu8(p2, p3));
+    mn = _mm_min_epu8(mn, _mm_shuffle_epi32(mn, _MM_SHUFFLE(1, 0, 3, 2)));
+    mx = _mm_max_epu8(mx, _mm_shuffle_epi32(mx, _MM_SHUFFLE(1, 0, 3, 2)));
+    mn = _mm_min_epu8(mn, _mm_shuffle_epi32(mn, _MM_SHUFFLE(2, 3, 0, 1)));
+    mx = _mm_max_epu8(mx, _mm_shuffle_epi32(mx, _MM_SHUFFLE(2, 3, 0, 1)));
+    UInt32 mnPacked = (UInt32)_mm_cvtsi128_si32(mn);
+    UInt32 mxPacked = (UInt32)_mm_cvtsi128_si32(mx);
+    memcpy(minColor, &mnPacked, 4);
+    memcpy(maxColor, &mxPacked, 4);
+}
+
+#else
+
+static int FindColorIndices(const UByte* block, const UByte palette[4][4], UInt32* indices)
+{
+    UInt32 packed = 0;
+    int    error  = 0;
+    for (int i = 0; i < 16; i++)
+    {
+        const UByte* p = block + i * 4;
+        int best = 0, bestDist = 0x7FFFFFFF;
+        for (int k = 0; k < 4; k++)
+        {
+            int dr = p[0] - palette[k][0], dg = p[1] - palette[k][1], db = p[2] - palette[k][2];
+            int dist = dr * dr + dg * dg + db * db;
+            if (dist < bestDist)
+            {
+                bestDist = dist;
+                best     = k;
+            }
+        }
+        packed |= (UInt32)best << (i * 2);
+        error  += bestDist;
+    }
+    *indices = packed;
+    return error;
+}
+
+static void GetBlockBounds(const UByte* block, UByte* minColor, UByte* maxColor)
+{
+    for (int c = 0; c < 4; c++)
+    {
+        minColor[c] = maxColor[c] = block[c];
+    }
+    for (int i = 1; i < 16; i++)
+    {
+        for (int c = 0; c < 4; c++)
+        {
+            minColor[c] = Alg::Min(minColor[c], block[i * 4 + c]);
+            maxColor[c] = Alg::Max(maxColor[c], block[i * 4 + c]);
+        }
+    }
+}
+
+#endif
+
+// *** Color block encoding
+
+// Quantizes the endpoints and picks indices. Color0 > Color1 selects the 4-color
+// mode in BC1.
+static ColorBlock EncodeColorEndpoints(const UByte* block, const int* c0, const int* c1)
+{
+    ColorBlock result;
+    result.Color0 = PackColor565(c0[0], c0[1], c0[2]);
+    result.Color1 = PackColor565(c1[0], c1[1], c1[2]);
+    if (result.Color0 < result.Color1)
+    {
+        Alg::Swap(result.Color0, result.Color1);
+    }
+
+    // A solid block has four identical palette entries, so every pixel gets index 0.
+    UByte palette[4][4];
+    GetColorPalette(result.Color0, result.Color1, palette);
+    result.Error = FindColorIndices(block, palette, &result.Indices);
+    return result;
+}
+
+// Least-squares endpoints for fixed indices; returns false if the indices don't
+// determine two endpoints (all pixels use the same weight).
+static bool FitColorEndpoints(const UByte* block, UInt32 indices, int* c0, int* c1)
+{
+    static const float weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+
+    float aa = 0, bb = 0, ab = 0;
+    float ax[3] = { 0, 0, 0 }, bx[3] = { 0, 0, 0 };
+    for (int i = 0; i < 16; i++)
+    {
+        float a = weights[(indices >> (i * 2)) & 3];
+        float b = 1.0f - a;
+        aa += a * a;
+        bb += b * b;
+        ab += a * b;
+        for (int c = 0; c < 3; c++)
+        {
+            ax[c] += a * block[i * 4 + c];
+            bx[c] += b * block[i * 4 + c];
+        }
+    }
+
+    float det = aa * bb - ab * ab;
+    if (fabsf(det) < 1e-6f)
+    {
+        return false;
+    }
+    for (int c = 0; c < 3; c++)
+    {
+        c0[c] = Alg::Max(0, Alg::Min(255, (int)((ax[c] * bb - bx[c] * ab) / det + 0.5f)));
+        c1[c] = Alg::Max(0, Alg::Min(255, (int)((bx[c] * aa - ax[c] * ab) / det + 0.5f)));
+    }
+    return true;
+}
+
+// Endpoints from the bounding box, using the diagonal that follows the sign of the
+// red/green and blue/green covariance, inset by 1/16 of the range.
+static void GetBoundingBoxEndpoints(const UByte* block, int* c0, int* c1)
+{
+    UByte mn[4], mx[4];
+    GetBlockBounds(block, mn, mx);
+
+    int center[3], covRG = 0, covBG = 0;
+    for (int c = 0; c < 3; c++)
+    {
+        center[c] = (mn[c] + mx[c] + 1) >> 1;
+    }
+    for (int i = 0; i < 16; i++)
+    {
+        int dg = block[i * 4 + 1] - center[1];
+        covRG += (block[i * 4 + 0] - center[0]) * dg;
+        covBG += (block[i * 4 + 2] - center[2]) * dg;
+    }
+
+    for (int c = 0; c < 3; c++)
+    {
+        c0[c] = mx[c];
+        c1[c] = mn[c];
+    }
+    if (covRG < 0)
+    {
+        Alg::Swap(c0[0], c1[0]);
+    }
+    if (covBG < 0)
+    {
+        Alg::Swap(c0[2], c1[2]);
+    }
+    for (int c = 0; c < 3; c++)
+    {
+        int inset = (c0[c] - c1[c]) / 16;
+        c0[c] -= inset;
+        c1[c] += inset;
+    }
+}
+
+// Endpoints at the extreme pixels along the principal axis of the block's colors,
+// found by power iteration on the covariance matrix.
+static void GetPrincipalAxisEndpoints(const UByte* block, int* c0, int* c1)
+{
+    float mean[3] = { 0, 0, 0 };
+    for (int i = 0; i < 16; i++)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            mean[c] += block[i * 4 + c];
+        }
+    }
+    for (int c = 0; c < 3; c++)
+    {
+        mean[c] *= 1.0f / 16.0f;
+    }
+
+    float cov[6] = { 0, 0, 0, 0, 0, 0 }; // rr, rg, rb, gg, gb, bb
+    for (int i = 0; i < 16; i++)
+    {
+        float r = block[i * 4 + 0] - mean[0];
+        float g = block[i * 4 + 1] - mean[1];
+        float b = block[i * 4 + 2] - mean[2];
+        cov[0] += r * r;  cov[1] += r * g;  cov[2] += r * b;
+        cov[3] += g * g;  cov[4] += g * b;  cov[5] += b * b;
+    }
+
+    float axis[3] = { 1.0f, 1.0f, 1.0f };
+    for (int iteration = 0; iteration < 8; iteration++)
+    {
+        float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+        float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+        float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+        float m = Alg::Max(fabsf(x), Alg::Max(fabsf(y), fabsf(z)));
+        if (m < 1e-6f)
+        {
+            break;
+        }
+        axis[0] = x / m;
+        axis[1] = y / m;
+        axis[2] = z / m;
+    }
+
+    int   minIndex = 0, maxIndex = 0;
+    float minDot = 1e30f, maxDot = -1e30f;
+    for (int i = 0; i < 16; i++)
+    {
+        float dot = block[i * 4 + 0] * axis[0] + block[i * 4 + 1] * axis[1] + block[i * 4 + 2] * axis[2];
+        if (dot < minDot)
+        {
+            minDot   = dot;
+            minIndex = i;
+        }
+        if (dot > maxDot)
+        {
+            maxDot   = dot;
+            maxIndex = i;
+        }
+    }
+    for (int c = 0; c < 3; c++)
+    {
+        c0[c] = block[maxIndex * 4 + c];
+        c1[c] = block[minIndex * 4 + c];
+    }
+}
+
+// Encodes with the given endpoints, then refits them to the chosen indices up to
+// refinements times, stopping when the error no longer improves.
+static ColorBlock EncodeRefinedColorBlock(const UByte* block, int* c0, int* c1, int refinements)
+{
+    ColorBlock best = EncodeColorEndpoints(block, c0, c1);
+    for (int i = 0; i < refinements && best.Error > 0 && best.Color0 != best.Color1; i++)
+    {
+        if (!FitColorEndpoints(block, best.Indices, c0, c1))
+        {
+            break;
+        }
+        ColorBlock refined = EncodeColorEndpoints(block, c0, c1);
+        if (refined.Error >= best.Error)
+        {
+            break;
+        }
+        best = refined;
+    }
+    return best;
+}
+
+static void EncodeColorBlock(const UByte* block, TextureCompression quality, UByte* dest)
+{
+    const int refinements = (quality == TextureCompress_High) ? 4 : 1;
+
+    int c0[3], c1[3];
+    GetBoundingBoxEndpoints(block, c0, c1);
+    ColorBlock best = EncodeRefinedColorBlock(block, c0, c1, refinements);
+
+    // The principal axis does better on blocks whose colors don't follow a diagonal
+    // of the bounding box; keep whichever result is closer.
+    if (quality != TextureCompress_Fast && best.Error > 0)
+    {
+        GetPrincipalAxisEndpoints(block, c0, c1);
+        ColorBlock candidate = EncodeRefinedColorBlock(block, c0, c1, refinements);
+        if (candidate.Error < best.Error)
+        {
+            best = candidate;
+        }
+    }
+
+    dest[0] = (UByte)(best.Color0 & 0xFF);
+    dest[1] = (UByte)(best.Color0 >> 8);
+    dest[2] = (UByte)(best.Color1 & 0xFF);
+    dest[3] = (UByte)(best.Color1 >> 8);
+    dest[4] = (UByte)(best.Indices);
+    dest[5] = (UByte)(best.Indices >> 8);
+    dest[6] = (UByte)(best.Indices >> 16);
+    dest[7] = (UByte)(best.Indices >> 24);
+}
+
+// *** Alpha block encoding
+
+static void GetAlphaPalette(int a0, int a1, int* palette)
+{
+    palette[0] = a0;
+    palette[1] = a1;
+    if (a0 > a1)
+    {
+        for (int i = 1; i < 7; i++)
+            palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+    }
+    else
+    {
+        for (int i = 1; i < 5; i++)
+            palette[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+}
+
+// Uses the 8-alpha mode between the block's alpha range; a constant block
+// gets a0 == a1 and all indices 0.
+static void EncodeAlphaBlock(const UByte* block, UByte* dest)
+{
+    int a0 = block[3], a1 = block[3];
+    for (int i = 1; i < 16; i++)
+    {
+        a0 = Alg::Max(a0, (int)block[i * 4 + 3]);
+        a1 = Alg::Min(a1, (int)block[i * 4 + 3]);
+    }
+
+    int palette[8];
+    GetAlphaPalette(a0, a1, palette);
+
+    UInt64 indices = 0;
+    if (a0 != a1)
+    {
+        for (int i = 0; i < 16; i++)
+        {
+            int alpha = block[i * 4 + 3];
+            int best = 0, bestDist = 256;
+            for (int k = 0; k < 8; k++)
+            {
+                int dist = abs(alpha - palette[k]);
+                if (dist < bestDist)
+                {
+                    bestDist = dist;
+                    best     = k;
+                }
+            }
+            indices |= (UInt64)best << (i * 3);
+        }
+    }
+
+    dest[0] = (UByte)a0;
+    dest[1] = (UByte)a1;
+    for (int i = 0; i < 6; i++)
+    {
+        dest[2 + i] = (UByte)(indices >> (i * 8));
+    }
+}
+
+// *** Decoding
+
+static void DecodeColorBlock(const UByte* src, bool allowThreeColor, UByte* block)
+{
+    UInt16 color0 = (UInt16)(src[0] | (src[1] << 8));
+    UInt16 color1 = (UInt16)(src[2] | (src[3] << 8));
+    UInt32 indices = src[4] | (src[5] << 8) | (src[6] << 16) | ((UInt32)src[7] << 24);
+
+    UByte palette[4][4];
+    GetColorPalette(color0, color1, palette);
+    palette[0][3] = palette[1][3] = palette[2][3] = palette[3][3] = 255;
+    if (allowThreeColor && color0 <= color1)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            palette[2][c] = (UByte)((palette[0][c] + palette[1][c]) / 2);
+            palette[3][c] = 0;
+        }
+        palette[3][3] = 0;
+    }
+
+    for (int i = 0; i < 16; i++)
+    {
+        memcpy(block + i * 4, palette[(indices >> (i * 2)) & 3], 4);
+    }
+}
+
+static void DecodeAlphaBlock(const UByte* src, UByte* block)
+{
+    int palette[8];
+    GetAlphaPalette(src[0], src[1], palette);
+
+    UInt64 indices = 0;
+    for (int i = 0; i < 6; i++)
+    {
+        indices |= (UInt64)src[2 + i] << (i * 8);
+    }
+    for (int i = 0; i < 16; i++)
+    {
+        block[i * 4 + 3] = (UByte)palette[(indices >> (i * 3)) & 7];
+    }
+}
+
+// *** Image level loops
+
+static void LoadBlock(const UByte* rgba, int w, int h, int bx, int by, UByte* block)
+{
+    for (int y = 0; y < 4; y++)
+    {
+        int sy = Alg::Min(by * 4 + y, h - 1);
+        const UByte* row = rgba + (UPInt)sy * w * 4;
+        if (bx * 4 + 4 <= w)
+        {
+            memcpy(block + y * 16, row + bx * 16, 16);
+        }
+        else
+        {
+            for (int x = 0; x < 4; x++)
+            {
+                memcpy(block + y * 16 + x * 4, row + Alg::Min(bx * 4 + x, w - 1) * 4, 4);
+            }
+        }
+    }
+}
+
+static int GetBlockSize(int format)
+{
+    return (format == Texture_DXT1) ? 8 : 16;
+}
+
+static void CompressBlockRows(const UByte* rgba, int w, int h, UByte* dest, int format,
+                              TextureCompression quality, int rowBegin, int rowEnd)
+{
+    const int blocksWide = (w + 3) / 4;
+    const int blockSize  = GetBlockSize(format);
+
+    UByte block[64];
+    for (int by = rowBegin; by < rowEnd; by++)
+    {
+        UByte* pdest = dest + (UPInt)by * blocksWide * blockSize;
+        for (int bx = 0; bx < blocksWide; bx++, pdest += blockSize)
+        {
+            LoadBlock(rgba, w, h, bx, by, block);
+            if (format == Texture_DXT5)
+            {
+                EncodeAlphaBlock(block, pdest);
+                EncodeColorBlock(block, quality, pdest + 8);
+            }
+            else
+            {
+                EncodeColorBlock(block, quality, pdest);
+            }
+        }
+    }
+}
+
+// Rows of blocks per WorkerPool job.
+enum { CompressBandRows = 8 };
+
+struct CompressJob
+{
+    const UByte*       pSrc;
+    UByte*             pDest;
+    int                Width, Height;
+    int                Format;
+    TextureCompression Quality;
+
+    static void CompressBand(void* context, UPInt band)
+    {
+        const CompressJob* job = (const CompressJob*)context;
+        int rowBegin = (int)band * CompressBandRows;
+        int rowEnd   = Alg::Min(rowBegin + (int)CompressBandRows, (job->Height + 3) / 4);
+        CompressBlockRows(job->pSrc, job->Width, job->Height, job->pDest, job->Format, job->Quality,
+                          rowBegin, rowEnd);
+    }
+};
+
+// *** Public interface
+
+int ChooseBlockFormat(const UByte* rgba, int w, int h)
+{
+    UPInt count = (UPInt)w * h;
+    for (UPInt i = 0; i < count; i++)
+    {
+        if (rgba[i * 4 + 3] != 255)
+            return Texture_DXT5;
+    }
+    return Texture_DXT1;
+}
+
+void CompressRgbaBlocks(const UByte* rgba, int w, int h, UByte* dest, int format,
+                        TextureCompression quality, WorkerPool* pWorkers)
+{
+    OVR_ASSERT(format == Texture_DXT1 || format == Texture_DXT5);
+
+    int blockRows = (h + 3) / 4;
+    if (pWorkers && pWorkers->GetThreadCount() > 1 && blockRows > CompressBandRows)
+    {
+        CompressJob job = { rgba, dest, w, h, format, quality };
+        pWorkers->ParallelFor((blockRows + CompressBandRows - 1) / CompressBandRows,
+                              CompressJob::CompressBand, &job);
+    }
+    else
+    {
+        CompressBlockRows(rgba, w, h, dest, format, quality, 0, blockRows);
+    }
+}
+
+void DecompressBlocks(const UByte* src, int w, int h, int format, UByte* rgba)
+{
+    const int blocksWide = (w + 3) / 4;
+    const int blockSize  = GetBlockSize(format);
+
+    UByte block[64];
+    for (int by = 0; by < (h + 3) / 4; by++)
+    {
+        for (int bx = 0; bx < blocksWide; bx++, src += blockSize)
+        {
+            if (format == Texture_DXT5)
+            {
+                DecodeColorBlock(src + 8, false, block);
+                DecodeAlphaBlock(src, block);
+            }
+            else
+            {
+                DecodeColorBlock(src, true, block);
+            }
+
+            for (int y = 0; y < 4 && by * 4 + y < h; y++)
+            {
+                int width = Alg::Min(4, w - bx * 4);
+                memcpy(rgba + ((UPInt)(by * 4 + y) * w + bx * 4) * 4, block + y * 16, width * 4);
+            }
+        }
+    }
+}
+
+bool TextureData::Compress(TextureCompression quality, WorkerPool* pWorkers)
+{
+    // Block compressed textures must be a whole number of blocks at the top level.
+    if (quality == TextureCompress_None || Format != Texture_RGBA || !pData ||
+        (Width & 3) || (Height & 3))
+    {
+        return false;
+    }
+
+    int   format = ChooseBlockFormat(pData, Width, Height);
+    UPInt size   = 0;
+    int   w = Width, h = Height;
+    for (int i = 0; i < MipCount; i++)
+    {
+        size += GetTextureSize(format, w, h);
+        w = Alg::Max(w >> 1, 1);
+        h = Alg::Max(h >> 1, 1);
+    }
+
+    UByte*       blocks = (UByte*)OVR_ALLOC(size);
+    UByte*       dest   = blocks;
+    const UByte* src    = pData;
+    w = Width;
+    h = Height;
+    for (int i = 0; i < MipCount; i++)
+    {
+        CompressRgbaBlocks(src, w, h, dest, format, quality, pWorkers);
+        src  += (UPInt)w * h * 4;
+        dest += GetTextureSize(format, w, h);
+        w = Alg::Max(w >> 1, 1);
+        h = Alg::Max(h >> 1, 1);
+    }
+
+    SetData(blocks);
+    Format = format;
+    return true;
+}
+
+}} // OVR::Render
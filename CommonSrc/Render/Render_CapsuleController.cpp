@@ -0,0 +1,285 @@
+/************************************************************************************
+
+Filename    :   Render_CapsuleController.cpp
+Content     :   Swept capsule movement with sliding against collision models
+Created     :   October 17, 2026
+Authors     :
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************************/
+
+#include "Render_CapsuleController.h"
+
+#include <math.h>
+#include <float.h>
+
+namespace OVR { namespace Render {
+
+const float CapsuleController::SkinWidth = 0.001f;
+
+// The pushed out planes of a model meet past its corners, Radius / sin(a / 2) out
+// for a corner of angle a. Models are gathered this many radii around the capsule
+// so that corners down to 60 degrees are swept before the capsule reaches them.
+static const float CornerReach = 2.0f;
+
+// How far the capsule reaches past its base along -N, in units of the plane's
+// distances: Radius all around, plus the segment for planes facing down.
+static inline float GetCapsuleOffset(const Planef& plane, float normalLength, float radius, float height)
+{
+    return radius * normalLength + height * Alg::Max(0.0f, -plane.N.y);
+}
+
+// Distance between two boxes, 0 if they overlap.
+static float GetBoxGap(const Vector3f& aMin, const Vector3f& aMax, const Vector3f& bMin, const Vector3f& bMax)
+{
+    Vector3f gap(Alg::Max(0.0f, Alg::Max(bMin.x - aMax.x, aMin.x - bMax.x)),
+                 Alg::Max(0.0f, Alg::Max(bMin.y - aMax.y, aMin.y - bMax.y)),
+                 Alg::Max(0.0f, Alg::Max(bMin.z - aMax.z, aMin.z - bMax.z)));
+    return gap.Length();
+}
+
+static inline Planef GetUnitPlane(const Planef& plane)
+{
+    float length = plane.N.Length();
+    return Planef(plane.N / length, plane.D / length);
+}
+
+// Clips the move against each plane pushed out by the capsule, the way a point
+// is traced through a convex brush: the move enters the model at the latest
+// entering plane, unless it has already left through an earlier leaving one.
+bool CapsuleController::Sweep(const CollisionModel* model, const Vector3f& base, const Vector3f& move,
+                              CapsuleSweep* result) const
+{
+    const Array<Planef>& planes = model->Planes;
+    Vector3f end = base + move;
+
+    float enter = -1.0f, leave = 1.0f;
+    int   enterPlane = -1;
+    bool  startOutside = false;
+    int   shallowPlane = -1;
+    float shallowStart = -FLT_MAX, shallowEnd = 0;
+
+    for (UPInt i = 0; i < planes.GetSize(); i++)
+    {
+        const Planef& plane = planes[i];
+        float normalLength = plane.N.Length();
+        if (normalLength <= 0)
+            continue;
+
+        float offset = GetCapsuleOffset(plane, normalLength, Radius, Height);
+        float d1     = plane.TestSide(base) - offset;
+        float d2     = plane.TestSide(end) - offset;
+        float skin   = SkinWidth * normalLength;
+
+        if (d1 > 0)
+            startOutside = true;
+        if (d1 > shallowStart)
+        {
+            shallowPlane = (int)i;
+            shallowStart = d1;
+            shallowEnd   = d2;
+        }
+
+        // Entirely in front of this plane, so the move can't touch the model.
+        if (d1 > 0 && (d2 >= skin || d2 >= d1))
+        {
+            return false;
+        }
+        if (d1 <= 0 && d2 <= 0)
+            continue;
+
+        if (d1 > d2)
+        {
+            float f = Alg::Max(0.0f, (d1 - skin) / (d1 - d2));
+            if (f > enter)
+            {
+                enter      = f;
+                enterPlane = (int)i;
+            }
+        }
+        else
+        {
+            float f = Alg::Min(1.0f, (d1 + skin) / (d1 - d2));
+            leave = Alg::Min(leave, f);
+        }
+    }
+
+    result->StartSolid = !startOutside;
+    if (!startOutside)
+    {
+        // Already overlapping, e.g. after a teleport: moves that leave through the
+        // nearest plane are let through so the capsule can get free.
+        if (shallowPlane < 0 || shallowEnd >= shallowStart)
+        {
+            return false;
+        }
+        result->Fraction = 0;
+        result->Plane    = GetUnitPlane(planes[shallowPlane]);
+        return true;
+    }
+
+    if (enterPlane >= 0 && enter < leave)
+    {
+        result->Fraction = enter;
+        result->Plane    = GetUnitPlane(planes[enterPlane]);
+        return true;
+    }
+    return false;
+}
+
+Vector3f CapsuleController::Move(const CollisionTree& models, const Vector3f& base, const Vector3f& move,
+                                 int planeBudget)
+{
+    LastStats = MoveStats();
+
+    float travel = move.Length();
+    if (travel <= 0)
+    {
+        return base;
+    }
+
+    // Sliding never lengthens the move, so everything it can touch is within
+    // travel of the start.
+    float    reach = travel + Radius * CornerReach + SkinWidth;
+    Vector3f boxMin = base - Vector3f(reach, reach, reach);
+    Vector3f boxMax = base + Vector3f(reach, reach + Height, reach);
+    CandidateModels.Clear();
+    models.GetModelsInBox(boxMin, boxMax, &CandidateModels);
+
+    // Nearest first, so that the models a short budget leaves untested are the
+    // farthest ones. Gaps are measured to the capsule's box grown to CornerReach,
+    // so that they hold for the models' planes as well.
+    float    corner     = Radius * CornerReach;
+    Vector3f capsuleMin = base - Vector3f(corner, corner, corner);
+    Vector3f capsuleMax = base + Vector3f(corner, corner + Height, corner);
+    Candidates.Resize(CandidateModels.GetSize());
+    for (UPInt i = 0; i < Candidates.GetSize(); i++)
+    {
+        Candidate& c = Candidates[i];
+        Vector3f   modelMin, modelMax;
+        c.Model  = CandidateModels[i];
+        c.Planes = (int)models.GetModel(c.Model)->Planes.GetSize();
+        c.Gap    = models.GetModelBounds(c.Model, &modelMin, &modelMax) ?
+                   GetBoxGap(capsuleMin, capsuleMax, modelMin, modelMax) : 0;
+    }
+    Alg::QuickSort(Candidates);
+
+    Vector3f pos       = base;
+    Vector3f remaining = move;
+    Vector3f hitNormals[MaxSlideIterations];
+    int      hitCount = 0;
+
+    for (int iteration = 0; iteration < MaxSlideIterations; iteration++)
+    {
+        if (remaining.LengthSq() <= 1e-12f)
+            break;
+
+        bool         hit = false;
+        CapsuleSweep nearest;
+        nearest.Fraction = 1.0f;
+        UPInt tested = 0;
+        for (; tested < Candidates.GetSize(); tested++)
+        {
+            const Candidate& c = Candidates[tested];
+            if (LastStats.PlaneTests + c.Planes > planeBudget)
+                break;
+
+            CapsuleSweep sweep;
+            if (Sweep(models.GetModel(c.Model), pos, remaining, &sweep) && sweep.Fraction < nearest.Fraction)
+            {
+                nearest = sweep;
+                hit     = true;
+            }
+            LastStats.PlaneTests += c.Planes;
+        }
+        LastStats.Sweeps++;
+        LastStats.ModelTests += (int)tested;
+
+        // Out of budget: every untested model is at least its Gap from the capsule
+        // at base, so the move may go that far, less how far it has already come.
+        if (tested < Candidates.GetSize())
+        {
+            LastStats.OutOfBudget = true;
+            float safe = Candidates[tested].Gap - SkinWidth - (pos - base).Length();
+            float limit = Alg::Max(0.0f, safe) / remaining.Length();
+            if (limit < nearest.Fraction)
+            {
+                pos += remaining * limit;
+                break;
+            }
+        }
+
+        pos += remaining * nearest.Fraction;
+        if (!hit)
+            break;
+
+        // Slide along the plane with what is left of the move.
+        Vector3f n = nearest.Plane.N;
+        remaining  = remaining * (1.0f - nearest.Fraction);
+        remaining  = remaining - n * remaining.Dot(n);
+        hitNormals[hitCount++] = n;
+
+        // If that pushes into an earlier plane, follow the crease between the two,
+        // and stop if even that is blocked.
+        for (int j = 0; j < hitCount - 1; j++)
+        {
+            if (remaining.Dot(hitNormals[j]) >= 0)
+                continue;
+
+            Vector3f crease = hitNormals[j].Cross(n);
+            float    length = crease.Length();
+            remaining = (length > 1e-6f) ? crease * (crease.Dot(remaining) / (length * length)) : Vector3f(0, 0, 0);
+            for (int k = 0; k < hitCount; k++)
+            {
+                if (remaining.Dot(hitNormals[k]) < -1e-5f)
+                    remaining = Vector3f(0, 0, 0);
+            }
+            break;
+        }
+
+        // Never slide back against the way the player is moving.
+        if (remaining.Dot(move) <= 0)
+            break;
+    }
+
+    CollisionModel::AddSweepStats(LastStats.ModelTests, LastStats.PlaneTests);
+    return pos;
+}
+
+bool CapsuleController::Overlaps(const CollisionTree& models, const Vector3f& base, float tolerance) const
+{
+    Array<UInt32> candidates;
+    float         corner = Radius * CornerReach;
+    models.GetModelsInBox(base - Vector3f(corner, corner, corner),
+                          base + Vector3f(corner, corner + Height, corner), &candidates);
+
+    for (UPInt c = 0; c < candidates.GetSize(); c++)
+    {
+        const Array<Planef>& planes = models.GetModel(candidates[c])->Planes;
+        bool separated = false;
+        for (UPInt i = 0; i < planes.GetSize() && !separated; i++)
+        {
+            float normalLength = planes[i].N.Length();
+            float d = planes[i].TestSide(base) - GetCapsuleOffset(planes[i], normalLength, Radius, Height);
+            separated = d > -tolerance * normalLength;
+        }
+        if (!separated && planes.GetSize() > 0)
+            return true;
+    }
+    return false;
+}
+
+}} // OVR::Render
@@ -0,0 +1,105 @@
+/************************************************************************************
+
+Filename    :   Render_CapsuleController.h
+Content     :   Swept capsule movement with sliding against collision models
+Created     :   October 17, 2026
+Authors     :
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************************/
+
+#ifndef INC_Render_CapsuleController_h
+#define INC_Render_CapsuleController_h
+
+#include "Render_CollisionTree.h"
+
+namespace OVR { namespace Render {
+
+// Result of sweeping a capsule through one model.
+struct CapsuleSweep
+{
+    float  Fraction;    // Part of the move that can be made, 1 if nothing was hit.
+    Planef Plane;       // Plane that was hit, with a unit normal.
+    bool   StartSolid;  // The capsule already overlapped the model.
+};
+
+// Upright capsule: a sphere of Radius swept from Base up to Base + (0, Height, 0).
+// Models are only known by their planes, so each plane is pushed out by the
+// capsule's extent along its normal. That is exact against faces and slightly
+// larger than the true shape around edges and corners, which keeps the capsule
+// clear of every model it is tested against.
+class CapsuleController
+{
+public:
+    // Moves run through at most MaxSlideIterations sweeps and a budget of plane
+    // tests, MaxPlaneTestsPerMove by default, which bounds the cost of a move
+    // however dense the models are. Models are swept nearest first; once the
+    // budget runs out the move only goes as far as the nearest untested model.
+    enum
+    {
+        MaxSlideIterations   = 4,
+        MaxPlaneTestsPerMove = 4096
+    };
+
+    struct MoveStats
+    {
+        int  Sweeps;
+        int  ModelTests;
+        int  PlaneTests;
+        bool OutOfBudget;
+
+        MoveStats() : Sweeps(0), ModelTests(0), PlaneTests(0), OutOfBudget(false) { }
+    };
+
+    float Radius;
+    float Height;
+
+    CapsuleController(float radius = 0.2f, float height = 0.6f) : Radius(radius), Height(height) { }
+
+    // Moves a capsule at base by move, sliding along whatever it hits, and returns
+    // the new base. The capsule stops SkinWidth short of every plane.
+    Vector3f Move(const CollisionTree& models, const Vector3f& base, const Vector3f& move,
+                  int planeBudget = MaxPlaneTestsPerMove);
+
+    const MoveStats& GetLastStats() const { return LastStats; }
+
+    // Whether the capsule at base overlaps any model, by more than tolerance.
+    bool     Overlaps(const CollisionTree& models, const Vector3f& base, float tolerance = 0) const;
+
+    // Sweeps the capsule from base by move through one model.
+    bool     Sweep(const CollisionModel* model, const Vector3f& base, const Vector3f& move,
+                   CapsuleSweep* result) const;
+
+    static const float SkinWidth;
+
+private:
+    struct Candidate
+    {
+        float  Gap;     // Distance between the bounds of the capsule at base and the model.
+        UInt32 Model;
+        int    Planes;
+
+        bool operator<(const Candidate& b) const { return Gap < b.Gap || (Gap == b.Gap && Model < b.Model); }
+    };
+
+    MoveStats        LastStats;
+    Array<UInt32>    CandidateModels;
+    Array<Candidate> Candidates;
+};
+
+}} // OVR::Render
+
+#endif // INC_Render_CapsuleController_h
@@ -0,0 +1,653 @@
+/************************************************************************************
+
+Filename    :   Render_CollisionModel.cpp
+Content     :   Ray and point tests against convex collision models
+Created     :   October 17, 2026
+Authors     :
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************************/
+
+#include "Render_Device.h"
+#include "Render_Simd.h"
+
+#include <math.h>
+#include <float.h>
+#include <assert.h>
+
+namespace OVR { namespace Render {
+
+// The SIMD kernels evaluate Planef::TestSide as ((N.x * p.x + N.y * p.y) + N.z * p.z) + D,
+// in the same order as the scalar code, so every side test and the plane that
+// TestRay picks are bit for bit the same.
+
+static const int PlaneBlockFloats = CollisionModel::PlaneBlockSize * 4;
+
+void CollisionModel::Add(const Planef& p)
+{
+    UPInt index = Planes.GetSize();
+    Planes.PushBack(p);
+    HasBounds = false;
+
+    UPInt lane = index % PlaneBlockSize;
+    if (lane == 0)
+    {
+        // Padding planes have a zero normal and negative D.
+        UPInt start = PlaneBlocks.GetSize();
+        PlaneBlocks.Resize(start + PlaneBlockFloats);
+        for (int i = 0; i < PlaneBlockFloats; i++)
+        {
+            PlaneBlocks[start + i] = (i < PlaneBlockSize * 3) ? 0.0f : -1.0f;
+        }
+    }
+
+    float* block = &PlaneBlocks[(index / PlaneBlockSize) * PlaneBlockFloats];
+    block[lane]                      = p.N.x;
+    block[lane + PlaneBlockSize]     = p.N.y;
+    block[lane + PlaneBlockSize * 2] = p.N.z;
+    block[lane + PlaneBlockSize * 3] = p.D;
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** Scalar reference
+
+static bool TestPointScalar(const Array<Planef>& planes, const Vector3f& p)
+{
+    for(unsigned i = 0; i < planes.GetSize(); i++)
+        if(planes[i].TestSide(p) > 0)
+        {
+            return 0;
+        }
+
+    return 1;
+}
+
+static bool TestRayScalar(const Array<Planef>& planes, const Vector3f& origin, const Vector3f& norm,
+                          float& len, Planef* ph)
+{
+    if(TestPointScalar(planes, origin))
+    {
+        len = 0;
+        *ph = planes[0];
+        return true;
+    }
+    Vector3f fullMove = origin + norm * len;
+
+    int crossing = -1;
+    float cdot1 = 0, cdot2 = 0;
+
+    for(unsigned i = 0; i < planes.GetSize(); ++i)
+    {
+        float dot2 = planes[i].TestSide(fullMove);
+        if(dot2 > 0)
+        {
+            return false;
+        }
+        float dot1 = planes[i].TestSide(origin);
+        if(dot1 > 0)
+        {
+            if(dot2 <= 0)
+            {
+                //assert(crossing==-1);
+				if(crossing == -1)
+				{
+					crossing = i;
+					cdot2 = dot2;
+					cdot1 = dot1;
+				}
+				else
+				{
+					if(dot2 > cdot2)
+					{
+						crossing = i;
+						cdot2 = dot2;
+						cdot1 = dot1;
+					}
+				}
+            }
+        }
+    }
+
+    if(crossing < 0)
+    {
+        return false;
+    }
+
+    assert(TestPointScalar(planes, origin + norm * len));
+
+    len = len * cdot1 / (cdot1 - cdot2) - 0.05f;
+    if(len < 0)
+    {
+        len = 0;
+    }
+    float tp = planes[crossing].TestSide(origin + norm * len);
+    OVR_ASSERT(fabsf(tp) < 0.05f + Mathf::Tolerance);
+    OVR_UNUSED(tp);
+
+    if(ph)
+    {
+        *ph = planes[crossing];
+    }
+    return true;
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** SIMD kernels
+
+// Everything TestRay needs from one pass over the planes. Crossing is the first
+// plane with the largest end side among those the origin is outside of.
+struct RayPlaneResult
+{
+    bool  OriginOutside;
+    bool  EndOutside;
+    int   Crossing;
+    float CrossingDot1, CrossingDot2;
+};
+
+// Picks the crossing plane from per-lane results, where each lane holds the first
+// of its own largest values; across lanes the lowest plane index wins a tie.
+static void ReduceCrossing(const float* dot1, const float* dot2, const float* index, int lanes,
+                           RayPlaneResult* result)
+{
+    result->Crossing = -1;
+    for (int i = 0; i < lanes; i++)
+    {
+        if (index[i] < 0)
+            continue;
+        if (result->Crossing < 0 || dot2[i] > result->CrossingDot2 ||
+            (dot2[i] == result->CrossingDot2 && (int)index[i] < result->Crossing))
+        {
+            result->Crossing     = (int)index[i];
+            result->CrossingDot1 = dot1[i];
+            result->CrossingDot2 = dot2[i];
+        }
+    }
+}
+
+#if defined(OVR_RENDER_SSE2)
+
+static inline __m128 SelectSse2(__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static void TestRayPlanesSse2(const float* blocks, UPInt blockCount,
+                              const Vector3f& origin, const Vector3f& end, RayPlaneResult* result)
+{
+    const __m128 ox = _mm_set1_ps(origin.x), oy = _mm_set1_ps(origin.y), oz = _mm_set1_ps(origin.z);
+    const __m128 ex = _mm_set1_ps(end.x),    ey = _mm_set1_ps(end.y),    ez = _mm_set1_ps(end.z);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 four = _mm_set1_ps(4.0f);
+
+    __m128 originOutside = zero, endOutside = zero;
+    __m128 bestDot1  = zero;
+    __m128 bestDot2  = _mm_set1_ps(-FLT_MAX);
+    __m128 bestIndex = _mm_set1_ps(-1.0f);
+    __m128 index     = _mm_setr_ps(0, 1, 2, 3);
+
+    for (UPInt b = 0; b < blockCount; b++)
+    {
+        for (int half = 0; half < CollisionModel::PlaneBlockSize; half += 4)
+        {
+            const float* p = blocks + b * PlaneBlockFloats + half;
+            __m128 nx = _mm_loadu_ps(p);
+            __m128 ny = _mm_loadu_ps(p + CollisionModel::PlaneBlockSize);
+            __m128 nz = _mm_loadu_ps(p + CollisionModel::PlaneBlockSize * 2);
+            __m128 d  = _mm_loadu_ps(p + CollisionModel::PlaneBlockSize * 3);
+
+            __m128 dot1 = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, ox), _mm_mul_ps(ny, oy)),
+                                                _mm_mul_ps(nz, oz)), d);
+            __m128 dot2 = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, ex), _mm_mul_ps(ny, ey)),
+                                                _mm_mul_ps(nz, ez)), d);
+
+            __m128 outside1 = _mm_cmpgt_ps(dot1, zero);
+            originOutside   = _mm_or_ps(originOutside, outside1);
+            endOutside      = _mm_or_ps(endOutside, _mm_cmpgt_ps(dot2, zero));
+
+            __m128 better = _mm_and_ps(outside1, _mm_cmpgt_ps(dot2, bestDot2));
+            bestDot1  = SelectSse2(better, dot1, bestDot1);
+            bestDot2  = SelectSse2(better, dot2, bestDot2);
+            bestIndex = SelectSse2(better, index, bestIndex);
+            index     = _mm_add_ps(index, four);
+        }
+
+        // Once both ends are known to be outside the ray can't hit.
+        if (_mm_movemask_ps(originOutside) && _mm_movemask_ps(endOutside))
+            break;
+    }
+
+    result->OriginOutside = _mm_movemask_ps(originOutside) != 0;
+    result->EndOutside    = _mm_movemask_ps(endOutside) != 0;
+    result->Crossing      = -1;
+    if (!result->OriginOutside || result->EndOutside)
+        return;
+
+    float dot1[4], dot2[4], indices[4];
+    _mm_storeu_ps(dot1, bestDot1);
+    _mm_storeu_ps(dot2, bestDot2);
+    _mm_storeu_ps(indices, bestIndex);
+    ReduceCrossing(dot1, dot2, indices, 4, result);
+}
+
+static bool TestPointSse2(const float* blocks, UPInt blockCount, const Vector3f& p)
+{
+    const __m128 px = _mm_set1_ps(p.x), py = _mm_set1_ps(p.y), pz = _mm_set1_ps(p.z);
+    const __m128 zero = _mm_setzero_ps();
+
+    for (UPInt b = 0; b < blockCount; b++)
+    {
+        for (int half = 0; half < CollisionModel::PlaneBlockSize; half += 4)
+        {
+            const float* plane = blocks + b * PlaneBlockFloats + half;
+            __m128 dot = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+                                    _mm_mul_ps(_mm_loadu_ps(plane), px),
+                                    _mm_mul_ps(_mm_loadu_ps(plane + CollisionModel::PlaneBlockSize), py)),
+                                    _mm_mul_ps(_mm_loadu_ps(plane + CollisionModel::PlaneBlockSize * 2), pz)),
+                                    _mm_loadu_ps(plane + CollisionModel::PlaneBlockSize * 3));
+            if (_mm_movemask_ps(_mm_cmpgt_ps(dot, zero)))
+                return false;
+        }
+    }
+    return true;
+}
+
+OVR_RENDER_TARGET_AVX2
+static void TestRayPlanesAvx2(const float* blocks, UPInt blockCount,
+                              const Vector3f& origin, const Vector3f& end, RayPlaneResult* result)
+{
+    const __m256 ox = _mm256_set1_ps(origin.x), oy = _mm256_set1_ps(origin.y), oz = _mm256_set1_ps(origin.z);
+    const __m256 ex = _mm256_set1_ps(end.x),    ey = _mm256_set1_ps(end.y),    ez = _mm256_set1_ps(end.z);
+    const __m256 zero  = _mm256_setzero_ps();
+    const __m256 eight = _mm256_set1_ps(8.0f);
+
+    __m256 originOutside = zero, endOutside = zero;
+    __m256 bestDot1  = zero;
+    __m256 bestDot2  = _mm256_set1_ps(-FLT_MAX);
+    __m256 bestIndex = _mm256_set1_ps(-1.0f);
+    __m256 index     = _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7);
+
+    for (UPInt b = 0; b < blockCount; b++)
+    {
+        const float* p = blocks + b * PlaneBlockFloats;
+        __m256 nx = _mm256_loadu_ps(p);
+        __m256 ny = _mm256_loadu_ps(p + CollisionModel::PlaneBlockSize);
+        __m256 nz = _mm256_loadu_ps(p + CollisionModel::PlaneBlockSize * 2);
+        __m256 d  = _mm256_loadu_ps(p + CollisionModel::PlaneBlockSize * 3);
+
+        __m256 dot1 = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx, ox), _mm256_mul_ps(ny, oy)),
+                                                  _mm256_mul_ps(nz, oz)), d);
+        __m256 dot2 = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx, ex), _mm256_mul_ps(ny, ey)),
+                                                  _mm256_mul_ps(nz, ez)), d);
+
+        __m256 outside1 = _mm256_cmp_ps(dot1, zero, _CMP_GT_OQ);
+        originOutside   = _mm256_or_ps(originOutside, outside1);
+        endOutside      = _mm256_or_ps(endOutside, _mm256_cmp_ps(dot2, zero, _CMP_GT_OQ));
+
+        __m256 better = _mm256_and_ps(outside1, _mm256_cmp_ps(dot2, bestDot2, _CMP_GT_OQ));
+        bestDot1  = _mm256_blendv_ps(bestDot1, dot1, better);
+        bestDot2  = _mm256_blendv_ps(bestDot2, dot2, better);
+        bestIndex = _mm256_blendv_ps(bestIndex, index, better);
+        index     = _mm256_add_ps(index, eight);
+
+        if (_mm256_movemask_ps(originOutside) && _mm256_movemask_ps(endOutside))
+            break;
+    }
+
+    result->OriginOutside = _mm256_movemask_ps(originOutside) != 0;
+    result->EndOutside    = _mm256_movemask_ps(endOutside) != 0;
+    result->Crossing      = -1;
+    if (!result->OriginOutside || result->EndOutside)
+        return;
+
+    float dot1[8], dot2[8], indices[8];
+    _mm256_storeu_ps(dot1, bestDot1);
+    _mm256_storeu_ps(dot2, bestDot2);
+    _mm256_storeu_ps(indices, bestIndex);
+    ReduceCrossing(dot1, dot2, indices, 8, result);
+}
+
+#endif // OVR_RENDER_SSE2
+
+static CollisionKernelPath ResolveCollisionKernelPath(CollisionKernelPath path)
+{
+#if defined(OVR_RENDER_SSE2)
+    if ((path == CollisionKernel_Auto || path == CollisionKernel_AVX2) && (GetCpuFeatures() & CpuFeature_AVX2))
+        return CollisionKernel_AVX2;
+    if (path != CollisionKernel_Scalar)
+        return CollisionKernel_SSE2;
+#else
+    OVR_UNUSED(path);
+#endif
+    return CollisionKernel_Scalar;
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** Bounds and load-time optimization
+
+// A model is the space behind all of its planes. Its bounds come from the corners
+// where three planes meet, clipped to a box this size so that unbounded models
+// can be detected by corners on the box.
+static const float HullBoundsLimit = 1.0e5f;
+
+// Planes within these of each other, once normalized, are the same plane.
+static const float DuplicateNormalTolerance = 1e-5f;
+static const float DuplicateDistanceTolerance = 1e-5f;
+
+// Optimize estimates how much of the bounds each plane rejects at this many
+// points per axis.
+static const int RejectionSamplesPerAxis = 4;
+
+static inline void GrowBounds(Vector3f* boundsMin, Vector3f* boundsMax, const Vector3f& p)
+{
+    boundsMin->x = Alg::Min(boundsMin->x, p.x);
+    boundsMin->y = Alg::Min(boundsMin->y, p.y);
+    boundsMin->z = Alg::Min(boundsMin->z, p.z);
+    boundsMax->x = Alg::Max(boundsMax->x, p.x);
+    boundsMax->y = Alg::Max(boundsMax->y, p.y);
+    boundsMax->z = Alg::Max(boundsMax->z, p.z);
+}
+
+static inline bool BoxContainsPoint(const Vector3f& boundsMin, const Vector3f& boundsMax, const Vector3f& p)
+{
+    return p.x >= boundsMin.x && p.x <= boundsMax.x &&
+           p.y >= boundsMin.y && p.y <= boundsMax.y &&
+           p.z >= boundsMin.z && p.z <= boundsMax.z;
+}
+
+// TestRay only hits a model if the ray starts or ends inside it.
+static inline bool RayMayHitBounds(const CollisionModel& model, const CollisionRay& ray)
+{
+    return !model.HasBounds ||
+           BoxContainsPoint(model.BoundsMin, model.BoundsMax, ray.Origin) ||
+           BoxContainsPoint(model.BoundsMin, model.BoundsMax, ray.Origin + ray.Norm * ray.Length);
+}
+
+static bool FindHullBounds(const Array<Planef>& hullPlanes, Vector3f* boundsMin, Vector3f* boundsMax)
+{
+    Array<Planef> planes(hullPlanes);
+    planes.PushBack(Planef(Vector3f( 1, 0, 0), -HullBoundsLimit));
+    planes.PushBack(Planef(Vector3f(-1, 0, 0), -HullBoundsLimit));
+    planes.PushBack(Planef(Vector3f( 0, 1, 0), -HullBoundsLimit));
+    planes.PushBack(Planef(Vector3f( 0,-1, 0), -HullBoundsLimit));
+    planes.PushBack(Planef(Vector3f( 0, 0, 1), -HullBoundsLimit));
+    planes.PushBack(Planef(Vector3f( 0, 0,-1), -HullBoundsLimit));
+
+    bool      foundCorner = false;
+    Vector3f  cornerMin, cornerMax;
+    UPInt     planeCount = planes.GetSize();
+
+    for (UPInt i = 0; i < planeCount; i++)
+    for (UPInt j = i + 1; j < planeCount; j++)
+    {
+        Vector3f cross_ij = planes[i].N.Cross(planes[j].N);
+        for (UPInt k = j + 1; k < planeCount; k++)
+        {
+            const Planef& a = planes[i];
+            const Planef& b = planes[j];
+            const Planef& c = planes[k];
+
+            float det   = cross_ij.Dot(c.N);
+            float scale = a.N.Length() * b.N.Length() * c.N.Length();
+            if (fabsf(det) <= 1e-6f * scale)
+                continue;
+
+            // Solves a.N.p = -a.D, b.N.p = -b.D, c.N.p = -c.D.
+            Vector3f corner = (b.N.Cross(c.N) * a.D + c.N.Cross(a.N) * b.D + cross_ij * c.D) * (-1.0f / det);
+
+            float extent    = Alg::Max(fabsf(corner.x), Alg::Max(fabsf(corner.y), fabsf(corner.z)));
+            float tolerance = 1e-4f * Alg::Max(1.0f, extent);
+            UPInt p = 0;
+            while (p < planeCount && planes[p].TestSide(corner) <= tolerance)
+                p++;
+            if (p < planeCount)
+                continue;
+
+            if (!foundCorner)
+            {
+                cornerMin = cornerMax = corner;
+                foundCorner = true;
+            }
+            GrowBounds(&cornerMin, &cornerMax, corner);
+        }
+    }
+
+    if (!foundCorner)
+    {
+        return false;
+    }
+
+    float extent = Alg::Max(Alg::Max(Alg::Max(fabsf(cornerMin.x), fabsf(cornerMax.x)),
+                                     Alg::Max(fabsf(cornerMin.y), fabsf(cornerMax.y))),
+                            Alg::Max(fabsf(cornerMin.z), fabsf(cornerMax.z)));
+    if (extent >= HullBoundsLimit * 0.5f)
+    {
+        return false;
+    }
+
+    // Padding covers rounding in the corners, and points that TestPoint accepts
+    // on the boundary.
+    Vector3f padding(1e-3f + extent * 1e-4f, 1e-3f + extent * 1e-4f, 1e-3f + extent * 1e-4f);
+    *boundsMin = cornerMin - padding;
+    *boundsMax = cornerMax + padding;
+    return true;
+}
+
+static bool IsSamePlane(const Planef& a, const Planef& b)
+{
+    float lengthA = a.N.Length(), lengthB = b.N.Length();
+    if (lengthA <= 0 || lengthB <= 0)
+    {
+        return lengthA == lengthB && a.D == b.D;
+    }
+
+    Vector3f n = a.N / lengthA - b.N / lengthB;
+    float    d = a.D / lengthA - b.D / lengthB;
+    return fabsf(n.x) <= DuplicateNormalTolerance && fabsf(n.y) <= DuplicateNormalTolerance &&
+           fabsf(n.z) <= DuplicateNormalTolerance &&
+           fabsf(d) <= DuplicateDistanceTolerance * Alg::Max(1.0f, fabsf(a.D / lengthA));
+}
+
+void CollisionModel::Optimize()
+{
+    Array<Planef> planes;
+    for (UPInt i = 0; i < Planes.GetSize(); i++)
+    {
+        UPInt j = 0;
+        while (j < planes.GetSize() && !IsSamePlane(planes[j], Planes[i]))
+            j++;
+        if (j == planes.GetSize())
+            planes.PushBack(Planes[i]);
+    }
+
+    Vector3f boundsMin, boundsMax;
+    bool     bounded = FindHullBounds(planes, &boundsMin, &boundsMax);
+
+    // Once a query is inside the bounds, a plane lying on one of the box's faces
+    // never rejects it, while a slanted one cuts off a corner. Count the points of
+    // a lattice in the box that each plane rejects, and test the best first.
+    if (bounded)
+    {
+        Array<int> rejected;
+        rejected.Resize(planes.GetSize());
+        Vector3f size = boundsMax - boundsMin;
+        for (UPInt i = 0; i < planes.GetSize(); i++)
+        {
+            rejected[i] = 0;
+            for (int z = 0; z < RejectionSamplesPerAxis; z++)
+            for (int y = 0; y < RejectionSamplesPerAxis; y++)
+            for (int x = 0; x < RejectionSamplesPerAxis; x++)
+            {
+                Vector3f p(boundsMin.x + size.x * (x + 0.5f) / RejectionSamplesPerAxis,
+                           boundsMin.y + size.y * (y + 0.5f) / RejectionSamplesPerAxis,
+                           boundsMin.z + size.z * (z + 0.5f) / RejectionSamplesPerAxis);
+                if (planes[i].TestSide(p) > 0)
+                    rejected[i]++;
+            }
+        }
+
+        // Stable, so planes that reject as much keep the file's order.
+        for (UPInt i = 1; i < planes.GetSize(); i++)
+        {
+            Planef plane = planes[i];
+            int    count = rejected[i];
+            UPInt  j = i;
+            for (; j > 0 && rejected[j - 1] < count; j--)
+            {
+                planes[j]   = planes[j - 1];
+                rejected[j] = rejected[j - 1];
+            }
+            planes[j]   = plane;
+            rejected[j] = count;
+        }
+    }
+
+    Planes.Clear();
+    PlaneBlocks.Clear();
+    for (UPInt i = 0; i < planes.GetSize(); i++)
+    {
+        Add(planes[i]);
+    }
+
+    BoundsMin = boundsMin;
+    BoundsMax = boundsMax;
+    HasBounds = bounded;
+}
+
+bool CollisionModel::GetBounds(Vector3f* boundsMin, Vector3f* boundsMax) const
+{
+    if (HasBounds)
+    {
+        *boundsMin = BoundsMin;
+        *boundsMax = BoundsMax;
+        return true;
+    }
+    return FindHullBounds(Planes, boundsMin, boundsMax);
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** CollisionModel
+
+CollisionQueryStats CollisionModel::QueryStats;
+
+bool CollisionModel::TestPoint(const Vector3f& p) const
+{
+    QueryStats.PointTests++;
+    if (HasBounds && !BoxContainsPoint(BoundsMin, BoundsMax, p))
+    {
+        return false;
+    }
+    QueryStats.PlaneTests += (UInt32)Planes.GetSize();
+
+#if defined(OVR_RENDER_SSE2)
+    if (PlaneBlocks.GetSize() > 0)
+    {
+        return TestPointSse2(&PlaneBlocks[0], PlaneBlocks.GetSize() / PlaneBlockFloats, p);
+    }
+#endif
+    return TestPointScalar(Planes, p);
+}
+
+bool CollisionModel::TestRay(const Vector3f& origin, const Vector3f& norm, float& len, Planef* ph) const
+{
+    CollisionRay ray(origin, norm, len);
+    if (!TestRays(&ray, 1))
+    {
+        return false;
+    }
+
+    len = ray.Length;
+    if (ph)
+    {
+        *ph = ray.Plane;
+    }
+    return true;
+}
+
+int CollisionModel::TestRays(CollisionRay* rays, UPInt count, CollisionKernelPath path) const
+{
+    QueryStats.RayTests += (UInt32)count;
+
+    if (Planes.GetSize() == 0)
+    {
+        return 0;
+    }
+
+    int hits = 0;
+    path = ResolveCollisionKernelPath(path);
+
+    if (path == CollisionKernel_Scalar)
+    {
+        for (UPInt r = 0; r < count; r++)
+        {
+            if (!RayMayHitBounds(*this, rays[r]))
+                continue;
+            QueryStats.PlaneTests += (UInt32)Planes.GetSize();
+
+            if (TestRayScalar(Planes, rays[r].Origin, rays[r].Norm, rays[r].Length, &rays[r].Plane))
+            {
+                rays[r].Hit = true;
+                hits++;
+            }
+        }
+        return hits;
+    }
+
+#if defined(OVR_RENDER_SSE2)
+    const float* blocks     = &PlaneBlocks[0];
+    UPInt        blockCount = PlaneBlocks.GetSize() / PlaneBlockFloats;
+
+    for (UPInt r = 0; r < count; r++)
+    {
+        CollisionRay&  ray = rays[r];
+        if (!RayMayHitBounds(*this, ray))
+            continue;
+        QueryStats.PlaneTests += (UInt32)Planes.GetSize();
+
+        Vector3f       fullMove = ray.Origin + ray.Norm * ray.Length;
+        RayPlaneResult result;
+
+        if (path == CollisionKernel_AVX2)
+            TestRayPlanesAvx2(blocks, blockCount, ray.Origin, fullMove, &result);
+        else
+            TestRayPlanesSse2(blocks, blockCount, ray.Origin, fullMove, &result);
+
+        if (!result.OriginOutside)
+        {
+            ray.Length = 0;
+            ray.Plane  = Planes[0];
+        }
+        else if (result.EndOutside || result.Crossing < 0)
+        {
+            continue;
+        }
+        else
+        {
+            float len = ray.Length * result.CrossingDot1 / (result.CrossingDot1 - result.CrossingDot2) - 0.05f;
+            ray.Length = (len < 0) ? 0 : len;
+            ray.Plane  = Planes[result.Crossing];
+        }
+        ray.Hit = true;
+        hits++;
+    }
+#endif
+    return hits;
+}
+
+}} // OVR::Render
@@ -0,0 +1,400 @@
+/************************************************************************************
+
+Filename    :   Render_CollisionTree.cpp
+Content     :   Bounding volume hierarchy over convex collision models
+Created     :   October 17, 2026
+Authors     :
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************************/
+
+#include "Render_CollisionTree.h"
+
+#include <math.h>
+#include <float.h>
+
+namespace OVR { namespace Render {
+
+// Models can share a leaf; leaves are split until they hold this many.
+static const UPInt MaxLeafModels     = 4;
+static const int   MaxTreeDepth      = 48;
+// Enough for MaxTreeDepth, as traversal keeps at most one sibling per level.
+static const int   TraversalStackSize = MaxTreeDepth + 2;
+
+static inline float GetAxis(const Vector3f& v, int axis)
+{
+    return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+static inline void GrowBounds(Vector3f* boundsMin, Vector3f* boundsMax, const Vector3f& p)
+{
+    boundsMin->x = Alg::Min(boundsMin->x, p.x);
+    boundsMin->y = Alg::Min(boundsMin->y, p.y);
+    boundsMin->z = Alg::Min(boundsMin->z, p.z);
+    boundsMax->x = Alg::Max(boundsMax->x, p.x);
+    boundsMax->y = Alg::Max(boundsMax->y, p.y);
+    boundsMax->z = Alg::Max(boundsMax->z, p.z);
+}
+
+static inline bool BoxContainsPoint(const Vector3f& boundsMin, const Vector3f& boundsMax, const Vector3f& p)
+{
+    return p.x >= boundsMin.x && p.x <= boundsMax.x &&
+           p.y >= boundsMin.y && p.y <= boundsMax.y &&
+           p.z >= boundsMin.z && p.z <= boundsMax.z;
+}
+
+static inline bool BoxesOverlap(const Vector3f& aMin, const Vector3f& aMax,
+                                const Vector3f& bMin, const Vector3f& bMax)
+{
+    return aMin.x <= bMax.x && aMax.x >= bMin.x &&
+           aMin.y <= bMax.y && aMax.y >= bMin.y &&
+           aMin.z <= bMax.z && aMax.z >= bMin.z;
+}
+
+// Narrows [tmin, tmax] to the part of the ray between the two slab planes of one axis.
+static inline bool ClipRayToSlab(float origin, float dir, float slabMin, float slabMax,
+                                 float& tmin, float& tmax)
+{
+    if (fabsf(dir) < 1e-12f)
+    {
+        return origin >= slabMin && origin <= slabMax;
+    }
+    float t1 = (slabMin - origin) / dir;
+    float t2 = (slabMax - origin) / dir;
+    if (t1 > t2)
+    {
+        Alg::Swap(t1, t2);
+    }
+    tmin = Alg::Max(tmin, t1);
+    tmax = Alg::Min(tmax, t2);
+    return tmin <= tmax;
+}
+
+// Whether the segment from origin to origin + norm * len touches the box.
+static inline bool SegmentHitsBox(const Vector3f& origin, const Vector3f& norm, float len,
+                                  const Vector3f& boundsMin, const Vector3f& boundsMax)
+{
+    float tmin = 0, tmax = len;
+    return ClipRayToSlab(origin.x, norm.x, boundsMin.x, boundsMax.x, tmin, tmax) &&
+           ClipRayToSlab(origin.y, norm.y, boundsMin.y, boundsMax.y, tmin, tmax) &&
+           ClipRayToSlab(origin.z, norm.z, boundsMin.z, boundsMax.z, tmin, tmax);
+}
+
+void CollisionTree::Clear()
+{
+    Models.Clear();
+    ModelMin.Clear();
+    ModelMax.Clear();
+    ModelIndices.Clear();
+    UnboundedModels.Clear();
+    Nodes.Clear();
+    Candidates.Clear();
+}
+
+void CollisionTree::Build(const Array<Ptr<CollisionModel> >& models)
+{
+    Clear();
+
+    Models = models;
+    ModelMin.Resize(models.GetSize());
+    ModelMax.Resize(models.GetSize());
+
+    Array<Vector3f> centers;
+    centers.Resize(models.GetSize());
+
+    for (UPInt i = 0; i < models.GetSize(); i++)
+    {
+        if (models[i]->GetBounds(&ModelMin[i], &ModelMax[i]))
+        {
+            centers[i] = (ModelMin[i] + ModelMax[i]) * 0.5f;
+            ModelIndices.PushBack((UInt32)i);
+        }
+        else
+        {
+            // An empty box, which GetModelBounds reports as no bounds.
+            ModelMin[i] = Vector3f(FLT_MAX, FLT_MAX, FLT_MAX);
+            ModelMax[i] = Vector3f(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+            UnboundedModels.PushBack((UInt32)i);
+        }
+    }
+
+    if (ModelIndices.GetSize() > 0)
+    {
+        Nodes.Resize(1);
+        BuildNode(0, 0, ModelIndices.GetSize(), centers, 0);
+    }
+}
+
+// Splits at the middle of the longest axis of the model centers, which keeps the
+// build linear per level and suits the evenly spread hulls of a scene.
+void CollisionTree::BuildNode(UPInt nodeIndex, UPInt first, UPInt count,
+                              const Array<Vector3f>& centers, int depth)
+{
+    Vector3f boundsMin = ModelMin[ModelIndices[first]];
+    Vector3f boundsMax = ModelMax[ModelIndices[first]];
+    Vector3f centerMin = centers[ModelIndices[first]];
+    Vector3f centerMax = centerMin;
+    for (UPInt i = first + 1; i < first + count; i++)
+    {
+        UInt32 model = ModelIndices[i];
+        GrowBounds(&boundsMin, &boundsMax, ModelMin[model]);
+        GrowBounds(&boundsMin, &boundsMax, ModelMax[model]);
+        GrowBounds(&centerMin, &centerMax, centers[model]);
+    }
+
+    Nodes[nodeIndex].BoundsMin = boundsMin;
+    Nodes[nodeIndex].BoundsMax = boundsMax;
+
+    if (count <= MaxLeafModels || depth >= MaxTreeDepth)
+    {
+        Nodes[nodeIndex].First = (UInt32)first;
+        Nodes[nodeIndex].Count = (UInt32)count;
+        return;
+    }
+
+    Vector3f centerSize = centerMax - centerMin;
+    int      axis = 0;
+    if (centerSize.y > GetAxis(centerSize, axis)) axis = 1;
+    if (centerSize.z > GetAxis(centerSize, axis)) axis = 2;
+    float    split = (GetAxis(centerMin, axis) + GetAxis(centerMax, axis)) * 0.5f;
+
+    UPInt middle = first;
+    for (UPInt i = first; i < first + count; i++)
+    {
+        if (GetAxis(centers[ModelIndices[i]], axis) < split)
+        {
+            Alg::Swap(ModelIndices[i], ModelIndices[middle]);
+            middle++;
+        }
+    }
+    // All centers coincide; any split will do.
+    if (middle == first || middle == first + count)
+    {
+        middle = first + count / 2;
+    }
+
+    UPInt children = Nodes.GetSize();
+    Nodes.Resize(children + 2);
+    Nodes[nodeIndex].First = (UInt32)children;
+    Nodes[nodeIndex].Count = 0;
+
+    BuildNode(children,     first,  middle - first,         centers, depth + 1);
+    BuildNode(children + 1, middle, first + count - middle, centers, depth + 1);
+}
+
+// A model whose bounds a ray segment misses can't contain either of its ends, so
+// TestRay on it would fail and leave len alone; skipping it changes nothing.
+void CollisionTree::GatherRayCandidates(const CollisionRay* rays, UPInt count) const
+{
+    Candidates.Clear();
+    Candidates.Append(UnboundedModels.GetSize() ? &UnboundedModels[0] : NULL, UnboundedModels.GetSize());
+
+    if (Nodes.GetSize() > 0)
+    {
+        UInt32 stack[TraversalStackSize];
+        int    stackSize = 0;
+        stack[stackSize++] = 0;
+
+        while (stackSize > 0)
+        {
+            const Node& node = Nodes[stack[--stackSize]];
+            UPInt r = 0;
+            while (r < count && !SegmentHitsBox(rays[r].Origin, rays[r].Norm, rays[r].Length,
+                                                node.BoundsMin, node.BoundsMax))
+                r++;
+            if (r == count)
+                continue;
+
+            if (node.Count == 0)
+            {
+                stack[stackSize++] = node.First;
+                stack[stackSize++] = node.First + 1;
+                continue;
+            }
+
+            for (UInt32 i = node.First; i < node.First + node.Count; i++)
+            {
+                UInt32 model = ModelIndices[i];
+                for (r = 0; r < count; r++)
+                {
+                    if (SegmentHitsBox(rays[r].Origin, rays[r].Norm, rays[r].Length,
+                                       ModelMin[model], ModelMax[model]))
+                    {
+                        Candidates.PushBack(model);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    // Hits shorten the ray for the models after them, so they must be visited in
+    // the same order as the model array. There are only a few candidates.
+    for (UPInt i = 1; i < Candidates.GetSize(); i++)
+    {
+        UInt32 model = Candidates[i];
+        UPInt  j     = i;
+        for (; j > 0 && Candidates[j - 1] > model; j--)
+        {
+            Candidates[j] = Candidates[j - 1];
+        }
+        Candidates[j] = model;
+    }
+}
+
+bool CollisionTree::TestRay(const Vector3f& origin, const Vector3f& norm, float& len, Planef* ph) const
+{
+    CollisionRay ray(origin, norm, len);
+    if (!TestRays(&ray, 1))
+    {
+        return false;
+    }
+
+    len = ray.Length;
+    if (ph)
+    {
+        *ph = ray.Plane;
+    }
+    return true;
+}
+
+bool CollisionTree::TestRays(CollisionRay* rays, UPInt count) const
+{
+    GatherRayCandidates(rays, count);
+
+    int hits = 0;
+    for (UPInt i = 0; i < Candidates.GetSize(); i++)
+    {
+        hits += Models[Candidates[i]]->TestRays(rays, count);
+    }
+    return hits > 0;
+}
+
+bool CollisionTree::TestRayNearest(const Vector3f& origin, const Vector3f& norm, float& len, Planef* ph) const
+{
+    CollisionRay probe(origin, norm, len);
+    GatherRayCandidates(&probe, 1);
+
+    bool   hit = false;
+    float  nearest = len;
+    Planef plane;
+    for (UPInt i = 0; i < Candidates.GetSize(); i++)
+    {
+        float checkLength = len;
+        if (Models[Candidates[i]]->TestRay(origin, norm, checkLength, &plane))
+        {
+            if (!hit || checkLength < nearest)
+            {
+                nearest = checkLength;
+                if (ph)
+                {
+                    *ph = plane;
+                }
+            }
+            hit = true;
+        }
+    }
+    len = nearest;
+    return hit;
+}
+
+bool CollisionTree::GetModelBounds(UPInt index, Vector3f* boundsMin, Vector3f* boundsMax) const
+{
+    if (ModelMin[index].x > ModelMax[index].x)
+    {
+        return false;
+    }
+    *boundsMin = ModelMin[index];
+    *boundsMax = ModelMax[index];
+    return true;
+}
+
+void CollisionTree::GetModelsInBox(const Vector3f& boxMin, const Vector3f& boxMax, Array<UInt32>* models) const
+{
+    models->Append(UnboundedModels.GetSize() ? &UnboundedModels[0] : NULL, UnboundedModels.GetSize());
+
+    if (Nodes.GetSize() == 0)
+    {
+        return;
+    }
+
+    UInt32 stack[TraversalStackSize];
+    int    stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0)
+    {
+        const Node& node = Nodes[stack[--stackSize]];
+        if (!BoxesOverlap(node.BoundsMin, node.BoundsMax, boxMin, boxMax))
+            continue;
+
+        if (node.Count == 0)
+        {
+            stack[stackSize++] = node.First;
+            stack[stackSize++] = node.First + 1;
+            continue;
+        }
+
+        for (UInt32 i = node.First; i < node.First + node.Count; i++)
+        {
+            UInt32 model = ModelIndices[i];
+            if (BoxesOverlap(ModelMin[model], ModelMax[model], boxMin, boxMax))
+                models->PushBack(model);
+        }
+    }
+}
+
+bool CollisionTree::TestPoint(const Vector3f& p) const
+{
+    for (UPInt i = 0; i < UnboundedModels.GetSize(); i++)
+    {
+        if (Models[UnboundedModels[i]]->TestPoint(p))
+            return true;
+    }
+
+    if (Nodes.GetSize() == 0)
+    {
+        return false;
+    }
+
+    UInt32 stack[TraversalStackSize];
+    int    stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0)
+    {
+        const Node& node = Nodes[stack[--stackSize]];
+        if (!BoxContainsPoint(node.BoundsMin, node.BoundsMax, p))
+            continue;
+
+        if (node.Count == 0)
+        {
+            stack[stackSize++] = node.First;
+            stack[stackSize++] = node.First + 1;
+            continue;
+        }
+
+        for (UInt32 i = node.First; i < node.First + node.Count; i++)
+        {
+            UInt32 model = ModelIndices[i];
+            if (BoxContainsPoint(ModelMin[model], ModelMax[model], p) && Models[model]->TestPoint(p))
+                return true;
+        }
+    }
+    return false;
+}
+
+}} // OVR::Render
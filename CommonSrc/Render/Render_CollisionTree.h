@@ -0,0 +1,93 @@
+/************************************************************************************
+
+Filename    :   Render_CollisionTree.h
+Content     :   Bounding volume hierarchy over convex collision models
+Created     :   October 17, 2026
+Authors     :
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************************/
+
+#ifndef INC_Render_CollisionTree_h
+#define INC_Render_CollisionTree_h
+
+#include "Render_Device.h"
+
+namespace OVR { namespace Render {
+
+// Axis aligned box hierarchy over a set of CollisionModels. Queries only visit the
+// models whose bounds the ray or point touches, and give the same results as
+// testing every model in array order. Queries use scratch storage in the tree,
+// so a tree must not be queried from several threads at once.
+class CollisionTree
+{
+public:
+    CollisionTree() { }
+
+    // Rebuilds the tree; call again whenever the models or their planes change.
+    void  Build(const Array<Ptr<CollisionModel> >& models);
+    void  Clear();
+
+    UPInt GetModelCount() const { return Models.GetSize(); }
+    UPInt GetNodeCount() const  { return Nodes.GetSize(); }
+    const CollisionModel* GetModel(UPInt index) const { return Models[index]; }
+    // The bounds the tree keeps for a model; false for models without bounds.
+    bool  GetModelBounds(UPInt index, Vector3f* boundsMin, Vector3f* boundsMax) const;
+
+    // Appends the indices of models whose bounds overlap the box, or that have no
+    // bounds, in no particular order.
+    void  GetModelsInBox(const Vector3f& boxMin, const Vector3f& boxMax, Array<UInt32>* models) const;
+
+    // Same as calling CollisionModel::TestRay on each model in order with a shared
+    // len, which gets shorter with every hit; ph receives the plane of the last hit.
+    bool  TestRay(const Vector3f& origin, const Vector3f& norm, float& len, Planef* ph = NULL) const;
+
+    // TestRay for several rays at once; each model is visited once for all of them.
+    // Returns whether any ray hit.
+    bool  TestRays(CollisionRay* rays, UPInt count) const;
+
+    // Tests each model with the full len and returns the shortest hit.
+    bool  TestRayNearest(const Vector3f& origin, const Vector3f& norm, float& len, Planef* ph = NULL) const;
+
+    // Return whether p is inside any model.
+    bool  TestPoint(const Vector3f& p) const;
+
+private:
+    // Interior nodes have Count == 0 and children at First and First + 1;
+    // leaves hold Count entries of ModelIndices starting at First.
+    struct Node
+    {
+        Vector3f BoundsMin, BoundsMax;
+        UInt32   First;
+        UInt32   Count;
+    };
+
+    void  BuildNode(UPInt nodeIndex, UPInt first, UPInt count, const Array<Vector3f>& centers, int depth);
+    void  GatherRayCandidates(const CollisionRay* rays, UPInt count) const;
+
+    Array<Ptr<CollisionModel> > Models;
+    Array<Vector3f>             ModelMin, ModelMax;
+    Array<UInt32>               ModelIndices;
+    Array<UInt32>               UnboundedModels;
+    Array<Node>                 Nodes;
+
+    // Model indices found by the last ray query, in ascending order.
+    mutable Array<UInt32>       Candidates;
+};
+
+}} // OVR::Render
+
+#endif // INC_Render_CollisionTree_h
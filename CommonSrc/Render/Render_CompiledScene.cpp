@@ -0,0 +1,372 @@
+/************************************************************************************
+
+Filename    :   Render_CompiledScene.cpp
+Content     :   Binary compiled form of XML scene files - implementation
+Created     :   October 17, 2026
+Authors     :
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************************/
+
+#include "Render_CompiledScene.h"
+#include "Render_XmlSceneLoader.h"
+#include "Render_MappedFile.h"
+#include <Kernel/OVR_Log.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef OVR_DEFINE_NEW
+#undef new
+#endif
+
+namespace OVR { namespace Render {
+
+//-------------------------------------------------------------------------------------
+// ***** Reading and writing helpers
+
+// Bounds-checked cursor over the mapped file.
+class CompiledSceneReader
+{
+public:
+    CompiledSceneReader(const UByte* data, UPInt size) : pCur(data), pEnd(data + size) { }
+
+    // Returns a pointer to the next size bytes and advances, or NULL if the file is truncated.
+    const UByte* Take(UPInt size)
+    {
+        if ((UPInt)(pEnd - pCur) < size)
+            return NULL;
+        const UByte* p = pCur;
+        pCur += size;
+        return p;
+    }
+
+    // Take for count elements of elementSize bytes. The count comes from the file, so
+    // it is checked against what is left before multiplying, which could overflow.
+    const UByte* TakeArray(UPInt count, UPInt elementSize)
+    {
+        if ((UPInt)(pEnd - pCur) / elementSize < count)
+            return NULL;
+        return Take(count * elementSize);
+    }
+
+    bool Read(void* dest, UPInt size)
+    {
+        const UByte* p = Take(size);
+        if (!p)
+            return false;
+        memcpy(dest, p, size);
+        return true;
+    }
+
+    bool Align4(UPInt written)
+    {
+        return Take((4 - (written & 3)) & 3) != NULL;
+    }
+
+private:
+    const UByte* pCur;
+    const UByte* pEnd;
+};
+
+static bool WriteBytes(File* f, const void* data, UPInt size)
+{
+    if (size == 0)
+        return true;
+    return f->Write((const UByte*)data, (int)size) == (int)size;
+}
+
+static bool WritePadding(File* f, UPInt written)
+{
+    static const UByte zeros[4] = { 0, 0, 0, 0 };
+    return WriteBytes(f, zeros, (4 - (written & 3)) & 3);
+}
+
+static bool WriteCollisionModels(File* f, const Array<Ptr<CollisionModel> >& models)
+{
+    for (UPInt i = 0; i < models.GetSize(); i++)
+    {
+        const CollisionModel* model  = models[i];
+        const Array<Planef>&  planes = model->Planes;
+
+        CompiledCollisionHeader collisionHeader;
+        memset(&collisionHeader, 0, sizeof(collisionHeader));
+        collisionHeader.Flags      = model->HasBounds ? CompiledCollision_Bounds : 0;
+        collisionHeader.PlaneCount = (UInt32)planes.GetSize();
+        if (model->HasBounds)
+        {
+            collisionHeader.BoundsMin[0] = model->BoundsMin.x;
+            collisionHeader.BoundsMin[1] = model->BoundsMin.y;
+            collisionHeader.BoundsMin[2] = model->BoundsMin.z;
+            collisionHeader.BoundsMax[0] = model->BoundsMax.x;
+            collisionHeader.BoundsMax[1] = model->BoundsMax.y;
+            collisionHeader.BoundsMax[2] = model->BoundsMax.z;
+        }
+        if (!WriteBytes(f, &collisionHeader, sizeof(collisionHeader)))
+            return false;
+
+        // Planef is not a plain struct, so store its components explicitly.
+        for (UPInt j = 0; j < planes.GetSize(); j++)
+        {
+            const float p[4] = { planes[j].N.x, planes[j].N.y, planes[j].N.z, planes[j].D };
+            if (!WriteBytes(f, p, sizeof(p)))
+                return false;
+        }
+    }
+    return true;
+}
+
+static bool ReadCollisionModels(CompiledSceneReader& reader, UInt32 count,
+                                Array<Ptr<CollisionModel> >* models)
+{
+    for (UInt32 i = 0; i < count; i++)
+    {
+        CompiledCollisionHeader collisionHeader;
+        if (!reader.Read(&collisionHeader, sizeof(collisionHeader)))
+            return false;
+
+        const float* p = (const float*)reader.TakeArray(collisionHeader.PlaneCount, 4 * sizeof(float));
+        if (!p)
+            return false;
+
+        // The planes were optimized before they were written.
+        Ptr<CollisionModel> cm = *new CollisionModel();
+        for (UInt32 j = 0; j < collisionHeader.PlaneCount; j++, p += 4)
+        {
+            cm->Add(Planef(p[0], p[1], p[2], p[3]));
+        }
+        if (collisionHeader.Flags & CompiledCollision_Bounds)
+        {
+            const float* boundsMin = collisionHeader.BoundsMin;
+            const float* boundsMax = collisionHeader.BoundsMax;
+            cm->BoundsMin = Vector3f(boundsMin[0], boundsMin[1], boundsMin[2]);
+            cm->BoundsMax = Vector3f(boundsMax[0], boundsMax[1], boundsMax[2]);
+            cm->HasBounds = true;
+        }
+        models->PushBack(cm);
+    }
+    return true;
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** XmlHandler compiled scene support
+
+bool XmlHandler::WriteCompiledFile(const char* fileName) const
+{
+    SysFile f(fileName, File::Open_Write | File::Open_Create | File::Open_Truncate);
+    if (!f.IsValid())
+    {
+        return false;
+    }
+
+    CompiledSceneHeader header;
+    header.Magic                     = CompiledScene_Magic;
+    header.Version                   = CompiledScene_Version;
+    header.VertexSize                = sizeof(Vertex);
+    header.TextureCount              = (UInt32)TextureNames.GetSize();
+    header.ModelCount                = (UInt32)Models.GetSize();
+    header.CollisionModelCount       = (UInt32)CollisionModels.GetSize();
+    header.GroundCollisionModelCount = (UInt32)GroundCollisionModels.GetSize();
+
+    bool ok = WriteBytes(&f, &header, sizeof(header));
+
+    UPInt namesSize = 0;
+    for (UPInt i = 0; ok && i < TextureNames.GetSize(); i++)
+    {
+        UInt32 length = (UInt32)TextureNames[i].GetSize();
+        ok = WriteBytes(&f, &length, sizeof(length)) &&
+             WriteBytes(&f, TextureNames[i].ToCStr(), length);
+        namesSize += length;
+    }
+    ok = ok && WritePadding(&f, namesSize);
+
+    for (UPInt i = 0; ok && i < Models.GetSize(); i++)
+    {
+        const Model* model = Models[i];
+
+        CompiledModelHeader modelHeader;
+        modelHeader.Flags                = model->IsCollisionModel ? CompiledModel_Collision : 0;
+        modelHeader.DiffuseTextureIndex  = ModelTextureIndices[i].DiffuseIndex;
+        modelHeader.LightmapTextureIndex = ModelTextureIndices[i].LightmapIndex;
+        modelHeader.VertexCount          = (UInt32)model->Vertices.GetSize();
+        modelHeader.IndexCount           = (UInt32)model->Indices.GetSize();
+
+        ok = WriteBytes(&f, &modelHeader, sizeof(modelHeader));
+        if (ok && modelHeader.VertexCount)
+            ok = WriteBytes(&f, &model->Vertices[0], modelHeader.VertexCount * sizeof(Vertex));
+        if (ok && modelHeader.IndexCount)
+            ok = WriteBytes(&f, &model->Indices[0], modelHeader.IndexCount * sizeof(UInt16));
+        ok = ok && WritePadding(&f, modelHeader.IndexCount * sizeof(UInt16));
+    }
+
+    ok = ok && WriteCollisionModels(&f, CollisionModels) &&
+               WriteCollisionModels(&f, GroundCollisionModels);
+
+    f.Close();
+    if (!ok)
+    {
+        OVR_DEBUG_LOG(("Failed writing compiled scene %s", fileName));
+    }
+    return ok;
+}
+
+bool XmlHandler::ReadCompiledFile(const char* fileName)
+{
+    MappedFile mapping;
+    if (!mapping.Open(fileName))
+    {
+        return false;
+    }
+
+    ClearData();
+    SetFilePath(fileName);
+
+    CompiledSceneReader reader(mapping.GetData(), mapping.GetSize());
+    CompiledSceneHeader header;
+    if (!reader.Read(&header, sizeof(header)) ||
+        header.Magic != CompiledScene_Magic ||
+        header.Version != CompiledScene_Version ||
+        header.VertexSize != sizeof(Vertex))
+    {
+        OVR_DEBUG_LOG(("Compiled scene %s is out of date or invalid", fileName));
+        return false;
+    }
+
+    bool  ok        = true;
+    UPInt namesSize = 0;
+    for (UInt32 i = 0; ok && i < header.TextureCount; i++)
+    {
+        UInt32 length = 0;
+        const char* name = NULL;
+        ok = reader.Read(&length, sizeof(length)) &&
+             (name = (const char*)reader.Take(length)) != NULL;
+        if (ok)
+        {
+            TextureNames.PushBack(String(name, length));
+            namesSize += length;
+        }
+    }
+    ok = ok && reader.Align4(namesSize);
+
+    for (UInt32 i = 0; ok && i < header.ModelCount; i++)
+    {
+        CompiledModelHeader modelHeader;
+        const Vertex* vertices = NULL;
+        const UByte*  indices  = NULL;
+
+        ok = reader.Read(&modelHeader, sizeof(modelHeader)) &&
+             (SInt32)header.TextureCount > modelHeader.DiffuseTextureIndex &&
+             (SInt32)header.TextureCount > modelHeader.LightmapTextureIndex &&
+             (vertices = (const Vertex*)reader.TakeArray(modelHeader.VertexCount, sizeof(Vertex))) != NULL &&
+             (indices = reader.TakeArray(modelHeader.IndexCount, sizeof(UInt16))) != NULL &&
+             reader.Align4(modelHeader.IndexCount * sizeof(UInt16));
+        if (!ok)
+            break;
+
+        Ptr<Model> model = *new Model(Prim_Triangles);
+        model->IsCollisionModel = (modelHeader.Flags & CompiledModel_Collision) != 0;
+        model->Visible          = !model->IsCollisionModel;
+        model->Vertices.Append(vertices, modelHeader.VertexCount);
+        if (modelHeader.IndexCount)
+        {
+            model->Indices.Resize(modelHeader.IndexCount);
+            memcpy(&model->Indices[0], indices, modelHeader.IndexCount * sizeof(UInt16));
+        }
+        model->ComputeBounds();
+
+        ModelTextures textures = { modelHeader.DiffuseTextureIndex, modelHeader.LightmapTextureIndex };
+        ModelTextureIndices.PushBack(textures);
+        Models.PushBack(model);
+    }
+
+    ok = ok && ReadCollisionModels(reader, header.CollisionModelCount, &CollisionModels) &&
+               ReadCollisionModels(reader, header.GroundCollisionModelCount, &GroundCollisionModels);
+
+    if (!ok)
+    {
+        OVR_DEBUG_LOG(("Compiled scene %s is truncated", fileName));
+        ClearData();
+        return false;
+    }
+
+    textureCount              = (int)header.TextureCount;
+    modelCount                = (int)header.ModelCount;
+    collisionModelCount       = (int)header.CollisionModelCount;
+    groundCollisionModelCount = (int)header.GroundCollisionModelCount;
+    ParseModelCount           = modelCount;
+    ParseModelsDecoded        = modelCount;
+
+    InitTextureSlots();
+    return true;
+}
+
+
+//-------------------------------------------------------------------------------------
+
+String GetCompiledScenePath(const char* xmlFileName)
+{
+    String path(xmlFileName);
+    path.StripExtension();
+    return path + OVR_COMPILED_SCENE_EXT;
+}
+
+bool IsCompiledSceneCurrent(const char* xmlFileName, const char* compiledFileName)
+{
+#if defined(OVR_OS_WIN32)
+    struct _stat xmlStat, compiledStat;
+    if (_stat(compiledFileName, &compiledStat) != 0)
+        return false;
+    if (_stat(xmlFileName, &xmlStat) != 0)
+        return true;
+#else
+    struct stat xmlStat, compiledStat;
+    if (stat(compiledFileName, &compiledStat) != 0)
+        return false;
+    if (stat(xmlFileName, &xmlStat) != 0)
+        return true;
+#endif
+    return compiledStat.st_mtime >= xmlStat.st_mtime;
+}
+
+bool CompileScene(const char* xmlFileName, const char* compiledFileName)
+{
+    XmlHandler handler;
+    if (!handler.ParseFile(xmlFileName))
+    {
+        return false;
+    }
+    return handler.WriteCompiledFile(compiledFileName);
+}
+
+bool ParseSceneFile(XmlHandler* handler, const char* xmlFileName, WorkerPool* pWorkers)
+{
+    // Fall back to the XML if the compiled file is missing, stale or was written
+    // by another build.
+    String compiledPath = GetCompiledScenePath(xmlFileName);
+    if (IsCompiledSceneCurrent(xmlFileName, compiledPath.ToCStr()) &&
+        handler->ReadCompiledFile(compiledPath.ToCStr()))
+    {
+        return true;
+    }
+    return handler->ParseFile(xmlFileName, pWorkers);
+}
+
+}} // OVR::Render
+
+#ifdef OVR_DEFINE_NEW
+#define new OVR_DEFINE_NEW
+#endif
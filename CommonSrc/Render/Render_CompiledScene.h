@@ -0,0 +1,112 @@
+/************************************************************************************
+
+Filename    :   Render_CompiledScene.h
+Content     :   Binary compiled form of XML scene files
+Created     :   October 17, 2026
+Authors     :
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************************/
+
+#ifndef INC_Render_CompiledScene_h
+#define INC_Render_CompiledScene_h
+
+#include "Kernel/OVR_Types.h"
+#include "Kernel/OVR_String.h"
+
+namespace OVR { namespace Render {
+
+class XmlHandler;
+class WorkerPool;
+
+// A compiled scene holds exactly what XmlHandler::ParseFile produces from a scene
+// XML: packed Vertex arrays, 16-bit index buffers, texture file names and collision
+// planes. It is written next to the XML and memory-mapped on load, so loading
+// involves no text parsing. The layout is native-endian and depends on
+// sizeof(Vertex); files written by a different build are rejected and the XML
+// is used instead.
+//
+// Layout:
+//   CompiledSceneHeader
+//   TextureCount x { UInt32 length; char name[length]; } padded to 4 bytes
+//   ModelCount x { CompiledModelHeader; Vertex[VertexCount]; UInt16[IndexCount]; } padded to 4 bytes
+//   CollisionModelCount + GroundCollisionModelCount x { CompiledCollisionHeader; float[4 * PlaneCount]; }
+//
+// Collision planes are stored as CollisionModel::Optimize left them, with their
+// bounds, so loading doesn't optimize them again.
+
+#define OVR_COMPILED_SCENE_EXT ".scenebin"
+
+enum
+{
+    CompiledScene_Magic   = 0x4E43534F, // "OSCN"
+    CompiledScene_Version = 2
+};
+
+enum CompiledModelFlags
+{
+    CompiledModel_Collision = 1
+};
+
+enum CompiledCollisionFlags
+{
+    CompiledCollision_Bounds = 1
+};
+
+struct CompiledSceneHeader
+{
+    UInt32 Magic;
+    UInt32 Version;
+    UInt32 VertexSize;
+    UInt32 TextureCount;
+    UInt32 ModelCount;
+    UInt32 CollisionModelCount;
+    UInt32 GroundCollisionModelCount;
+};
+
+struct CompiledModelHeader
+{
+    UInt32 Flags;
+    SInt32 DiffuseTextureIndex;
+    SInt32 LightmapTextureIndex;
+    UInt32 VertexCount;
+    UInt32 IndexCount;
+};
+
+struct CompiledCollisionHeader
+{
+    UInt32 Flags;
+    UInt32 PlaneCount;
+    float  BoundsMin[3];
+    float  BoundsMax[3];
+};
+
+// Returns the compiled scene path for a scene XML, "Tuscany.xml" -> "Tuscany.scenebin".
+String GetCompiledScenePath(const char* xmlFileName);
+
+// Returns true if compiledFileName exists and is newer than xmlFileName.
+bool   IsCompiledSceneCurrent(const char* xmlFileName, const char* compiledFileName);
+
+// Parses a scene XML and writes its compiled form. Does not require a RenderDevice.
+bool   CompileScene(const char* xmlFileName, const char* compiledFileName);
+
+// Reads the compiled form of a scene XML into handler if it is current, and
+// parses the XML otherwise.
+bool   ParseSceneFile(XmlHandler* handler, const char* xmlFileName, WorkerPool* pWorkers = NULL);
+
+}} // OVR::Render
+
+#endif // INC_Render_CompiledScene_h
@@ -44,9 +44,15 @@ static D3D1x_(INPUT_ELEMENT_DESC) ModelVertexDesc[] =
 };
 
 
+// Proj is set once per eye in the Frame buffer; View is the first constant of
+// every builtin vertex shader's own buffer, the only one written for each draw.
+// Shaders that place View elsewhere have it set by handle instead.
 static const char* StdVertexShaderSrc =
-    "float4x4 Proj;\n"
-    "float4x4 View;\n"
+    "cbuffer Frame : register(b2)\n"
+    "{\n"
+    "   float4x4 Proj;\n"
+    "};\n"
+    "float4x4 View : register(c0);\n"
     "struct Varyings\n"
     "{\n"
     "   float4 Position : SV_Position;\n"
@@ -68,7 +74,7 @@ static const char* StdVertexShaderSrc =
     "}\n";
 
 static const char* DirectVertexShaderSrc =
-    "float4x4 View : register(c4);\n"
+    "float4x4 View : register(c0);\n"
     "void main(in float4 Position : POSITION, in float4 Color : COLOR0, in float2 TexCoord : TEXCOORD0, in float2 TexCoord1 : TEXCOORD1, in float3 Normal : NORMAL,\n"
     "          out float4 oPosition : SV_Position, out float4 oColor : COLOR, out float2 oTexCoord : TEXCOORD0, out float2 oTexCoord1 : TEXCOORD1, out float3 oNormal : NORMAL)\n"
     "{\n"
@@ -208,8 +214,8 @@ static const char* AlphaTexturePixelShaderSrc =
 // ***** PostProcess Shader
 
 static const char* PostProcessVertexShaderSrc =
-    "float4x4 View : register(c4);\n"
-    "float4x4 Texm : register(c8);\n"
+    "float4x4 View : register(c0);\n"
+    "float4x4 Texm : register(c4);\n"
     "void main(in float4 Position : POSITION, in float4 Color : COLOR0, in float2 TexCoord : TEXCOORD0, in float2 TexCoord1 : TEXCOORD1,\n"
     "          out float4 oPosition : SV_Position, out float4 oColor : COLOR, out float2 oTexCoord : TEXCOORD0)\n"
     "{\n"
@@ -399,6 +405,7 @@ RenderDevice::RenderDevice(const RendererParams& p, HWND window)
     QuadVertexBuffer->Data(Buffer_Vertex, QuadVertices, sizeof(QuadVertices));
 
     SetDepthMode(0, 0);
+    ResetBoundState();
 }
 
 RenderDevice::~RenderDevice()
@@ -724,7 +731,7 @@ void RenderDevice::Clear(float r, float g, float b, float a, float depth)
     {
         // save state that is affected by clearing this way
         ID3D1xDepthStencilState* oldDepthState = CurDepthState;
-        StandardUniformData      clearUniforms;
+        Matrix4f                 clearView;
 
         SetDepthMode(true, true, Compare_Always);
 
@@ -748,11 +755,11 @@ void RenderDevice::Clear(float r, float g, float b, float a, float depth)
         UINT vertexOffset = 0;
         Context->IASetVertexBuffers(0, 1, &vertexBuffer, &vertexStride, &vertexOffset);
 
-        clearUniforms.View = Matrix4f(2, 0, 0, 0,
-                                      0, 2, 0, 0,
-                                      0, 0, 0, 0,
-                                      -1, -1, depth, 1);
-        UniformBuffers[Shader_Vertex]->Data(Buffer_Uniform, &clearUniforms, sizeof(clearUniforms));
+        clearView = Matrix4f(2, 0, 0, 0,
+                             0, 2, 0, 0,
+                             0, 0, 0, 0,
+                             -1, -1, depth, 1);
+        UniformBuffers[Shader_Vertex]->Data(Buffer_Uniform, &clearView, sizeof(clearView));
 
         ID3D1xBuffer* vertexConstants = UniformBuffers[Shader_Vertex]->GetBuffer();
         Context->VSSetConstantBuffers(0, 1, &vertexConstants);
@@ -782,6 +789,7 @@ void RenderDevice::Clear(float r, float g, float b, float a, float depth)
         // reset
         CurDepthState = oldDepthState;
         Context->OMSetDepthStencilState(CurDepthState, 0);
+        ResetBoundState();
     }
 }
 
@@ -798,6 +806,11 @@ Buffer::~Buffer()
 
 bool   Buffer::Data(int use, const void *buffer, size_t size)
 {
+    if (buffer && (use & Buffer_TypeMask) == Buffer_Uniform)
+    {
+        Ren->AddUniformBytesUploaded(size);
+    }
+
     if (D3DBuffer && Size >= size)
     {
         if (Dynamic)
@@ -930,15 +943,27 @@ template<> bool Shader<Render::Shader_Geometry, ID3D10GeometryShader>::Load(void
 
 template<> void Shader<Render::Shader_Vertex, ID3D10VertexShader>::Set(PrimitiveType) const
 {
-    Ren->Context->VSSetShader(D3DShader);
+    if (Ren->Bound.Shaders[Render::Shader_Vertex] != D3DShader)
+    {
+        Ren->Context->VSSetShader(D3DShader);
+        Ren->Bound.Shaders[Render::Shader_Vertex] = D3DShader;
+    }
 }
 template<> void Shader<Render::Shader_Pixel, ID3D10PixelShader>::Set(PrimitiveType) const
 {
-    Ren->Context->PSSetShader(D3DShader);
+    if (Ren->Bound.Shaders[Render::Shader_Pixel] != D3DShader)
+    {
+        Ren->Context->PSSetShader(D3DShader);
+        Ren->Bound.Shaders[Render::Shader_Pixel] = D3DShader;
+    }
 }
 template<> void Shader<Render::Shader_Geometry, ID3D10GeometryShader>::Set(PrimitiveType) const
 {
-    Ren->Context->GSSetShader(D3DShader);
+    if (Ren->Bound.Shaders[Render::Shader_Geometry] != D3DShader)
+    {
+        Ren->Context->GSSetShader(D3DShader);
+        Ren->Bound.Shaders[Render::Shader_Geometry] = D3DShader;
+    }
 }
 
 #else // 11
@@ -957,15 +982,27 @@ template<> bool Shader<Render::Shader_Geometry, ID3D11GeometryShader>::Load(void
 
 template<> void Shader<Render::Shader_Vertex, ID3D11VertexShader>::Set(PrimitiveType) const
 {
-    Ren->Context->VSSetShader(D3DShader, NULL, 0);
+    if (Ren->Bound.Shaders[Render::Shader_Vertex] != D3DShader)
+    {
+        Ren->Context->VSSetShader(D3DShader, NULL, 0);
+        Ren->Bound.Shaders[Render::Shader_Vertex] = D3DShader;
+    }
 }
 template<> void Shader<Render::Shader_Pixel, ID3D11PixelShader>::Set(PrimitiveType) const
 {
-    Ren->Context->PSSetShader(D3DShader, NULL, 0);
+    if (Ren->Bound.Shaders[Render::Shader_Pixel] != D3DShader)
+    {
+        Ren->Context->PSSetShader(D3DShader, NULL, 0);
+        Ren->Bound.Shaders[Render::Shader_Pixel] = D3DShader;
+    }
 }
 template<> void Shader<Render::Shader_Geometry, ID3D11GeometryShader>::Set(PrimitiveType) const
 {
-    Ren->Context->GSSetShader(D3DShader, NULL, 0);
+    if (Ren->Bound.Shaders[Render::Shader_Geometry] != D3DShader)
+    {
+        Ren->Context->GSSetShader(D3DShader, NULL, 0);
+        Ren->Bound.Shaders[Render::Shader_Geometry] = D3DShader;
+    }
 }
 #endif
 
@@ -1004,7 +1041,8 @@ ID3D10Blob* RenderDevice::CompileShader(const char* profile, const char* src, co
 
 
 ShaderBase::ShaderBase(RenderDevice* r, ShaderStage stage)
-    : Render::Shader(stage), Ren(r), UniformData(0)
+    : Render::Shader(stage), Ren(r), UniformData(0), UniformsSize(0), UniformsChanged(true),
+      ViewAtStart(false)
 {
 }
 ShaderBase::~ShaderBase()
@@ -1021,6 +1059,19 @@ bool ShaderBase::SetUniform(const char* name, int n, const float* v)
         if (!strcmp(UniformInfo[i].Name.ToCStr(), name))
         {
             memcpy(UniformData + UniformInfo[i].Offset, v, n * sizeof(float));
+            UniformsChanged = true;
+            return 1;
+        }
+    return 0;
+}
+
+bool ShaderBase::SetUniform(UniformHandle h, int n, const float* v)
+{
+    for(unsigned i = 0; i < UniformInfo.GetSize(); i++)
+        if (UniformInfo[i].Handle == h)
+        {
+            memcpy(UniformData + UniformInfo[i].Offset, v, n * sizeof(float));
+            UniformsChanged = true;
             return 1;
         }
     return 0;
@@ -1030,7 +1081,9 @@ void ShaderBase::InitUniforms(ID3D10Blob* s)
 {
     ID3D10ShaderReflection* ref = NULL;
     D3D10ReflectShader(s->GetBufferPointer(), s->GetBufferSize(), &ref);
-    ID3D10ShaderReflectionConstantBuffer* buf = ref->GetConstantBufferByIndex(0);
+    // Only $Globals, at b0, is per shader; named cbuffers such as Frame and
+    // Lighting are shared and set by the device.
+    ID3D10ShaderReflectionConstantBuffer* buf = ref->GetConstantBufferByName("$Globals");
     D3D10_SHADER_BUFFER_DESC bufd;
     if (FAILED(buf->GetDesc(&bufd)))
     {
@@ -1053,22 +1106,57 @@ void ShaderBase::InitUniforms(ID3D10Blob* s)
             {
                 Uniform u;
                 u.Name = vd.Name;
+                u.Handle = UniformHandle(vd.Name);
                 u.Offset = vd.StartOffset;
                 u.Size = vd.Size;
                 UniformInfo.PushBack(u);
+
+                // Draws write View straight into UniformData when it leads
+                // the buffer, as in the builtin shaders.
+                if (u.Handle == UniformHandle::Literal("View") &&
+                    u.Offset == 0 && u.Size == sizeof(Matrix4f))
+                {
+                    ViewAtStart = true;
+                }
             }
         }
     }
 
+    // Handles are name hashes; two uniforms of one shader sharing a hash
+    // would make a handle set the wrong one.
+    for(unsigned i = 0; i < UniformInfo.GetSize(); i++)
+        for(unsigned j = i + 1; j < UniformInfo.GetSize(); j++)
+        {
+            OVR_ASSERT(UniformInfo[i].Handle != UniformInfo[j].Handle);
+        }
+
     UniformsSize = bufd.Size;
     UniformData = (unsigned char*)OVR_ALLOC(bufd.Size);
 }
 
-void ShaderBase::UpdateBuffer(Buffer* buf)
+void ShaderBase::UpdateBuffer()
 {
-    if (UniformsSize)
+    if (!UniformsSize)
+        return;
+
+    if (!UniformBuffer)
+    {
+        UniformBuffer = *Ren->CreateBuffer();
+    }
+    if (UniformsChanged)
+    {
+        UniformBuffer->Data(Buffer_Uniform, UniformData, UniformsSize);
+        UniformsChanged = false;
+    }
+    BindBuffer(UniformBuffer);
+}
+
+void ShaderBase::BindBuffer(Buffer* buf)
+{
+    if (Ren->Bound.Uniforms[GetStage()] != buf->GetBuffer())
     {
-        buf->Data(Buffer_Uniform, UniformData, UniformsSize);
+        SetUniformBuffer(buf);
+        Ren->Bound.Uniforms[GetStage()] = buf->GetBuffer();
     }
 }
 
@@ -1236,7 +1324,18 @@ void RenderDevice::SetTexture(Render::ShaderStage stage, int slot, const Texture
     if (MaxTextureSet[stage] <= slot)
         MaxTextureSet[stage] = slot + 1;    
 
-    ID3D1xShaderResourceView* sv = t ? t->TexSv : NULL;
+    ID3D1xShaderResourceView* sv      = t ? t->TexSv : NULL;
+    ID3D1xSamplerState*       sampler = t ? t->Sampler : NULL;
+    if (slot < 8)
+    {
+        if (Bound.Views[stage][slot] == sv && Bound.Samplers[stage][slot] == sampler)
+        {
+            return;
+        }
+        Bound.Views[stage][slot]    = sv;
+        Bound.Samplers[stage][slot] = sampler;
+    }
+
     switch(stage)
     {
     case Shader_Fragment:
@@ -1467,7 +1566,15 @@ Texture* RenderDevice::CreateTexture(int format, int width, int height, const vo
         D3D1x_(TEXTURE2D_DESC) dsDesc;
         dsDesc.Width     = width;
         dsDesc.Height    = height;
-        dsDesc.MipLevels = (format == (Texture_RGBA | Texture_GenMipmaps) && data) ? GetNumMipLevels(width, height) : 1;
+        dsDesc.MipLevels = 1;
+        if (data && format == (Texture_RGBA | Texture_GenMipmaps))
+        {
+            dsDesc.MipLevels = GetNumMipLevels(width, height);
+        }
+        else if (data && format == Texture_RGBA)
+        {
+            dsDesc.MipLevels = mipcount;
+        }
         dsDesc.ArraySize = 1;
         dsDesc.Format    = d3dformat;
         dsDesc.SampleDesc.Count = samples;
@@ -1504,40 +1611,29 @@ Texture* RenderDevice::CreateTexture(int format, int width, int height, const vo
 
         if (data)
         {
-            Context->UpdateSubresource(NewTex->Tex, 0, NULL, data, width * bpp, width * height * bpp);
+            // Levels are stored back to back, either in data or in a chain built here.
+            const UByte* level = (const UByte*)data;
+            UByte*       chain = NULL;
             if (format == (Texture_RGBA | Texture_GenMipmaps))
             {
-                int srcw = width, srch = height;
-                int level = 0;
-                UByte* mipmaps = NULL;
-                do
-                {
-                    level++;
-                    int mipw = srcw >> 1;
-                    if (mipw < 1)
-                    {
-                        mipw = 1;
-                    }
-                    int miph = srch >> 1;
-                    if (miph < 1)
-                    {
-                        miph = 1;
-                    }
-                    if (mipmaps == NULL)
-                    {
-                        mipmaps = (UByte*)OVR_ALLOC(mipw * miph * 4);
-                    }
-                    FilterRgba2x2(level == 1 ? (const UByte*)data : mipmaps, srcw, srch, mipmaps);
-                    Context->UpdateSubresource(NewTex->Tex, level, NULL, mipmaps, mipw * bpp, miph * bpp);
-                    srcw = mipw;
-                    srch = miph;
-                }
-                while(srcw > 1 || srch > 1);
+                chain = (UByte*)OVR_ALLOC(GetMipChainSize(width, height));
+                BuildMipChain(level, width, height, chain);
+                level = chain;
+            }
 
-                if (mipmaps != NULL)
-                {
-                    OVR_FREE(mipmaps);
-                }
+            int levelw = width, levelh = height;
+            for (UINT i = 0; i < dsDesc.MipLevels; i++)
+            {
+                Context->UpdateSubresource(NewTex->Tex, i, NULL, level, levelw * bpp, levelw * levelh * bpp);
+                TotalTextureMemoryUsage += levelw * levelh * bpp;
+                level += levelw * levelh * bpp;
+                levelw = Alg::Max(levelw >> 1, 1);
+                levelh = Alg::Max(levelh >> 1, 1);
+            }
+
+            if (chain != NULL)
+            {
+                OVR_FREE(chain);
             }
         }
 
@@ -1562,12 +1658,22 @@ Texture* RenderDevice::CreateTexture(int format, int width, int height, const vo
 void RenderDevice::BeginRendering()
 {
     Context->RSSetState(Rasterizer);
+    ResetBoundState();
+}
+
+void RenderDevice::ResetBoundState()
+{
+    memset(&Bound, 0, sizeof(Bound));
+    Bound.Prim = -1;
 }
 
 void RenderDevice::SetRenderTarget(Render::Texture* color, Render::Texture* depth, Render::Texture* stencil)
 {
     OVR_UNUSED(stencil);
 
+    // Textures bound as render targets are unbound from the shaders.
+    ResetBoundState();
+
     CurRenderTarget = (Texture*)color;
     if (color == NULL)
     {
@@ -1602,8 +1708,21 @@ void RenderDevice::SetRenderTarget(Render::Texture* color, Render::Texture* dept
 
 void RenderDevice::SetWorldUniforms(const Matrix4f& proj)
 {
-    StdUniforms.Proj = proj.Transposed();
-    // Shader constant buffers cannot be partially updated.
+    // Shader constant buffers cannot be partially updated, so Proj has a buffer
+    // of its own rather than going out with every draw's View.
+    Matrix4f projT = proj.Transposed();
+    if (!FrameUniforms)
+    {
+        FrameUniforms = *CreateBuffer();
+    }
+    else if (!memcmp(&projT, &StdProj, sizeof(projT)))
+    {
+        return;
+    }
+
+    StdProj = projT;
+    FrameUniforms->Data(Buffer_Uniform, &StdProj, sizeof(StdProj));
+    Context->VSSetConstantBuffers(2, 1, &FrameUniforms->D3DBuffer.GetRawRef());
 }
 
 
@@ -1631,35 +1750,58 @@ void RenderDevice::Render(const Matrix4f& matrix, Model* model)
 void RenderDevice::Render(const Fill* fill, Render::Buffer* vertices, Render::Buffer* indices,
                           const Matrix4f& matrix, int offset, int count, PrimitiveType rprim)
 {
-    Context->IASetInputLayout(ModelVertexIL);
+    // Only state that differs from the previous draw is bound; draws sorted by
+    // fill share shaders, textures and pixel uniforms.
+    if (!Bound.InputLayout)
+    {
+        Context->IASetInputLayout(ModelVertexIL);
+        Bound.InputLayout = true;
+    }
     if (indices)
     {
-        Context->IASetIndexBuffer(((Buffer*)indices)->GetBuffer(), DXGI_FORMAT_R16_UINT, 0);
+        ID3D1xBuffer* indexBuffer = ((Buffer*)indices)->GetBuffer();
+        if (Bound.IndexBuffer != indexBuffer)
+        {
+            Context->IASetIndexBuffer(indexBuffer, DXGI_FORMAT_R16_UINT, 0);
+            Bound.IndexBuffer = indexBuffer;
+        }
     }
 
     ID3D1xBuffer* vertexBuffer = ((Buffer*)vertices)->GetBuffer();
     UINT vertexStride = sizeof(Vertex);
     UINT vertexOffset = offset;
-    Context->IASetVertexBuffers(0, 1, &vertexBuffer, &vertexStride, &vertexOffset);
+    if (Bound.VertexBuffer != vertexBuffer || Bound.VertexOffset != vertexOffset)
+    {
+        Context->IASetVertexBuffers(0, 1, &vertexBuffer, &vertexStride, &vertexOffset);
+        Bound.VertexBuffer = vertexBuffer;
+        Bound.VertexOffset = vertexOffset;
+    }
 
     ShaderSet* shaders = ((ShaderFill*)fill)->GetShaders();
 
+    // Only the vertex uniforms change with every draw; the other stages keep
+    // theirs in per-shader buffers that are uploaded when SetUniform changes them.
     ShaderBase* vshader = ((ShaderBase*)shaders->GetShader(Shader_Vertex));
     unsigned char* vertexData = vshader->UniformData;
     if (vertexData)
     {
-        StandardUniformData* stdUniforms = (StandardUniformData*) vertexData;
-        stdUniforms->View = matrix.Transposed();
-        stdUniforms->Proj = StdUniforms.Proj;
+        if (vshader->ViewAtStart)
+        {
+            *(Matrix4f*)vertexData = matrix.Transposed();
+        }
+        else
+        {
+            Matrix4f view = matrix.Transposed();
+            vshader->SetUniform(UniformHandle::Literal("View"), 16, &view.M[0][0]);
+        }
         UniformBuffers[Shader_Vertex]->Data(Buffer_Uniform, vertexData, vshader->UniformsSize);
-        vshader->SetUniformBuffer(UniformBuffers[Shader_Vertex]);
+        vshader->BindBuffer(UniformBuffers[Shader_Vertex]);
     }
 
     for(int i = Shader_Vertex + 1; i < Shader_Count; i++)
         if (shaders->GetShader(i))
         {
-            ((ShaderBase*)shaders->GetShader(i))->UpdateBuffer(UniformBuffers[i]);
-            ((ShaderBase*)shaders->GetShader(i))->SetUniformBuffer(UniformBuffers[i]);
+            ((ShaderBase*)shaders->GetShader(i))->UpdateBuffer();
         }
 
     D3D1x_(PRIMITIVE_TOPOLOGY) prim;
@@ -1678,7 +1820,11 @@ void RenderDevice::Render(const Fill* fill, Render::Buffer* vertices, Render::Bu
         assert(0);
         return;
     }
-    Context->IASetPrimitiveTopology(prim);
+    if (Bound.Prim != rprim)
+    {
+        Context->IASetPrimitiveTopology(prim);
+        Bound.Prim = rprim;
+    }
 
     fill->Set(rprim);
     if (ExtraShaders)
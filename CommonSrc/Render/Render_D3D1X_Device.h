@@ -118,11 +118,15 @@ public:
     RenderDevice*   Ren;
     unsigned char*  UniformData;
     int             UniformsSize;
+    bool            UniformsChanged;    // Since the last UpdateBuffer.
+    bool            ViewAtStart;        // View fills the first 64 bytes of UniformData.
+    Ptr<Buffer>     UniformBuffer;
 
     struct Uniform
     {
-        String Name;
-        int    Offset, Size;
+        String        Name;
+        UniformHandle Handle;
+        int           Offset, Size;
     };
     Array<Uniform> UniformInfo;
 
@@ -131,9 +135,14 @@ public:
 
     void InitUniforms(ID3D10Blob* s);
     bool SetUniform(const char* name, int n, const float* v);
+    bool SetUniform(UniformHandle h, int n, const float* v);
     //virtual bool UseTransposeMatrix() const { return 1; }
 
-    void UpdateBuffer(Buffer* b);
+    // Uploads UniformData to the shader's own UniformBuffer if SetUniform has
+    // changed it, and binds that buffer.
+    void UpdateBuffer();
+    // Binds b as the stage's uniform buffer unless it is already bound.
+    void BindBuffer(Buffer* b);
 };
 
 template<Render::ShaderStage SStage, class D3DShaderType>
@@ -260,11 +269,10 @@ public:
 
     Ptr<ID3D1xSamplerState>     SamplerStates[Sample_Count];
 
-    struct StandardUniformData
-    {
-        Matrix4f  Proj;
-        Matrix4f  View;
-    }                        StdUniforms;
+    // The transposed projection, and the buffer the standard vertex shader
+    // reads it from, updated only when SetWorldUniforms changes it.
+    Matrix4f                 StdProj;
+    Ptr<Buffer>              FrameUniforms;
     Ptr<Buffer>              UniformBuffers[Shader_Count];
     int                      MaxTextureSet[Shader_Count];
 
@@ -279,6 +287,21 @@ public:
 
     Array<Ptr<Texture> >     DepthBuffers;
 
+    // What Render and SetTexture last bound, so that state shared with the previous
+    // draw isn't bound again. Anything else that binds state calls ResetBoundState.
+    struct BoundState
+    {
+        bool                      InputLayout;
+        int                       Prim;
+        ID3D1xBuffer*             VertexBuffer;
+        UINT                      VertexOffset;
+        ID3D1xBuffer*             IndexBuffer;
+        const void*               Shaders[Shader_Count];    // D3D shader objects.
+        ID3D1xBuffer*             Uniforms[Shader_Count];   // Constant buffers at b0.
+        ID3D1xShaderResourceView* Views[Shader_Count][8];
+        ID3D1xSamplerState*       Samplers[Shader_Count][8];
+    }                        Bound;
+
 public:
     RenderDevice(const RendererParams& p, HWND window);
     ~RenderDevice();
@@ -347,6 +370,7 @@ public:
     ID3D1xSamplerState* GetSamplerState(int sm);
 
     void SetTexture(Render::ShaderStage stage, int slot, const Texture* t);
+    void ResetBoundState();
 };
 
 }}}
@@ -23,6 +23,7 @@ limitations under the License.
 
 #include "../Render/Render_Device.h"
 #include "../Render/Render_Font.h"
+#include "../Render/Render_MappedFile.h"
 
 #include "Kernel/OVR_Log.h"
 
@@ -33,17 +34,517 @@ void Model::Render(const Matrix4f& ltw, RenderDevice* ren)
     if(Visible)
     {
     Matrix4f m = ltw * GetMatrix();
-    ren->Render(m, this);
+    if (!Cull(m, ren))
+    {
+        ren->Render(m, this);
+    }
+    }
+}
+
+void Model::Collect(const Matrix4f& ltw, RenderDevice* ren, RenderQueue* queue)
+{
+    OVR_UNUSED(ren);
+    if (Visible)
+    {
+        queue->Add(this, ltw * GetMatrix());
+    }
+}
+
+bool Model::Cull(const Matrix4f& m, RenderDevice* ren) const
+{
+    if (IsOutside(ren->GetProjection() * m))
+    {
+        ren->AddDrawStats(0, 1);
+        return true;
+    }
+
+    ren->AddDrawStats(1, 0);
+    return false;
+}
+
+bool Model::IsOutside(const Matrix4f& mvp) const
+{
+    // Culling in model space needs only the planes of the full transform.
+    return HasBounds && Frustum(mvp).CullsBounds(BoundsCenter, BoundsRadius, BoundsMin, BoundsMax);
+}
+
+void Model::ComputeBounds()
+{
+    MarkDirty(Dirty_Record);
+    HasBounds = Vertices.GetSize() > 0;
+    if (!HasBounds)
+    {
+        return;
+    }
+
+    BoundsMin = BoundsMax = Vertices[0].Pos;
+    for (UPInt i = 1; i < Vertices.GetSize(); i++)
+    {
+        const Vector3f& p = Vertices[i].Pos;
+        BoundsMin.x = Alg::Min(BoundsMin.x, p.x);
+        BoundsMin.y = Alg::Min(BoundsMin.y, p.y);
+        BoundsMin.z = Alg::Min(BoundsMin.z, p.z);
+        BoundsMax.x = Alg::Max(BoundsMax.x, p.x);
+        BoundsMax.y = Alg::Max(BoundsMax.y, p.y);
+        BoundsMax.z = Alg::Max(BoundsMax.z, p.z);
+    }
+
+    // The box center is a good enough sphere center for scene geometry.
+    BoundsCenter = (BoundsMin + BoundsMax) * 0.5f;
+    float radiusSq = 0;
+    for (UPInt i = 0; i < Vertices.GetSize(); i++)
+    {
+        radiusSq = Alg::Max(radiusSq, (Vertices[i].Pos - BoundsCenter).LengthSq());
+    }
+    BoundsRadius = sqrtf(radiusSq);
+}
+
+Frustum::Frustum(const Matrix4f& mvp)
+{
+    // Gribb-Hartmann: a point is inside when -w <= x, y, z <= w in clip space.
+    const float (*m)[4] = mvp.M;
+    for (int i = 0; i < 3; i++)
+    {
+        Planes[i * 2]     = Planef(Vector3f(m[3][0] + m[i][0], m[3][1] + m[i][1], m[3][2] + m[i][2]), m[3][3] + m[i][3]);
+        Planes[i * 2 + 1] = Planef(Vector3f(m[3][0] - m[i][0], m[3][1] - m[i][1], m[3][2] - m[i][2]), m[3][3] - m[i][3]);
+    }
+
+    // Normalized so the sphere test can compare distances with the radius.
+    for (int i = 0; i < 6; i++)
+    {
+        float length = Planes[i].N.Length();
+        if (length > 0)
+        {
+            Planes[i].N /= length;
+            Planes[i].D /= length;
+        }
+    }
+}
+
+bool Frustum::CullsSphere(const Vector3f& center, float radius) const
+{
+    for (int i = 0; i < 6; i++)
+    {
+        if (Planes[i].N.Dot(center) + Planes[i].D < -radius)
+            return true;
+    }
+    return false;
+}
+
+bool Frustum::CullsBox(const Vector3f& boxMin, const Vector3f& boxMax) const
+{
+    for (int i = 0; i < 6; i++)
+    {
+        // The corner furthest along the plane normal.
+        const Vector3f& n = Planes[i].N;
+        Vector3f p(n.x >= 0 ? boxMax.x : boxMin.x,
+                   n.y >= 0 ? boxMax.y : boxMin.y,
+                   n.z >= 0 ? boxMax.z : boxMin.z);
+        if (n.Dot(p) + Planes[i].D < 0)
+            return true;
+    }
+    return false;
+}
+
+void Node::MarkDirty(int flags)
+{
+    DirtyFlags |= flags;
+
+    // Stops where the flag is already set; all containers above have it too.
+    int parentFlag = (flags & Dirty_Structure) ? Dirty_Structure : Dirty_Children;
+    for (Node* p = Parent; p && !(p->DirtyFlags & parentFlag); p = p->Parent)
+    {
+        p->DirtyFlags |= parentFlag;
+    }
+}
+
+void Container::Add(Node *n)
+{
+    n->Parent = this;
+    Nodes.PushBack(n);
+    MarkDirty(Dirty_Structure);
+}
+
+void Container::ReleaseChildren()
+{
+    for (UPInt i = 0; i < Nodes.GetSize(); i++)
+    {
+        if (Nodes[i]->Parent == this)
+            Nodes[i]->Parent = NULL;
+    }
+}
+
+void Container::UpdateWorldMatrices()
+{
+    if (DirtyFlags & Dirty_Structure)
+    {
+        List.Clear();
+        FlattenChildren(this, GetMatrix(), true, true);
+    }
+    else if (DirtyFlags & (Dirty_Matrix | Dirty_Children))
+    {
+        FlattenChildren(this, GetMatrix(), false, (DirtyFlags & Dirty_Matrix) != 0);
+    }
+    DirtyFlags = 0;
+}
+
+// Walks the containers with changes below them; force recomputes every matrix
+// below this one, rebuild appends the models to root's List.
+void Container::FlattenChildren(Container* root, const Matrix4f& world, bool rebuild, bool force)
+{
+    for (UPInt i = 0; i < Nodes.GetSize(); i++)
+    {
+        Node* node    = Nodes[i];
+        bool  changed = force || (node->DirtyFlags & Dirty_Matrix);
+
+        switch (node->GetType())
+        {
+        case Node_Model:
+            {
+                Model* model = (Model*)node;
+                if (rebuild)
+                {
+                    model->FlatIndex = root->List.GetSize();
+                    root->List.Add(model, world * model->GetMatrix());
+                }
+                else
+                {
+                    OVR_ASSERT(root->List.Models[model->FlatIndex] == model);
+                    if (changed)
+                        root->List.Worlds[model->FlatIndex] = world * model->GetMatrix();
+                    if (model->DirtyFlags & Dirty_Record)
+                        root->List.Refresh(model->FlatIndex);
+                }
+            }
+            break;
+
+        case Node_Container:
+            {
+                Container* container = (Container*)node;
+                if (changed)
+                {
+                    container->WorldMatrix = world * container->GetMatrix();
+                }
+                if (rebuild || changed || (container->DirtyFlags & Dirty_Children))
+                {
+                    container->FlattenChildren(root, container->WorldMatrix, rebuild, changed);
+                }
+            }
+            break;
+
+        default:
+            // Other nodes draw nothing.
+            break;
+        }
+        node->DirtyFlags = 0;
     }
 }
 
 void Container::Render(const Matrix4f& ltw, RenderDevice* ren)
 {
-    Matrix4f m = ltw * GetMatrix();
-    for(unsigned i = 0; i < Nodes.GetSize(); i++)
+    UpdateWorldMatrices();
+    List.Render(ltw, ren);
+}
+
+void Container::Collect(const Matrix4f& ltw, RenderDevice* ren, RenderQueue* queue)
+{
+    OVR_UNUSED(ren);
+    UpdateWorldMatrices();
+    List.Collect(ltw, queue);
+}
+
+void RenderList::Clear()
+{
+    Models.Clear();
+    Worlds.Clear();
+    Spheres.Clear();
+    BoxMins.Clear();
+    BoxMaxs.Clear();
+    FillIds.Clear();
+    VertexBuffers.Clear();
+    IndexBuffers.Clear();
+    IndexCounts.Clear();
+    Prims.Clear();
+    Flags.Clear();
+    Fills.Clear();
+}
+
+UInt16 RenderList::GetFillId(Fill* fill)
+{
+    // Models added together usually share a fill, if they share one at all.
+    UPInt count = Fills.GetSize();
+    if (count && Fills[count - 1] == fill)
+        return (UInt16)(count - 1);
+
+    for (UPInt i = 0; i < count; i++)
     {
-        Nodes[i]->Render(m, ren);
+        if (Fills[i] == fill)
+            return (UInt16)i;
     }
+    OVR_ASSERT(count < 0x10000);
+    Fills.PushBack(fill);
+    return (UInt16)count;
+}
+
+void RenderList::Add(Model* model, const Matrix4f& world)
+{
+    Models.PushBack(model);
+    Worlds.PushBack(world);
+    Spheres.PushBack(Vector4f());
+    BoxMins.PushBack(Vector3f());
+    BoxMaxs.PushBack(Vector3f());
+    FillIds.PushBack(0);
+    VertexBuffers.PushBack(NULL);
+    IndexBuffers.PushBack(NULL);
+    IndexCounts.PushBack(0);
+    Prims.PushBack(0);
+    Flags.PushBack(0);
+    Refresh(Models.GetSize() - 1);
+}
+
+void RenderList::Refresh(UPInt i)
+{
+    Model* model     = Models[i];
+    Spheres[i]       = Vector4f(model->BoundsCenter.x, model->BoundsCenter.y, model->BoundsCenter.z,
+                                model->BoundsRadius);
+    BoxMins[i]       = model->BoundsMin;
+    BoxMaxs[i]       = model->BoundsMax;
+    FillIds[i]       = GetFillId(model->Fill);
+    VertexBuffers[i] = model->VertexBuffer;
+    IndexBuffers[i]  = model->IndexBuffer;
+    IndexCounts[i]   = (int)model->Indices.GetSize();
+    Prims[i]         = (UByte)model->GetPrimType();
+    Flags[i]         = (UByte)((model->Visible ? Record_Visible : 0) | (model->HasBounds ? Record_HasBounds : 0));
+}
+
+void RenderList::Render(const Matrix4f& view, RenderDevice* ren)
+{
+    Matrix4f proj      = ren->GetProjection();
+    int      submitted = 0, culled = 0;
+
+    for (UPInt i = 0; i < Models.GetSize(); i++)
+    {
+        if (!(Flags[i] & Record_Visible))
+        {
+            continue;
+        }
+
+        Matrix4f m = view * Worlds[i];
+        if ((Flags[i] & Record_HasBounds) &&
+            Frustum(proj * m).CullsBounds(Vector3f(Spheres[i].x, Spheres[i].y, Spheres[i].z), Spheres[i].w,
+                                          BoxMins[i], BoxMaxs[i]))
+        {
+            culled++;
+            continue;
+        }
+
+        submitted++;
+        Fill* fill = Fills[FillIds[i]];
+        if (VertexBuffers[i] && fill)
+        {
+            ren->Render(fill, VertexBuffers[i], IndexBuffers[i], m, 0, IndexCounts[i], (PrimitiveType)Prims[i]);
+        }
+        else
+        {
+            // The device creates the buffers, or supplies its default fill.
+            ren->Render(m, Models[i]);
+            VertexBuffers[i] = Models[i]->VertexBuffer;
+            IndexBuffers[i]  = Models[i]->IndexBuffer;
+        }
+    }
+    ren->AddDrawStats(submitted, culled);
+}
+
+void RenderList::Collect(const Matrix4f& view, RenderQueue* queue)
+{
+    for (UPInt i = 0; i < Models.GetSize(); i++)
+    {
+        if (Flags[i] & Record_Visible)
+        {
+            if (!VertexBuffers[i])
+            {
+                VertexBuffers[i] = Models[i]->VertexBuffer;
+                IndexBuffers[i]  = Models[i]->IndexBuffer;
+            }
+            queue->Add(*this, i, view * Worlds[i]);
+        }
+    }
+}
+
+// Sort key fields, from the top bit down.
+static const int RenderQueue_VertexShaderBits = 4;
+static const int RenderQueue_ShaderBits  = 10;     // Vertex shader id, then pixel shader id.
+static const int RenderQueue_TextureBits = 14;
+static const int RenderQueue_DepthBits   = 20;
+static const int RenderQueue_IndexBits   = 20;
+
+void RenderQueue::Clear()
+{
+    Items.Clear();
+    Keys.Clear();
+    ShaderIds[0].Clear();
+    ShaderIds[1].Clear();
+    TextureIds.Clear();
+    CullViews.Clear();
+    Culled            = 0;
+    StateChangesSaved = 0;
+}
+
+void RenderQueue::AddCullView(const Matrix4f& proj)
+{
+    CullViews.PushBack(proj);
+}
+
+UInt64 RenderQueue::GetId(Array<const void*>* ids, const void* p, UInt64 maxId)
+{
+    for (UPInt i = 0; i < ids->GetSize(); i++)
+    {
+        if ((*ids)[i] == p)
+            return i;
+    }
+    // Past the last id, the rest share it; draws still group, just less well.
+    if (ids->GetSize() > maxId)
+        return maxId;
+    ids->PushBack(p);
+    return ids->GetSize() - 1;
+}
+
+void RenderQueue::Add(Model* model, const Matrix4f& m)
+{
+    Item item;
+    item.pModel       = model;
+    item.Matrix       = m;
+    item.pFill        = model->Fill;
+    item.VertexBuffer = model->VertexBuffer;
+    item.IndexBuffer  = model->IndexBuffer;
+    item.IndexCount   = (int)model->Indices.GetSize();
+    item.Prim         = model->GetPrimType();
+
+    Vector4f sphere(model->BoundsCenter.x, model->BoundsCenter.y, model->BoundsCenter.z, model->BoundsRadius);
+    AddItem(item, sphere, model->BoundsMin, model->BoundsMax, model->HasBounds);
+}
+
+void RenderQueue::Add(const RenderList& list, UPInt i, const Matrix4f& m)
+{
+    Item item;
+    item.pModel       = list.Models[i];
+    item.Matrix       = m;
+    item.pFill        = list.Fills[list.FillIds[i]];
+    item.VertexBuffer = list.VertexBuffers[i];
+    item.IndexBuffer  = list.IndexBuffers[i];
+    item.IndexCount   = list.IndexCounts[i];
+    item.Prim         = (PrimitiveType)list.Prims[i];
+
+    AddItem(item, list.Spheres[i], list.BoxMins[i], list.BoxMaxs[i],
+            (list.Flags[i] & RenderList::Record_HasBounds) != 0);
+}
+
+void RenderQueue::AddItem(const Item& item, const Vector4f& sphere, const Vector3f& boxMin,
+                          const Vector3f& boxMax, bool hasBounds)
+{
+    OVR_ASSERT(Items.GetSize() < (1 << RenderQueue_IndexBits));
+
+    const Matrix4f& m = item.Matrix;
+    Vector3f        c = hasBounds ? Vector3f(sphere.x, sphere.y, sphere.z) : Vector3f(0, 0, 0);
+    if (hasBounds && CullViews.GetSize())
+    {
+        bool outside = true;
+        for (UPInt i = 0; i < CullViews.GetSize() && outside; i++)
+        {
+            outside = Frustum(CullViews[i] * m).CullsBounds(c, sphere.w, boxMin, boxMax);
+        }
+        if (outside)
+        {
+            Culled++;
+            return;
+        }
+    }
+
+    // By the shaders rather than the ShaderSet: the scene loaders give every model
+    // its own set of the same builtin shaders.
+    const ShaderFill* fill    = (const ShaderFill*)item.pFill;
+    ShaderSet*        set     = fill ? fill->GetShaders() : NULL;
+    UInt64            vshader = GetId(&ShaderIds[0], set ? set->GetShader(Shader_Vertex) : NULL,
+                                      (1 << RenderQueue_VertexShaderBits) - 1);
+    UInt64            pshader = GetId(&ShaderIds[1], set ? set->GetShader(Shader_Pixel) : NULL,
+                                      (1 << (RenderQueue_ShaderBits - RenderQueue_VertexShaderBits)) - 1);
+    UInt64            shaders = (vshader << (RenderQueue_ShaderBits - RenderQueue_VertexShaderBits)) | pshader;
+    UInt64            texture = GetId(&TextureIds, fill ? fill->GetTexture(0) : NULL,
+                                      (1 << RenderQueue_TextureBits) - 1);
+
+    // View space depth of the bounds center. The bits of a positive float sort
+    // like its value, so the top bits are a logarithmic depth.
+    float    depth = -(m.M[2][0] * c.x + m.M[2][1] * c.y + m.M[2][2] * c.z + m.M[2][3]);
+    UInt32   depthBits;
+    memcpy(&depthBits, &depth, sizeof(depthBits));
+    UInt64   depthKey = depth > 0 ? (depthBits >> (31 - RenderQueue_DepthBits)) : 0;
+
+    UInt64 key = (shaders  << (RenderQueue_TextureBits + RenderQueue_DepthBits + RenderQueue_IndexBits)) |
+                 (texture  << (RenderQueue_DepthBits + RenderQueue_IndexBits)) |
+                 (depthKey << RenderQueue_IndexBits) |
+                 Items.GetSize();
+    Keys.PushBack(key);
+    Items.PushBack(item);
+}
+
+int RenderQueue::CountStateChanges(bool sorted) const
+{
+    int         changes  = 0;
+    const Fill* lastFill = NULL;
+    for (UPInt i = 0; i < Items.GetSize(); i++)
+    {
+        UPInt       index = sorted ? (UPInt)(Keys[i] & ((1 << RenderQueue_IndexBits) - 1)) : i;
+        const Fill* fill  = Items[index].pFill;
+        if (i > 0 && fill == lastFill)
+        {
+            continue;
+        }
+
+        const ShaderFill* a = (const ShaderFill*)lastFill;
+        const ShaderFill* b = (const ShaderFill*)fill;
+        for (int stage = 0; stage < Shader_Count; stage++)
+        {
+            Shader* sa = (i > 0 && a) ? a->GetShaders()->GetShader(stage) : NULL;
+            Shader* sb = b ? b->GetShaders()->GetShader(stage) : NULL;
+            if (sb && sb != sa)
+                changes++;
+        }
+        for (int t = 0; t < 8; t++)
+        {
+            Texture* ta = (i > 0 && a) ? a->GetTexture(t) : NULL;
+            Texture* tb = b ? b->GetTexture(t) : NULL;
+            if (tb && tb != ta)
+                changes++;
+        }
+        lastFill = fill;
+    }
+    return changes;
+}
+
+void RenderQueue::Sort()
+{
+    int unsorted = CountStateChanges(false);
+    Alg::QuickSort(Keys);
+    StateChangesSaved = unsorted - CountStateChanges(true);
+}
+
+void RenderQueue::Submit(RenderDevice* ren, const Matrix4f* viewAdjust)
+{
+    for (UPInt i = 0; i < Keys.GetSize(); i++)
+    {
+        const Item& item = Items[(UPInt)(Keys[i] & ((1 << RenderQueue_IndexBits) - 1))];
+        Matrix4f    m    = viewAdjust ? *viewAdjust * item.Matrix : item.Matrix;
+        if (item.VertexBuffer && item.pFill)
+        {
+            ren->Render(item.pFill, item.VertexBuffer, item.IndexBuffer, m, 0, item.IndexCount, item.Prim);
+        }
+        else
+        {
+            ren->Render(m, item.pModel);
+        }
+    }
+    ren->AddDrawStats((int)Items.GetSize(), Culled);
+    ren->AddStateChangesSaved(StateChangesSaved);
 }
 
 Matrix4f SceneView::GetViewMatrix() const
@@ -67,7 +568,40 @@ void Scene::Render(RenderDevice* ren, const Matrix4f& view)
 
     ren->SetLighting(&Lighting);
 
-    World.Render(view, ren);
+    if (!SortDraws)
+    {
+        World.Render(view, ren);
+        return;
+    }
+
+    Queue.Clear();
+    Queue.AddCullView(ren->GetProjection());
+    World.Collect(view, ren, &Queue);
+    Queue.Sort();
+    Queue.Submit(ren);
+}
+
+void Scene::CollectStereo(RenderDevice* ren, const Matrix4f& view,
+                          const StereoEyeParams& left, const StereoEyeParams& right)
+{
+    // The eye frustums in the space between the eyes.
+    QueueView = view;
+    Queue.Clear();
+    Queue.AddCullView(left.Projection * left.ViewAdjust);
+    Queue.AddCullView(right.Projection * right.ViewAdjust);
+    World.Collect(view, ren, &Queue);
+    if (SortDraws)
+    {
+        Queue.Sort();
+    }
+}
+
+void Scene::RenderEye(RenderDevice* ren, const StereoEyeParams& eye)
+{
+    Lighting.Update(eye.ViewAdjust * QueueView, LightPos);
+    ren->SetLighting(&Lighting);
+
+    Queue.Submit(ren, &eye.ViewAdjust);
 }
 
 
@@ -402,7 +936,8 @@ RenderDevice::RenderDevice()
       
       Distortion(1.0f, 0.18f, 0.115f),            
       DistortionClearColor(0, 0, 0),
-      TotalTextureMemoryUsage(0)
+      TotalTextureMemoryUsage(0),
+      DrawsSubmitted(0), DrawsCulled(0), StateChangesSaved(0), UniformBytesUploaded(0)
 {
 }
 
@@ -418,10 +953,10 @@ Fill* RenderDevice::CreateTextureFill(Render::Texture* t, bool useAlpha)
 
 void LightingParams::Set(ShaderSet* s) const
 {
-    s->SetUniform4fv("Ambient", 1, &Ambient);
-    s->SetUniform1f("LightCount", LightCount);
-    s->SetUniform4fv("LightPos", (int)LightCount, LightPos);
-    s->SetUniform4fv("LightColor", (int)LightCount, LightColor);
+    s->SetUniform4fv(UniformHandle::Literal("Ambient"), 1, &Ambient);
+    s->SetUniform1f(UniformHandle::Literal("LightCount"), LightCount);
+    s->SetUniform4fv(UniformHandle::Literal("LightPos"), (int)LightCount, LightPos);
+    s->SetUniform4fv(UniformHandle::Literal("LightColor"), (int)LightCount, LightColor);
 }
 
 void RenderDevice::SetLighting(const LightingParams* lt)
@@ -747,24 +1282,24 @@ void RenderDevice::FinishScene1()
 
     // We are using 1/4 of DistortionCenter offset value here, since it is
     // relative to [-1,1] range that gets mapped to [0, 0.5].
-    pPostProcessShader->SetUniform2f("LensCenter",
+    pPostProcessShader->SetUniform2f(UniformHandle::Literal("LensCenter"),
                                      x + (w + Distortion.XCenterOffset * 0.5f)*0.5f, y + h*0.5f);
-    pPostProcessShader->SetUniform2f("ScreenCenter", x + w*0.5f, y + h*0.5f);
+    pPostProcessShader->SetUniform2f(UniformHandle::Literal("ScreenCenter"), x + w*0.5f, y + h*0.5f);
 
     // MA: This is more correct but we would need higher-res texture vertically; we should adopt this
     // once we have asymmetric input texture scale.
     float scaleFactor = 1.0f / Distortion.Scale;
 
-    pPostProcessShader->SetUniform2f("Scale",   (w/2) * scaleFactor, (h/2) * scaleFactor * as);
-    pPostProcessShader->SetUniform2f("ScaleIn", (2/w),               (2/h) / as);
+    pPostProcessShader->SetUniform2f(UniformHandle::Literal("Scale"),   (w/2) * scaleFactor, (h/2) * scaleFactor * as);
+    pPostProcessShader->SetUniform2f(UniformHandle::Literal("ScaleIn"), (2/w),               (2/h) / as);
 
-    pPostProcessShader->SetUniform4f("HmdWarpParam",
+    pPostProcessShader->SetUniform4f(UniformHandle::Literal("HmdWarpParam"),
                                      Distortion.K[0], Distortion.K[1], Distortion.K[2], Distortion.K[3]);
     Matrix4f texm(w, 0, 0, x,
                   0, h, 0, y,
                   0, 0, 0, 0,
                   0, 0, 0, 1);
-    pPostProcessShader->SetUniform4x4f("Texm", texm);
+    pPostProcessShader->SetUniform4x4f(UniformHandle::Literal("Texm"), texm);
 
     Matrix4f view(2, 0, 0, -1,
                   0, 2, 0, -1,
@@ -776,83 +1311,48 @@ void RenderDevice::FinishScene1()
     Render(&fill, pFullScreenVertexBuffer, NULL, view, 0, 4, Prim_TriangleStrip);
 }
 
-bool CollisionModel::TestPoint(const Vector3f& p) const
+TextureData::~TextureData()
 {
-    for(unsigned i = 0; i < Planes.GetSize(); i++)
-        if(Planes[i].TestSide(p) > 0)
-        {
-            return 0;
-        }
-
-    return 1;
+    SetData(NULL);
 }
 
-bool CollisionModel::TestRay(const Vector3f& origin, const Vector3f& norm, float& len, Planef* ph) const
+void TextureData::SetData(UByte* data)
 {
-    if(TestPoint(origin))
+    if (pMapping)
     {
-        len = 0;
-        *ph = Planes[0];
-        return true;
+        delete pMapping;
+        pMapping = NULL;
     }
-    Vector3f fullMove = origin + norm * len;
-
-    int crossing = -1;
-    float cdot1 = 0, cdot2 = 0;
-
-    for(unsigned i = 0; i < Planes.GetSize(); ++i)
+    else if (pData)
     {
-        float dot2 = Planes[i].TestSide(fullMove);
-        if(dot2 > 0)
-        {
-            return false;
-        }
-        float dot1 = Planes[i].TestSide(origin);
-        if(dot1 > 0)
-        {
-            if(dot2 <= 0)
-            {
-                //assert(crossing==-1);
-				if(crossing == -1)
-				{
-					crossing = i;
-					cdot2 = dot2;
-					cdot1 = dot1;
-				}
-				else
-				{
-					if(dot2 > cdot2)
-					{
-						crossing = i;
-						cdot2 = dot2;
-						cdot1 = dot1;
-					}
-				}
-            }
-        }
+        OVR_FREE(pData);
     }
+    pData = data;
+}
 
-    if(crossing < 0)
+Texture* TextureData::CreateTexture(RenderDevice* ren) const
+{
+    Texture* out = ren->CreateTexture(Format, Width, Height, pData, MipCount);
+    if (out && Clamp)
     {
-        return false;
+        out->SetSampleMode(Sample_Clamp);
     }
+    return out;
+}
 
-    assert(TestPoint(origin + norm * len));
-
-    len = len * cdot1 / (cdot1 - cdot2) - 0.05f;
-    if(len < 0)
+void TextureData::GenerateMipmaps(int flags, WorkerPool* pWorkers)
+{
+    if (Format != (Texture_RGBA | Texture_GenMipmaps) || !pData)
     {
-        len = 0;
+        return;
     }
-    float tp = Planes[crossing].TestSide(origin + norm * len);
-    OVR_ASSERT(fabsf(tp) < 0.05f + Mathf::Tolerance);
-    OVR_UNUSED(tp);
 
-    if(ph)
-    {
-        *ph = Planes[crossing];
-    }
-    return true;
+    UByte* chain = (UByte*)OVR_ALLOC(GetMipChainSize(Width, Height));
+    BuildMipChain(pData, Width, Height, chain, flags, pWorkers);
+
+    SetData(chain);
+    Format   = Texture_RGBA;
+    MipCount = GetNumMipLevels(Width, Height);
 }
 
 int GetNumMipLevels(int w, int h)
@@ -867,23 +1367,6 @@ int GetNumMipLevels(int w, int h)
     return n;
 }
 
-void FilterRgba2x2(const UByte* src, int w, int h, UByte* dest)
-{
-    for(int j = 0; j < (h & ~1); j += 2)
-    {
-        const UByte* psrc = src + (w * j * 4);
-        UByte*       pdest = dest + ((w >> 1) * (j >> 1) * 4);
-
-        for(int i = 0; i < w >> 1; i++, psrc += 8, pdest += 4)
-        {
-            pdest[0] = (((int)psrc[0]) + psrc[4] + psrc[w * 4 + 0] + psrc[w * 4 + 4]) >> 2;
-            pdest[1] = (((int)psrc[1]) + psrc[5] + psrc[w * 4 + 1] + psrc[w * 4 + 5]) >> 2;
-            pdest[2] = (((int)psrc[2]) + psrc[6] + psrc[w * 4 + 2] + psrc[w * 4 + 6]) >> 2;
-            pdest[3] = (((int)psrc[3]) + psrc[7] + psrc[w * 4 + 3] + psrc[w * 4 + 7]) >> 2;
-        }
-    }
-}
-
 int GetTextureSize(int format, int w, int h)
 {
     switch (format & Texture_TypeMask)
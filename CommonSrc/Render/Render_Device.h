@@ -37,6 +37,7 @@ namespace OVR { namespace Render {
 using namespace OVR::Util::Render;
 
 class RenderDevice;
+class RenderQueue;
 
 //-----------------------------------------------------------------------------------
 
@@ -156,6 +157,50 @@ struct Vector4f : public Vector3f
 };
 
 
+// FNV-1a hash of the first I characters of a string literal, unrolled so that
+// the compiler folds it to a constant.
+template<UPInt N, UPInt I>
+struct UniformNameHash
+{
+    static OVR_FORCE_INLINE UInt32 Hash(const char (&name)[N])
+    {
+        return (UniformNameHash<N, I - 1>::Hash(name) ^ (UByte)name[I - 1]) * 16777619u;
+    }
+};
+
+template<UPInt N>
+struct UniformNameHash<N, 0>
+{
+    static OVR_FORCE_INLINE UInt32 Hash(const char (&)[N]) { return 2166136261u; }
+};
+
+// A uniform name resolved once, so that per-frame SetUniform calls compare integers
+// rather than strings. Builtin names written as literals use UniformHandle::Literal,
+// which costs nothing at run time; other names are hashed by the constructor.
+struct UniformHandle
+{
+    UInt32 Hash;
+
+    UniformHandle() : Hash(0) { }
+    explicit UniformHandle(const char* name) : Hash(2166136261u)
+    {
+        while (*name)
+            Hash = (Hash ^ (UByte)*name++) * 16777619u;
+    }
+
+    template<UPInt N>
+    static UniformHandle Literal(const char (&name)[N])
+    {
+        UniformHandle h;
+        h.Hash = UniformNameHash<N, N - 1>::Hash(name);
+        return h;
+    }
+
+    bool operator==(const UniformHandle& b) const { return Hash == b.Hash; }
+    bool operator!=(const UniformHandle& b) const { return Hash != b.Hash; }
+};
+
+
 class Shader : public RefCountBase<Shader>
 {
     friend class ShaderSet;
@@ -175,6 +220,7 @@ public:
 
 protected:
     virtual bool SetUniform(const char* name, int n, const float* v) { OVR_UNUSED3(name, n, v); return false; }
+    virtual bool SetUniform(UniformHandle h, int n, const float* v) { OVR_UNUSED3(h, n, v); return false; }
 };
 
 
@@ -210,6 +256,8 @@ public:
     // Set a uniform (other than the standard matrices). It is undefined whether the
     // uniforms from one shader occupy the same space as those in other shaders
     // (unless a buffer is used, then each buffer is independent).     
+    // The name versions look the uniform up by string; per-frame code should
+    // pass a UniformHandle instead.
     virtual bool SetUniform(const char* name, int n, const float* v)
     {
         bool result = 0;
@@ -219,6 +267,15 @@ public:
 
         return result;
     }
+    virtual bool SetUniform(UniformHandle h, int n, const float* v)
+    {
+        bool result = 0;
+        for (int i = 0; i < Shader_Count; i++)
+            if (Shaders[i])
+                result |= Shaders[i]->SetUniform(h, n, v);
+
+        return result;
+    }
     bool SetUniform1f(const char* name, float x)
     {
         const float v[] = {x};
@@ -247,6 +304,35 @@ public:
     {
         return SetUniform(name, 16, &m.M[0][0]);
     }
+
+    bool SetUniform1f(UniformHandle h, float x)
+    {
+        const float v[] = {x};
+        return SetUniform(h, 1, v);
+    }
+    bool SetUniform2f(UniformHandle h, float x, float y)
+    {
+        const float v[] = {x,y};
+        return SetUniform(h, 2, v);
+    }
+    bool SetUniform4f(UniformHandle h, float x, float y, float z, float w = 1)
+    {
+        const float v[] = {x,y,z,w};
+        return SetUniform(h, 4, v);
+    }
+    bool SetUniformv(UniformHandle h, const Vector3f& v)
+    {
+        const float a[] = {v.x,v.y,v.z,1};
+        return SetUniform(h, 4, a);
+    }
+    bool SetUniform4fv(UniformHandle h, int n, const Vector4f* v)
+    {
+        return SetUniform(h, 4*n, &v[0].x);
+    }
+    virtual bool SetUniform4x4f(UniformHandle h, const Matrix4f& m)
+    {
+        return SetUniform(h, 16, &m.M[0][0]);
+    }
 };
 
 class ShaderSetMatrixTranspose : public ShaderSet
@@ -257,6 +343,11 @@ public:
         Matrix4f mt = m.Transposed();
         return SetUniform(name, 16, &mt.M[0][0]);
     }
+    virtual bool SetUniform4x4f(UniformHandle h, const Matrix4f& m)
+    {
+        Matrix4f mt = m.Transposed();
+        return SetUniform(h, 16, &mt.M[0][0]);
+    }
 };
 
 class ShaderFill : public Fill
@@ -268,7 +359,8 @@ public:
     ShaderFill(ShaderSet* sh) : Shaders(sh) {  }
     ShaderFill(ShaderSet& sh) : Shaders(sh) {  }
     void Set(PrimitiveType prim) const;
-    ShaderSet* GetShaders() { return Shaders; }
+    ShaderSet* GetShaders() const { return Shaders; }
+    Texture*   GetTexture(int i) const { return Textures[i]; }
 
     virtual void SetTexture(int i, class Texture* tex) { if (i < 8) Textures[i] = tex; }
 };
@@ -316,21 +408,111 @@ public:
 
 //-----------------------------------------------------------------------------------
 
+// One ray of a CollisionModel::TestRays batch; the fields match the arguments of TestRay.
+struct CollisionRay
+{
+    Vector3f Origin;
+    Vector3f Norm;
+    float    Length;    // Shortened on each hit, as len is by TestRay.
+    Planef   Plane;     // Plane of the last hit.
+    bool     Hit;       // Set on a hit and never cleared, so a batch can go through several models.
+
+    CollisionRay() : Length(0), Hit(false) { }
+    CollisionRay(const Vector3f& origin, const Vector3f& norm, float length)
+        : Origin(origin), Norm(norm), Length(length), Hit(false) { }
+};
+
+// Ray test implementation; Auto picks the fastest the CPU supports, and a path
+// that isn't available falls back to the next one down. All give the same results.
+enum CollisionKernelPath
+{
+    CollisionKernel_Auto,
+    CollisionKernel_Scalar,
+    CollisionKernel_SSE2,
+    CollisionKernel_AVX2
+};
+
+// Queries made of all CollisionModels since CollisionModel::ResetQueryStats.
+// PlaneTests counts the planes of every model queried, which is what a query costs
+// at most; early outs make it less.
+struct CollisionQueryStats
+{
+    UInt32 RayTests;
+    UInt32 PointTests;
+    UInt32 SweepTests;
+    UInt32 PlaneTests;
+
+    CollisionQueryStats() : RayTests(0), PointTests(0), SweepTests(0), PlaneTests(0) { }
+};
+
 class CollisionModel : public RefCountBase<CollisionModel>
 {
 public:
 	Array<Planef > Planes;
 
-	void Add(const Planef& p)
-	{
-		Planes.PushBack(p);
-	}
+    // Box around the space inside the planes, padded for rounding, which TestPoint
+    // and TestRays check first. Only set by Optimize; Add clears HasBounds.
+    Vector3f       BoundsMin, BoundsMax;
+    bool           HasBounds;
+
+    // Planes in groups of PlaneBlockSize, as PlaneBlockSize N.x values, then N.y, N.z
+    // and D. The last group is padded with planes that every point is inside of.
+    enum { PlaneBlockSize = 8 };
+    Array<float>   PlaneBlocks;
+
+    CollisionModel() : HasBounds(false) { }
+
+	void Add(const Planef& p);
+
+    // Load-time pass: drops duplicate planes, puts the planes that reject most of
+    // the bounding box first, and sets the bounds. Inside and outside are unchanged.
+    void Optimize();
+
+    // Bounds of the space inside the planes, padded for rounding; the stored ones
+    // if HasBounds. Returns false if the model is unbounded or degenerate.
+    bool GetBounds(Vector3f* boundsMin, Vector3f* boundsMax) const;
 
 	// Return whether p is inside this
 	bool TestPoint(const Vector3f& p) const;
 
 	// Assumes that the origin of the ray is outside this.
 	bool TestRay(const Vector3f& origin, const Vector3f& norm, float& len, Planef* ph = NULL) const;
+
+    // TestRay for each ray, with all of them run against every plane in one pass.
+    // Returns the number of rays that hit.
+    int  TestRays(CollisionRay* rays, UPInt count, CollisionKernelPath path = CollisionKernel_Auto) const;
+
+    // Query counts are shared by all models and not synchronized; collision is
+    // only queried from one thread at a time. Sweeps are done outside this class
+    // (see CapsuleController) and counted with AddSweepStats.
+    static const CollisionQueryStats& GetQueryStats() { return QueryStats; }
+    static void ResetQueryStats()                      { QueryStats = CollisionQueryStats(); }
+    static void AddSweepStats(UPInt sweeps, UPInt planes)
+    {
+        QueryStats.SweepTests += (UInt32)sweeps;
+        QueryStats.PlaneTests += (UInt32)planes;
+    }
+
+private:
+    static CollisionQueryStats QueryStats;
+};
+
+// Frustum planes of a model-view-projection matrix, in the space the matrix
+// transforms from; normals point inside. The near plane allows both the D3D and
+// GL clip depth ranges, so culling is never too tight.
+struct Frustum
+{
+    Planef Planes[6];
+
+    Frustum(const Matrix4f& mvp);
+
+    // True if the sphere or box is entirely outside one of the planes.
+    bool CullsSphere(const Vector3f& center, float radius) const;
+    bool CullsBox(const Vector3f& boxMin, const Vector3f& boxMax) const;
+    bool CullsBounds(const Vector3f& center, float radius, const Vector3f& boxMin, const Vector3f& boxMax) const
+    {
+        return CullsSphere(center, radius) || CullsBox(boxMin, boxMax);
+    }
 };
 
 class Node : public RefCountBase<Node>
@@ -341,8 +523,23 @@ class Node : public RefCountBase<Node>
     mutable Matrix4f  Mat;
 	mutable bool      MatCurrent;
 
+    friend class Container;
+
+    // Container the node was last added to, for passing changes up.
+    Node*        Parent;
+    int          DirtyFlags;
+
 public:
-    Node() : Pos(Vector3f(0)), MatCurrent(1) { }
+    // What changed since the world matrices of the containers above were updated.
+    enum DirtyFlagBits
+    {
+        Dirty_Matrix    = 1,    // The node's own transform.
+        Dirty_Children  = 2,    // The transform of a node below it.
+        Dirty_Structure = 4,    // Nodes added to or removed from a container below it.
+        Dirty_Record    = 8     // Draw state a RenderList copies: fill, visibility, bounds, buffers.
+    };
+
+    Node() : Pos(Vector3f(0)), MatCurrent(1), Parent(NULL), DirtyFlags(Dirty_Matrix) { }
     virtual ~Node() { }
 
     enum NodeType
@@ -357,11 +554,11 @@ public:
 
     const Vector3f&  GetPosition() const      { return Pos; }
     const Quatf&     GetOrientation() const   { return Rot; }
-    void             SetPosition(Vector3f p)  { Pos = p; MatCurrent = 0; }
-    void             SetOrientation(Quatf q)  { Rot = q; MatCurrent = 0; }
+    void             SetPosition(Vector3f p)  { Pos = p; MatCurrent = 0; MarkDirty(Dirty_Matrix); }
+    void             SetOrientation(Quatf q)  { Rot = q; MatCurrent = 0; MarkDirty(Dirty_Matrix); }
 
-    void             Move(Vector3f p)         { Pos += p; MatCurrent = 0; }
-    void             Rotate(Quatf q)          { Rot = q * Rot; MatCurrent = 0; }
+    void             Move(Vector3f p)         { Pos += p; MatCurrent = 0; MarkDirty(Dirty_Matrix); }
+    void             Rotate(Quatf q)          { Rot = q * Rot; MatCurrent = 0; MarkDirty(Dirty_Matrix); }
 
 
     // For testing only; causes Position an Orientation
@@ -369,8 +566,13 @@ public:
     {
         MatCurrent = true;
         Mat = m;        
+        MarkDirty(Dirty_Matrix);
     }
 
+    // Sets flags on the node and the matching Dirty_Children or Dirty_Structure on
+    // the containers above it.
+    void             MarkDirty(int flags);
+
 
     const Matrix4f&  GetMatrix() const 
     {
@@ -384,6 +586,14 @@ public:
     }
 
 	virtual void     Render(const Matrix4f& ltw, RenderDevice* ren) { OVR_UNUSED2(ltw, ren); }
+
+    // Adds the node's draws to queue instead of drawing them. Nodes that can't be
+    // queued draw right away.
+    virtual void     Collect(const Matrix4f& ltw, RenderDevice* ren, RenderQueue* queue)
+    {
+        OVR_UNUSED(queue);
+        Render(ltw, ren);
+    }
 };
 
 struct Vertex
@@ -443,22 +653,47 @@ public:
     Ptr<Buffer>       VertexBuffer;
     Ptr<Buffer>       IndexBuffer;
 
-    Model(PrimitiveType t = Prim_Triangles) : Type(t), Fill(NULL), Visible(true) { }
+    // Index of the model in the RenderList of the container it is drawn from.
+    UPInt             FlatIndex;
+
+    // Model space bounds of Vertices, set by ComputeBounds; Render skips the model
+    // when they are outside the view frustum. Models without bounds are always drawn.
+    Vector3f          BoundsMin, BoundsMax;
+    Vector3f          BoundsCenter;
+    float             BoundsRadius;
+    bool              HasBounds;
+
+    Model(PrimitiveType t = Prim_Triangles)
+        : Type(t), Fill(NULL), Visible(true), FlatIndex(0), BoundsRadius(0), HasBounds(false) { }
     ~Model() { }
 
     virtual NodeType GetType() const { return Node_Model; }
 
     virtual void Render(const Matrix4f& ltw, RenderDevice* ren);
+    virtual void Collect(const Matrix4f& ltw, RenderDevice* ren, RenderQueue* queue);
+
+    // Adds the model to the draw stats of ren; returns true if the model, with the
+    // model-view matrix m, is outside the view frustum.
+    bool Cull(const Matrix4f& m, RenderDevice* ren) const;
+    // True if the bounds are outside the frustum of the model-view-projection mvp.
+    bool IsOutside(const Matrix4f& mvp) const;
 
     PrimitiveType GetPrimType() const { return Type; }
 
-    void SetVisible(bool visible) { Visible = visible; }
+    // Fill and Visible can be set directly until the model is added to a container;
+    // after that, use these so the container's RenderList sees the change.
+    void SetVisible(bool visible) { Visible = visible; MarkDirty(Dirty_Record); }
     bool IsVisible() const        { return Visible; }
+    void SetFill(class Fill* fill) { Fill = fill; MarkDirty(Dirty_Record); }
+
+    // Computes the bounding box and sphere of Vertices; call again if they change.
+    void ComputeBounds();
 
     void ClearRenderer()
     {
         VertexBuffer.Clear();
         IndexBuffer.Clear();
+        MarkDirty(Dirty_Record);
     }
 
     // Returns the index next added vertex will have.
@@ -536,6 +771,53 @@ public:
 							 Color minor = Color(64,64,64,192), Color major = Color(128,128,128,192));
 };
 
+// Draw records of models as structure-of-arrays, so the per-view loops read each
+// array front to back instead of following node pointers. Buffers are picked up
+// from the model once a device has created them.
+class RenderList
+{
+public:
+    enum RecordFlags
+    {
+        Record_Visible   = 1,
+        Record_HasBounds = 2
+    };
+
+    Array<Model*>        Models;
+    Array<Matrix4f>      Worlds;
+    Array<Vector4f>      Spheres;        // Model space bounds center and radius.
+    Array<Vector3f>      BoxMins, BoxMaxs;
+    Array<UInt16>        FillIds;        // Index in Fills.
+    Array<Buffer*>       VertexBuffers;  // NULL until the model is first drawn.
+    Array<Buffer*>       IndexBuffers;
+    Array<int>           IndexCounts;
+    Array<UByte>         Prims;
+    Array<UByte>         Flags;
+    Array<Fill*>         Fills;          // Each fill once.
+
+    UPInt  GetSize() const { return Models.GetSize(); }
+    void   Clear();
+
+    // Appends a record of model with the world matrix world.
+    void   Add(Model* model, const Matrix4f& world);
+    // Copies the draw state of the model back into record i.
+    void   Refresh(UPInt i);
+
+    // Culls and draws the records with the view matrix view.
+    void   Render(const Matrix4f& view, RenderDevice* ren);
+    // Adds the visible records to queue with the view matrix view.
+    void   Collect(const Matrix4f& view, RenderQueue* queue);
+
+private:
+    UInt16 GetFillId(Fill* fill);
+};
+
+// A container keeps draw records of the models below it, with world matrices
+// relative to its parent, in a RenderList that Render and Collect walk instead of
+// the tree. Only the matrices below a node that was moved are recomputed, and the
+// list is rebuilt when nodes are added or removed. A model can be in only one
+// container tree, the tree should be drawn from its root, and nodes should be
+// added with Add.
 class Container : public Node
 {
 public:
@@ -543,7 +825,7 @@ public:
 
     ~Container()
     {
-
+        ReleaseChildren();
     }
 
     void ClearRenderer()
@@ -555,14 +837,92 @@ public:
     virtual NodeType GetType() const { return Node_Container; }
 
     virtual void Render(const Matrix4f& ltw, RenderDevice* ren);
+    virtual void Collect(const Matrix4f& ltw, RenderDevice* ren, RenderQueue* queue);
 
-    void Add(Node *n) { Nodes.PushBack(n); }
-	void Add(Model *n, class Fill *f) { n->Fill = f; Nodes.PushBack(n); }
-	void Clear() { Nodes.Clear(); }
+    void Add(Node *n);
+	void Add(Model *n, class Fill *f) { n->Fill = f; Add(n); }
+	void Clear() { ReleaseChildren(); Nodes.Clear(); MarkDirty(Dirty_Structure); }
+
+    // Brings the render list up to date with the tree; Render and Collect call this.
+    void                     UpdateWorldMatrices();
+    const RenderList&        GetRenderList() const { return List; }
 
 	bool               CollideChildren;
 
-	Container() : CollideChildren(1) {}
+	Container() : CollideChildren(1) { DirtyFlags |= Dirty_Structure; }
+
+private:
+    RenderList         List;
+    // World matrix in the space of the container being flattened's parent.
+    Matrix4f           WorldMatrix;
+
+    void ReleaseChildren();
+    void FlattenChildren(Container* root, const Matrix4f& world, bool rebuild, bool force);
+};
+
+// Model draws of one view, sorted so that consecutive draws share as much state
+// as possible: by shaders, then by texture, then front to back. The same queue
+// can be drawn from several nearby views, such as the two eyes, by culling it
+// against all of them and offsetting the matrices when it is submitted.
+class RenderQueue
+{
+public:
+    struct Item
+    {
+        Model*        pModel;
+        Matrix4f      Matrix;
+        const Fill*   pFill;
+        // NULL to draw through RenderDevice::Render(matrix, model), which creates them.
+        Buffer*       VertexBuffer;
+        Buffer*       IndexBuffer;
+        int           IndexCount;
+        PrimitiveType Prim;
+    };
+
+    RenderQueue() : Culled(0), StateChangesSaved(0) { }
+
+    // Removes the draws and the cull views.
+    void   Clear();
+
+    // Adds a projection, from the space of the queued model-view matrices, to cull
+    // with. A model is culled when it is outside the frustums of all of them.
+    void   AddCullView(const Matrix4f& proj);
+
+    // Queues model with the model-view matrix m, unless it is culled.
+    void   Add(Model* model, const Matrix4f& m);
+    // Queues record i of list with the model-view matrix m, unless it is culled.
+    void   Add(const RenderList& list, UPInt i, const Matrix4f& m);
+
+    // Sorts the queued draws, and counts the state changes saved over drawing
+    // them in the order they were added.
+    void   Sort();
+
+    // Draws the queue in order, adding the draws, culled models and saved state
+    // changes to the draw stats. viewAdjust, if given, is applied to the queued
+    // model-view matrices, as StereoEyeParams::ViewAdjust is to the view.
+    void   Submit(RenderDevice* ren, const Matrix4f* viewAdjust = NULL);
+
+    UPInt       GetSize() const            { return Items.GetSize(); }
+    int         GetCulled() const          { return Culled; }
+    const Item& GetItem(UPInt i) const     { return Items[i]; }
+    int         GetStateChangesSaved() const { return StateChangesSaved; }
+
+    // Shader and texture binds between draws in the given order.
+    int    CountStateChanges(bool sorted) const;
+
+private:
+    Array<Item>          Items;
+    // Sort keys: vertex and pixel shader ids, texture id, depth and the index of
+    // the item, from high to low bits. Ids are given in order of first use.
+    Array<UInt64>        Keys;
+    Array<const void*>   ShaderIds[2], TextureIds;
+    Array<Matrix4f>      CullViews;
+    int                  Culled;
+    int                  StateChangesSaved;
+
+    UInt64 GetId(Array<const void*>* ids, const void* p, UInt64 maxId);
+    void   AddItem(const Item& item, const Vector4f& sphere, const Vector3f& boxMin,
+                   const Vector3f& boxMax, bool hasBounds);
 };
 
 class Scene
@@ -572,10 +932,23 @@ public:
     Vector4f			LightPos[8];
     LightingParams		Lighting;
 	Array<Ptr<Model> >	Models;
+    // Draws World through Queue, sorted by state; otherwise in file order.
+    bool                SortDraws;
+    RenderQueue         Queue;
+    Matrix4f            QueueView;
 
 public:
+    Scene() : SortDraws(true) { }
+
     void Render(RenderDevice* ren, const Matrix4f& view);
 
+    // Single pass stereo: CollectStereo traverses, culls and sorts World once for
+    // both eyes, with view the matrix between them; RenderEye then draws the queue
+    // for one eye, in place of Render with eye.ViewAdjust * view.
+    void CollectStereo(RenderDevice* ren, const Matrix4f& view,
+                       const StereoEyeParams& left, const StereoEyeParams& right);
+    void RenderEye(RenderDevice* ren, const StereoEyeParams& eye);
+
     void SetAmbient(Vector4f color)
     {
         Lighting.Ambient = color;
@@ -681,6 +1054,12 @@ protected:
     Color           DistortionClearColor;
     UPInt			TotalTextureMemoryUsage;
 
+    // Model::Render draw counts since the last ResetDrawStats.
+    int             DrawsSubmitted;
+    int             DrawsCulled;
+    int             StateChangesSaved;
+    UPInt           UniformBytesUploaded;
+
     // For lighting on platforms with uniform buffers
     Ptr<Buffer>     LightingBuffer;
 
@@ -828,6 +1207,18 @@ public:
     {
         return TotalTextureMemoryUsage;
     }
+
+    // Models drawn and skipped by frustum culling, shader and texture binds
+    // saved by RenderQueue sorting, and bytes of shader uniforms the device
+    // uploaded; the application resets these once per frame.
+    int   GetDrawsSubmitted() const  { return DrawsSubmitted; }
+    int   GetDrawsCulled() const     { return DrawsCulled; }
+    int   GetStateChangesSaved() const { return StateChangesSaved; }
+    UPInt GetUniformBytesUploaded() const { return UniformBytesUploaded; }
+    void  ResetDrawStats()           { DrawsSubmitted = DrawsCulled = StateChangesSaved = 0; UniformBytesUploaded = 0; }
+    void  AddDrawStats(int submitted, int culled) { DrawsSubmitted += submitted; DrawsCulled += culled; }
+    void  AddStateChangesSaved(int saved) { StateChangesSaved += saved; }
+    void  AddUniformBytesUploaded(UPInt bytes) { UniformBytesUploaded += bytes; }
     
 protected:
     // Stereo & post-processing
@@ -840,9 +1231,95 @@ protected:
 int GetNumMipLevels(int w, int h);
 int GetTextureSize(int format, int w, int h);
 
-// Filter an rgba image with a 2x2 box filter, for mipmaps.
-// Image size must be a power of 2.
-void FilterRgba2x2(const UByte* src, int w, int h, UByte* dest);
+class WorkerPool;
+class MappedFile;
+
+enum MipFilterFlags
+{
+    MipFilter_SRGB          = 0x1,  // Average color in linear space; alpha is always linear.
+};
+
+// Mip filter implementation; Auto picks the fastest the CPU supports, and a path
+// that isn't available falls back to the next one down.
+enum MipFilterPath
+{
+    MipFilterPath_Auto,
+    MipFilterPath_Scalar,
+    MipFilterPath_SSE2,
+    MipFilterPath_AVX2
+};
+
+// Size of a complete rgba mip chain down to 1x1, levels stored back to back.
+int GetMipChainSize(int w, int h);
+
+// Filter an rgba image with a box filter, for mipmaps. The result is
+// max(w/2,1) x max(h/2,1); odd dimensions use a 3-texel filter so no texels
+// are dropped. All paths produce identical results.
+void FilterRgba2x2(const UByte* src, int w, int h, UByte* dest,
+                   int flags = 0, MipFilterPath path = MipFilterPath_Auto);
+
+// Builds a complete mip chain of an rgba image into dest, which must hold
+// GetMipChainSize(w, h) bytes; level 0 is copied from src unless src == dest.
+// Large levels are split across pWorkers, so this must not be called from
+// one of its jobs.
+void BuildMipChain(const UByte* src, int w, int h, UByte* dest, int flags = 0,
+                   WorkerPool* pWorkers = NULL, MipFilterPath path = MipFilterPath_Auto);
+
+// Block compression quality, from fastest to best.
+enum TextureCompression
+{
+    TextureCompress_None,
+    TextureCompress_Fast,       // Bounding box endpoints, one least-squares refinement.
+    TextureCompress_Normal,     // Best of bounding box and principal axis endpoints.
+    TextureCompress_High        // As Normal, refined until the error stops improving.
+};
+
+// Texture_DXT5 if any pixel of the rgba image has alpha below 255, Texture_DXT1 otherwise.
+int  ChooseBlockFormat(const UByte* rgba, int w, int h);
+
+// Compresses a w x h rgba image to Texture_DXT1 (BC1) or Texture_DXT5 (BC3) blocks;
+// dest must hold GetTextureSize(format, w, h) bytes. Partial blocks at the right and
+// bottom repeat the edge pixels. Rows of blocks are split across pWorkers if given.
+void CompressRgbaBlocks(const UByte* rgba, int w, int h, UByte* dest, int format,
+                        TextureCompression quality, WorkerPool* pWorkers = NULL);
+
+// Decodes Texture_DXT1 or Texture_DXT5 blocks to a w x h rgba image.
+void DecompressBlocks(const UByte* src, int w, int h, int format, UByte* rgba);
+
+// Texture file contents decoded into memory, ready for RenderDevice::CreateTexture.
+// Decoding makes no renderer calls, so it can be done on a loader thread.
+class TextureData : public RefCountBase<TextureData>
+{
+public:
+    int     Format;     // Texture_RGBA|Texture_GenMipmaps, Texture_RGBA, Texture_DXT1 or Texture_DXT5.
+    int     Width, Height;
+    int     MipCount;
+    bool    Clamp;      // File name contains "_c.", sample with Sample_Clamp.
+    UByte*  pData;
+    // If set, pData points into this mapping (a TextureCache entry) instead of
+    // being allocated with OVR_ALLOC.
+    MappedFile* pMapping;
+
+    TextureData() : Format(0), Width(0), Height(0), MipCount(1), Clamp(false), pData(NULL), pMapping(NULL) { }
+    ~TextureData();
+
+    // Replaces Texture_GenMipmaps data with a complete mip chain, so the
+    // renderer doesn't have to build it when the texture is created.
+    void     GenerateMipmaps(int flags = 0, WorkerPool* pWorkers = NULL);
+
+    // Converts Texture_RGBA data with all of its mips to Texture_DXT1, or to Texture_DXT5
+    // if alpha is used. Returns false and leaves the data alone if it isn't Texture_RGBA
+    // or its size isn't a multiple of 4.
+    bool     Compress(TextureCompression quality, WorkerPool* pWorkers = NULL);
+
+    // Replaces pData with data allocated with OVR_ALLOC, releasing the old data.
+    void     SetData(UByte* data);
+
+    Texture* CreateTexture(RenderDevice* ren) const;
+};
+
+TextureData* LoadTextureDataTga(File* f);
+TextureData* LoadTextureDataDDS(File* f);
 
 Texture* LoadTextureTga(RenderDevice* ren, File* f);
 Texture* LoadTextureDDS(RenderDevice* ren, File* f);
@@ -0,0 +1,319 @@
+/************************************************************************************
+
+Filename    :   Render_GroundGrid.cpp
+Content     :   XZ grid and baked heightfield over ground collision models
+Created     :   October 17, 2026
+Authors     :
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************************/
+
+#include "Render_GroundGrid.h"
+#include "Render_CollisionTree.h"
+
+#include <math.h>
+#include <string.h>
+
+namespace OVR { namespace Render {
+
+// Heightfield samples are limited to this many per axis; the spacing grows to fit.
+static const int   MaxHeightfieldSamples = 4096;
+static const float NoGround = -1.0e30f;
+
+const float GroundHeightfield::MaxStep = 0.05f;
+// Planar ground meets the corners' average exactly at a cell's centre.
+static const float CenterTolerance = 0.01f;
+
+// Cell coordinate along one axis. Subtraction, division and floor never decrease,
+// so a point inside a model's bounds always lands in a cell the model is listed in.
+static inline int GetCellCoord(float v, float gridMin, float cellSize, int cells)
+{
+    int c = (int)floorf((v - gridMin) / cellSize);
+    return Alg::Max(0, Alg::Min(cells - 1, c));
+}
+
+void GroundGrid::Clear()
+{
+    Models.Clear();
+    UnboundedModels.Clear();
+    CellStart.Clear();
+    CellModels.Clear();
+    CellsX = CellsZ = 0;
+}
+
+void GroundGrid::Build(const Array<Ptr<CollisionModel> >& models, float cellSize)
+{
+    Clear();
+    Models = models;
+
+    Array<Vector3f> modelMin, modelMax;
+    Array<UInt32>   boundedModels;
+    modelMin.Resize(models.GetSize());
+    modelMax.Resize(models.GetSize());
+
+    for (UPInt i = 0; i < models.GetSize(); i++)
+    {
+        if (!models[i]->GetBounds(&modelMin[i], &modelMax[i]))
+        {
+            UnboundedModels.PushBack((UInt32)i);
+            continue;
+        }
+
+        if (boundedModels.GetSize() == 0)
+        {
+            BoundsMin = modelMin[i];
+            BoundsMax = modelMax[i];
+        }
+        BoundsMin.x = Alg::Min(BoundsMin.x, modelMin[i].x);
+        BoundsMin.y = Alg::Min(BoundsMin.y, modelMin[i].y);
+        BoundsMin.z = Alg::Min(BoundsMin.z, modelMin[i].z);
+        BoundsMax.x = Alg::Max(BoundsMax.x, modelMax[i].x);
+        BoundsMax.y = Alg::Max(BoundsMax.y, modelMax[i].y);
+        BoundsMax.z = Alg::Max(BoundsMax.z, modelMax[i].z);
+        boundedModels.PushBack((UInt32)i);
+    }
+
+    if (boundedModels.GetSize() == 0)
+    {
+        return;
+    }
+
+    float sizeX = BoundsMax.x - BoundsMin.x;
+    float sizeZ = BoundsMax.z - BoundsMin.z;
+    CellSize = Alg::Max(cellSize, Alg::Max(sizeX, sizeZ) / (MaxCellsPerAxis - 1));
+    CellsX   = Alg::Min((int)MaxCellsPerAxis, (int)(sizeX / CellSize) + 1);
+    CellsZ   = Alg::Min((int)MaxCellsPerAxis, (int)(sizeZ / CellSize) + 1);
+
+    // Count the models per cell, turn the counts into start offsets, then fill
+    // the cells in model order so each list stays sorted.
+    CellStart.Resize(CellsX * CellsZ + 1);
+    memset(&CellStart[0], 0, CellStart.GetSize() * sizeof(UInt32));
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        for (UPInt b = 0; b < boundedModels.GetSize(); b++)
+        {
+            UInt32 model = boundedModels[b];
+            int    x0 = GetCellCoord(modelMin[model].x, BoundsMin.x, CellSize, CellsX);
+            int    x1 = GetCellCoord(modelMax[model].x, BoundsMin.x, CellSize, CellsX);
+            int    z0 = GetCellCoord(modelMin[model].z, BoundsMin.z, CellSize, CellsZ);
+            int    z1 = GetCellCoord(modelMax[model].z, BoundsMin.z, CellSize, CellsZ);
+
+            for (int z = z0; z <= z1; z++)
+            {
+                for (int x = x0; x <= x1; x++)
+                {
+                    UInt32& cell = CellStart[z * CellsX + x + pass];
+                    if (pass == 0)
+                        cell++;
+                    else
+                        CellModels[cell++] = model;
+                }
+            }
+        }
+
+        if (pass == 0)
+        {
+            // Shifted by one, so that the fill pass leaves each entry at the start
+            // of its own cell.
+            UInt32 total = 0;
+            for (UPInt i = 0; i < CellStart.GetSize(); i++)
+            {
+                UInt32 count = CellStart[i];
+                CellStart[i] = total;
+                total += count;
+            }
+            CellModels.Resize(total);
+            for (UPInt i = CellStart.GetSize() - 1; i > 0; i--)
+            {
+                CellStart[i] = CellStart[i - 1];
+            }
+            CellStart[0] = 0;
+        }
+    }
+}
+
+bool GroundGrid::GetBounds(Vector3f* boundsMin, Vector3f* boundsMax) const
+{
+    if (CellsX == 0)
+    {
+        return false;
+    }
+    *boundsMin = BoundsMin;
+    *boundsMax = BoundsMax;
+    return true;
+}
+
+bool GroundGrid::TestRayDown(const Vector3f& origin, float& len, Planef* ph) const
+{
+    // Only models whose footprint covers origin can hold either end of the ray.
+    const UInt32* cellModels = NULL;
+    UPInt         cellCount  = 0;
+    if (CellsX > 0 &&
+        origin.x >= BoundsMin.x && origin.x <= BoundsMax.x &&
+        origin.z >= BoundsMin.z && origin.z <= BoundsMax.z)
+    {
+        int cell   = GetCellCoord(origin.z, BoundsMin.z, CellSize, CellsZ) * CellsX +
+                     GetCellCoord(origin.x, BoundsMin.x, CellSize, CellsX);
+        cellCount  = CellStart[cell + 1] - CellStart[cell];
+        cellModels = cellCount ? &CellModels[CellStart[cell]] : NULL;
+    }
+
+    const Vector3f down(0.0f, -1.0f, 0.0f);
+    bool   hit = false;
+    float  nearest = len;
+    Planef plane;
+
+    // The shortest hit doesn't depend on the order the models are tested in.
+    for (int list = 0; list < 2; list++)
+    {
+        const UInt32* indices = list ? cellModels : (UnboundedModels.GetSize() ? &UnboundedModels[0] : NULL);
+        UPInt         count   = list ? cellCount : UnboundedModels.GetSize();
+
+        for (UPInt i = 0; i < count; i++)
+        {
+            float checkLength = len;
+            if (Models[indices[i]]->TestRay(origin, down, checkLength, &plane))
+            {
+                if (!hit || checkLength < nearest)
+                {
+                    nearest = checkLength;
+                    if (ph)
+                    {
+                        *ph = plane;
+                    }
+                }
+                hit = true;
+            }
+        }
+    }
+
+    len = nearest;
+    return hit;
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** GroundHeightfield
+
+void GroundHeightfield::Clear()
+{
+    Heights.Clear();
+    Smooth.Clear();
+    SamplesX = SamplesZ = 0;
+}
+
+void GroundHeightfield::Bake(const GroundGrid& grid, float spacing, float probeLength)
+{
+    Clear();
+
+    Vector3f boundsMin, boundsMax;
+    if (!grid.GetBounds(&boundsMin, &boundsMax))
+    {
+        return;
+    }
+
+    float sizeX = boundsMax.x - boundsMin.x;
+    float sizeZ = boundsMax.z - boundsMin.z;
+    Spacing     = Alg::Max(spacing, Alg::Max(sizeX, sizeZ) / (MaxHeightfieldSamples - 2));
+    SamplesX    = (int)(sizeX / Spacing) + 2;
+    SamplesZ    = (int)(sizeZ / Spacing) + 2;
+    Origin      = boundsMin;
+    ProbeHeight = boundsMax.y + 0.1f;
+
+    Heights.Resize(SamplesX * SamplesZ);
+    for (int z = 0; z < SamplesZ; z++)
+    {
+        for (int x = 0; x < SamplesX; x++)
+        {
+            float distance = probeLength;
+            bool  hit = grid.TestRayDown(GetSamplePosition(x, z), distance);
+            Heights[z * SamplesX + x] = hit ? ProbeHeight - distance : NoGround;
+        }
+    }
+
+    // A cell is interpolated only if its corners are within MaxStep of each other
+    // and a probe at its centre agrees with them; this catches the creases and
+    // edges that pass between corners at similar heights.
+    Smooth.Resize((SamplesX - 1) * (SamplesZ - 1));
+    for (int z = 0; z < SamplesZ - 1; z++)
+    {
+        for (int x = 0; x < SamplesX - 1; x++)
+        {
+            const float* row0 = &Heights[z * SamplesX + x];
+            const float* row1 = row0 + SamplesX;
+            float lowest  = Alg::Min(Alg::Min(row0[0], row0[1]), Alg::Min(row1[0], row1[1]));
+            float highest = Alg::Max(Alg::Max(row0[0], row0[1]), Alg::Max(row1[0], row1[1]));
+            bool  smooth  = lowest != NoGround && highest - lowest <= MaxStep;
+            if (smooth)
+            {
+                float    distance = probeLength;
+                Vector3f center   = GetSamplePosition(x, z) + Vector3f(Spacing * 0.5f, 0, Spacing * 0.5f);
+                float    average  = (row0[0] + row0[1] + row1[0] + row1[1]) * 0.25f;
+                smooth = grid.TestRayDown(center, distance) &&
+                         fabsf(ProbeHeight - distance - average) <= CenterTolerance;
+            }
+            Smooth[z * (SamplesX - 1) + x] = smooth ? 1 : 0;
+        }
+    }
+}
+
+Vector3f GroundHeightfield::GetSamplePosition(int x, int z) const
+{
+    return Vector3f(Origin.x + x * Spacing, ProbeHeight, Origin.z + z * Spacing);
+}
+
+bool GroundHeightfield::GetSampleHeight(int x, int z, float* height) const
+{
+    float h = Heights[z * SamplesX + x];
+    *height = h;
+    return h != NoGround;
+}
+
+bool GroundHeightfield::GetHeight(float x, float z, float* height) const
+{
+    if (!IsBaked())
+    {
+        return false;
+    }
+
+    float fx = (x - Origin.x) / Spacing;
+    float fz = (z - Origin.z) / Spacing;
+    if (!(fx >= 0 && fz >= 0 && fx <= SamplesX - 1 && fz <= SamplesZ - 1))
+    {
+        return false;
+    }
+
+    int   ix = Alg::Min((int)fx, SamplesX - 2);
+    int   iz = Alg::Min((int)fz, SamplesZ - 2);
+    float tx = fx - ix;
+    float tz = fz - iz;
+
+    if (!Smooth[iz * (SamplesX - 1) + ix])
+    {
+        return false;
+    }
+
+    const float* row0 = &Heights[iz * SamplesX + ix];
+    const float* row1 = row0 + SamplesX;
+
+    float h0 = row0[0] + (row0[1] - row0[0]) * tx;
+    float h1 = row1[0] + (row1[1] - row1[0]) * tx;
+    *height = h0 + (h1 - h0) * tz;
+    return true;
+}
+
+}} // OVR::Render
@@ -0,0 +1,106 @@
+/************************************************************************************
+
+Filename    :   Render_GroundGrid.h
+Content     :   XZ grid and baked heightfield over ground collision models
+Created     :   October 17, 2026
+Authors     :
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************************/
+
+#ifndef INC_Render_GroundGrid_h
+#define INC_Render_GroundGrid_h
+
+#include "Render_Device.h"
+
+namespace OVR { namespace Render {
+
+// Uniform grid over the XZ footprint of a set of CollisionModels, for rays cast
+// straight down. A ray only tests the models listed in the cell it starts in.
+class GroundGrid
+{
+public:
+    GroundGrid() : CellsX(0), CellsZ(0), CellSize(1.0f) { }
+
+    // Cells are cellSize on a side, or larger if the footprint would need more
+    // than MaxCellsPerAxis of them.
+    void  Build(const Array<Ptr<CollisionModel> >& models, float cellSize = 2.0f);
+    void  Clear();
+
+    enum { MaxCellsPerAxis = 1024 };
+
+    UPInt GetModelCount() const { return Models.GetSize(); }
+    int   GetCellsX() const     { return CellsX; }
+    int   GetCellsZ() const     { return CellsZ; }
+
+    // Bounds of all models that have them; false if there are none.
+    bool  GetBounds(Vector3f* boundsMin, Vector3f* boundsMax) const;
+
+    // Same as calling CollisionModel::TestRay down from origin on each model with
+    // the full len and keeping the shortest hit, as the player's ground probe does.
+    bool  TestRayDown(const Vector3f& origin, float& len, Planef* ph = NULL) const;
+
+private:
+    Array<Ptr<CollisionModel> > Models;
+    Array<UInt32>               UnboundedModels;
+    // Models of cell (x, z) are CellModels[CellStart[i]] up to CellModels[CellStart[i + 1]],
+    // i = z * CellsX + x, in ascending order.
+    Array<UInt32>               CellStart;
+    Array<UInt32>               CellModels;
+    Vector3f                    BoundsMin, BoundsMax;
+    int                         CellsX, CellsZ;
+    float                       CellSize;
+};
+
+// Ground heights sampled on a regular XZ grid, for terrain that doesn't move.
+// Lookups interpolate the four surrounding samples in constant time.
+class GroundHeightfield
+{
+public:
+    GroundHeightfield() : SamplesX(0), SamplesZ(0), Spacing(1.0f) { }
+
+    // Samples the grid's footprint every spacing units, casting probeLength down
+    // from just above the highest model. Where models overlap in Y only the
+    // topmost surface is kept.
+    void  Bake(const GroundGrid& grid, float spacing, float probeLength = 10.0f);
+    void  Clear();
+    bool  IsBaked() const       { return Heights.GetSize() > 0; }
+
+    int      GetSamplesX() const { return SamplesX; }
+    int      GetSamplesZ() const { return SamplesZ; }
+    Vector3f GetSamplePosition(int x, int z) const;
+    // Height found by the probe at a sample; false if it found no ground.
+    bool     GetSampleHeight(int x, int z, float* height) const;
+
+    // False outside the sampled area, if a surrounding sample has no ground, or if
+    // the samples or the ground at the cell's centre differ by more than MaxStep,
+    // as at a step or the edge of a model. Probe the ground there instead.
+    bool     GetHeight(float x, float z, float* height) const;
+
+    static const float MaxStep;
+
+private:
+    Array<float> Heights;       // Bake sets samples without ground to NoGround.
+    Array<UByte> Smooth;        // Per cell, nonzero if GetHeight may interpolate it.
+    Vector3f     Origin;
+    int          SamplesX, SamplesZ;
+    float        Spacing;
+    float        ProbeHeight;
+};
+
+}} // OVR::Render
+
+#endif // INC_Render_GroundGrid_h
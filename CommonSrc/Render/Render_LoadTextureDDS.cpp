@@ -62,7 +62,7 @@ struct OVR_DDS_HEADER
     UInt32				Reserved2;
 };
 
-Texture* LoadTextureDDS(RenderDevice* ren, File* f)
+TextureData* LoadTextureDataDDS(File* f)
 {
     OVR_DDS_HEADER header;
     unsigned char filecode[4];
@@ -102,17 +102,26 @@ Texture* LoadTextureDDS(RenderDevice* ren, File* f)
     }
 
     int            byteLen = f->BytesAvailable();
-    unsigned char* bytes   = new unsigned char[byteLen];
+    unsigned char* bytes   = (unsigned char*)OVR_ALLOC(byteLen);
     f->Read(bytes, byteLen);
-    Texture* out = ren->CreateTexture(format, (int)width, (int)height, bytes, mipCount);
-    if(strstr(f->GetFilePath(), "_c."))
-    {
-        out->SetSampleMode(Sample_Clamp);
-    }
-    OVR_FREE(bytes);
+
+    TextureData* out = new TextureData;
+    out->Format   = format;
+    out->Width    = width;
+    out->Height   = height;
+    out->MipCount = (int)mipCount;
+    out->pData    = bytes;
+    out->Clamp    = strstr(f->GetFilePath(), "_c.") != NULL;
     return out;
 }
 
+Texture* LoadTextureDDS(RenderDevice* ren, File* f)
+{
+    Ptr<TextureData> data = *LoadTextureDataDDS(f);
+    return data ? data->CreateTexture(ren) : NULL;
+}
+
+
 
 }}
 
@@ -23,80 +23,335 @@ limitations under the License.
 
 
 #include "Render_Device.h"
+#include "Render_Simd.h"
 
 namespace OVR { namespace Render {
 
-Texture* LoadTextureTga(RenderDevice* ren, File* f)
+enum TgaImageType
+{
+    Tga_ColorMapped     = 1,
+    Tga_TrueColor       = 2,
+    Tga_Grayscale       = 3,
+    Tga_RleColorMapped  = 9,
+    Tga_RleTrueColor    = 10,
+    Tga_RleGrayscale    = 11
+};
+
+enum TgaDescriptorFlags
+{
+    Tga_RightToLeft     = 0x10,
+    Tga_TopToBottom     = 0x20
+};
+
+// *** Row conversion to RGBA
+
+static void ConvertRowBgraScalar(const UByte* src, UByte* dest, int width)
+{
+    for (int x = 0; x < width; x++, src += 4, dest += 4)
+    {
+        dest[0] = src[2];
+        dest[1] = src[1];
+        dest[2] = src[0];
+        dest[3] = src[3];
+    }
+}
+
+static void ConvertRowBgrScalar(const UByte* src, UByte* dest, int width)
+{
+    for (int x = 0; x < width; x++, src += 3, dest += 4)
+    {
+        dest[0] = src[2];
+        dest[1] = src[1];
+        dest[2] = src[0];
+        dest[3] = 255;
+    }
+}
+
+#if defined(OVR_RENDER_SSE2)
+
+// Swaps the R and B bytes of each 32-bit pixel; SSE2 has no byte shuffle, but
+// the swap can be done with 32-bit shifts and masks.
+static void ConvertRowBgra(const UByte* src, UByte* dest, int width)
+{
+    const __m128i maskGA = _mm_set1_epi32(0xFF00FF00);
+    const __m128i maskB  = _mm_set1_epi32(0x000000FF);
+    int x = 0;
+    for (; x + 4 <= width; x += 4, src += 16, dest += 16)
+    {
+        __m128i p  = _mm_loadu_si128((const __m128i*)src);
+        __m128i rb = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 16), maskB),
+                                  _mm_slli_epi32(_mm_and_si128(p, maskB), 16));
+        _mm_storeu_si128((__m128i*)dest, _mm_or_si128(_mm_and_si128(p, maskGA), rb));
+    }
+    ConvertRowBgraScalar(src, dest, width - x);
+}
+
+// Expands 16 BGR pixels (48 bytes) to 16 RGBA pixels per iteration.
+OVR_RENDER_TARGET_SSSE3
+static void ConvertRowBgrSsse3(const UByte* src, UByte* dest, int width)
+{
+    const __m128i shuffle = _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+    const __m128i alpha   = _mm_set1_epi32(0xFF000000);
+    int x = 0;
+    for (; x + 16 <= width; x += 16, src += 48, dest += 64)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i*)(src));
+        __m128i b = _mm_loadu_si128((const __m128i*)(src + 16));
+        __m128i c = _mm_loadu_si128((const __m128i*)(src + 32));
+
+        // Pixels 0-3 start at byte 0, 4-7 at 12, 8-11 at 24 and 12-15 at 36.
+        __m128i p0 = a;
+        __m128i p1 = _mm_alignr_epi8(b, a, 12);
+        __m128i p2 = _mm_alignr_epi8(c, b, 8);
+        __m128i p3 = _mm_srli_si128(c, 4);
+
+        _mm_storeu_si128((__m128i*)(dest),      _mm_or_si128(_mm_shuffle_epi8(p0, shuffle), alpha));
+        _mm_storeu_si128((__m128i*)(dest + 16), _mm_or_si128(_mm_shuffle_epi8(p1, shuffle), alpha));
+        _mm_storeu_si128((__m128i*)(dest + 32), _mm_or_si128(_mm_shuffle_epi8(p2, shuffle), alpha));
+        _mm_storeu_si128((__m128i*)(dest + 48), _mm_or_si128(_mm_shuffle_epi8(p3, shuffle), alpha));
+    }
+    ConvertRowBgrScalar(src, dest, width - x);
+}
+
+static void ConvertRowBgr(const UByte* src, UByte* dest, int width)
+{
+    if (GetCpuFeatures() & CpuFeature_SSSE3)
+        ConvertRowBgrSsse3(src, dest, width);
+    else
+        ConvertRowBgrScalar(src, dest, width);
+}
+
+#else
+
+static void ConvertRowBgra(const UByte* src, UByte* dest, int width) { ConvertRowBgraScalar(src, dest, width); }
+static void ConvertRowBgr(const UByte* src, UByte* dest, int width)  { ConvertRowBgrScalar(src, dest, width); }
+
+#endif
+
+static void ConvertRowGray(const UByte* src, UByte* dest, int width)
 {
-    int desclen = f->ReadUByte();
-    int palette = f->ReadUByte();
-    OVR_UNUSED(palette);
-    int imgtype = f->ReadUByte();
-    f->ReadUInt16();
-    int palCount = f->ReadUInt16();
-    int palSize = f->ReadUByte();
-    f->ReadUInt16();
-    f->ReadUInt16();
-    int width = f->ReadUInt16();
-    int height = f->ReadUInt16();
-    int bpp = f->ReadUByte();
-    f->ReadUByte();
-    int imgsize = width * height * 4;
-    unsigned char* imgdata = (unsigned char*) OVR_ALLOC(imgsize);
-    unsigned char buf[16];
-    f->Read(imgdata, desclen);
-    f->Read(imgdata, palCount * (palSize + 7) >> 3);
-    int bpl = width * 4;
-
-    switch (imgtype)
+    for (int x = 0; x < width; x++, dest += 4)
     {
-    case 2:
-        switch (bpp)
+        dest[0] = dest[1] = dest[2] = src[x];
+        dest[3] = 255;
+    }
+}
+
+static void ConvertRowGrayAlpha(const UByte* src, UByte* dest, int width)
+{
+    for (int x = 0; x < width; x++, src += 2, dest += 4)
+    {
+        dest[0] = dest[1] = dest[2] = src[0];
+        dest[3] = src[1];
+    }
+}
+
+static void ConvertRowIndexed(const UByte* src, const UInt32* palette, int paletteSize,
+                              UByte* dest, int width)
+{
+    UInt32* out = (UInt32*)dest;
+    for (int x = 0; x < width; x++)
+    {
+        out[x] = (src[x] < paletteSize) ? palette[src[x]] : 0;
+    }
+}
+
+// Expands RLE packets of pixelSize-byte pixels from src into dest, which holds
+// pixelCount pixels. Returns false if the data runs out first.
+static bool DecodeTgaRle(const UByte* src, UPInt srcSize, int pixelSize,
+                         UByte* dest, UPInt pixelCount)
+{
+    const UByte* srcEnd = src + srcSize;
+    UPInt        done   = 0;
+
+    while (done < pixelCount)
+    {
+        if (src >= srcEnd)
+            return false;
+
+        int   header = *src++;
+        UPInt count  = Alg::Min<UPInt>((header & 0x7F) + 1, pixelCount - done);
+
+        if (header & 0x80)
         {
-        case 24:
-            for (int y = 0; y < height; y++)
-                for (int x = 0; x < width; x++)
-                {
-                    f->Read(buf, 3);
-                    imgdata[y*bpl+x*4+0] = buf[2];
-                    imgdata[y*bpl+x*4+1] = buf[1];
-                    imgdata[y*bpl+x*4+2] = buf[0];
-                    imgdata[y*bpl+x*4+3] = 255;
-                }
-            break;
-        case 32:
-            for (int y = 0; y < height; y++)
-                for (int x = 0; x < width; x++)
-                {
-                    f->Read(buf, 4);
-                    imgdata[y*bpl+x*4+0] = buf[2];
-                    imgdata[y*bpl+x*4+1] = buf[1];
-                    imgdata[y*bpl+x*4+2] = buf[0];
-                    imgdata[y*bpl+x*4+3] = buf[3];
-                }
-            break;
-
-        default:
-            OVR_FREE(imgdata);
-            return NULL;
+            if ((UPInt)(srcEnd - src) < (UPInt)pixelSize)
+                return false;
+            for (UPInt i = 0; i < count; i++, dest += pixelSize)
+                memcpy(dest, src, pixelSize);
+            src += pixelSize;
         }
-        break;
+        else
+        {
+            UPInt bytes = count * pixelSize;
+            if ((UPInt)(srcEnd - src) < bytes)
+                return false;
+            memcpy(dest, src, bytes);
+            src  += bytes;
+            dest += bytes;
+        }
+        done += count;
+    }
+    return true;
+}
+
+static inline int ReadLE16(const UByte* p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+// Supports uncompressed and RLE true-color (24/32 bit), grayscale (8 bit, or 16 bit
+// with alpha) and 8-bit color-mapped images with 24 or 32-bit palettes. Rows are
+// returned in bottom-to-top order, which is how the scene UVs expect them and how
+// TGA stores images by default; top-to-bottom and right-to-left images are flipped
+// to match.
+TextureData* LoadTextureDataTga(File* f)
+{
+    UByte header[18];
+    if (f->Read(header, sizeof(header)) != sizeof(header))
+        return NULL;
+
+    int desclen    = header[0];
+    int hasPalette = header[1];
+    int imgtype    = header[2];
+    int palFirst   = ReadLE16(header + 3);
+    int palCount   = ReadLE16(header + 5);
+    int palSize    = header[7];
+    int width      = ReadLE16(header + 12);
+    int height     = ReadLE16(header + 14);
+    int bpp        = header[16];
+    int descriptor = header[17];
+
+    if (width == 0 || height == 0)
+        return NULL;
 
+    // Pick the row converter for the pixel format.
+    bool colorMapped = (imgtype == Tga_ColorMapped || imgtype == Tga_RleColorMapped);
+    bool rle         = (imgtype & 8) != 0;
+    int  pixelSize   = bpp / 8;
+    void (*convertRow)(const UByte*, UByte*, int) = NULL;
+
+    switch (imgtype & 7)
+    {
+    case Tga_TrueColor:
+        if (bpp == 24)
+            convertRow = ConvertRowBgr;
+        else if (bpp == 32)
+            convertRow = ConvertRowBgra;
+        break;
+    case Tga_Grayscale:
+        if (bpp == 8)
+            convertRow = ConvertRowGray;
+        else if (bpp == 16)
+            convertRow = ConvertRowGrayAlpha;
+        break;
+    case Tga_ColorMapped:
+        if (!hasPalette || bpp != 8 || (palSize != 24 && palSize != 32))
+            return NULL;
+        break;
     default:
-        OVR_FREE(imgdata);
         return NULL;
     }
+    if (!convertRow && !colorMapped)
+        return NULL;
 
-	Texture* out = ren->CreateTexture(Texture_RGBA|Texture_GenMipmaps, width, height, imgdata);
+    // Skip the image ID and read the palette, if any.
+    UByte skip[256];
+    if (desclen && f->Read(skip, desclen) != desclen)
+        return NULL;
 
-	// check for clamp based on texture name
-	if(strstr(f->GetFilePath(), "_c."))
-	{
-		out->SetSampleMode(Sample_Clamp);
-	}
+    UInt32 palette[256];
+    int    paletteEnd = 0;
+    if (hasPalette || palCount)
+    {
+        int   palEntrySize = (palSize + 7) >> 3;
+        int   palBytes     = palCount * palEntrySize;
+        UByte* palData     = (UByte*)OVR_ALLOC(palBytes ? palBytes : 1);
+        bool  readOk       = f->Read(palData, palBytes) == palBytes;
 
-    OVR_FREE(imgdata);
+        // Index i refers to palette entry i - palFirst.
+        if (readOk && colorMapped)
+        {
+            paletteEnd = Alg::Min(256, palFirst + palCount);
+            for (int i = 0; i < 256; i++)
+                palette[i] = 0;
+            for (int i = palFirst; i < paletteEnd; i++)
+            {
+                const UByte* e = palData + (i - palFirst) * palEntrySize;
+                UByte        a = (palEntrySize == 4) ? e[3] : 255;
+                palette[i] = (UInt32)e[2] | ((UInt32)e[1] << 8) | ((UInt32)e[0] << 16) | ((UInt32)a << 24);
+            }
+        }
+        OVR_FREE(palData);
+        if (!readOk)
+            return NULL;
+    }
+
+    // Read the pixel payload in one go and expand RLE data if needed.
+    const UPInt pixelCount = (UPInt)width * height;
+    const UPInt imageBytes = pixelCount * pixelSize;
+    int         available  = f->BytesAvailable();
+    UPInt       readSize   = rle ? (UPInt)Alg::Max(available, 0) : imageBytes;
+
+    UByte* payload = (UByte*)OVR_ALLOC(readSize ? readSize : 1);
+    UPInt  bytesRead = (UPInt)Alg::Max(f->Read(payload, (int)readSize), 0);
+
+    UByte* pixels = payload;
+    if (rle)
+    {
+        pixels = (UByte*)OVR_ALLOC(imageBytes);
+        bool ok = DecodeTgaRle(payload, bytesRead, pixelSize, pixels, pixelCount);
+        OVR_FREE(payload);
+        payload = NULL;
+        if (!ok)
+        {
+            OVR_FREE(pixels);
+            return NULL;
+        }
+    }
+    else if (bytesRead < imageBytes)
+    {
+        OVR_FREE(payload);
+        return NULL;
+    }
+
+    // Convert to RGBA, flipping rows and columns as needed.
+    UByte*    imgdata = (UByte*) OVR_ALLOC(pixelCount * 4);
+    const int bpl     = width * 4;
+    for (int y = 0; y < height; y++)
+    {
+        int          srcRow = (descriptor & Tga_TopToBottom) ? (height - 1 - y) : y;
+        const UByte* src    = pixels + (UPInt)srcRow * width * pixelSize;
+        UByte*       dest   = imgdata + (UPInt)y * bpl;
+
+        if (colorMapped)
+            ConvertRowIndexed(src, palette, paletteEnd, dest, width);
+        else
+            convertRow(src, dest, width);
+
+        if (descriptor & Tga_RightToLeft)
+        {
+            UInt32* row = (UInt32*)dest;
+            for (int l = 0, r = width - 1; l < r; l++, r--)
+                Alg::Swap(row[l], row[r]);
+        }
+    }
+    OVR_FREE(pixels);
+
+    TextureData* out = new TextureData;
+    out->Format = Texture_RGBA|Texture_GenMipmaps;
+    out->Width  = width;
+    out->Height = height;
+    out->pData  = imgdata;
+
+	// check for clamp based on texture name
+    out->Clamp  = strstr(f->GetFilePath(), "_c.") != NULL;
     return out;
 }
 
+Texture* LoadTextureTga(RenderDevice* ren, File* f)
+{
+    Ptr<TextureData> data = *LoadTextureDataTga(f);
+    return data ? data->CreateTexture(ren) : NULL;
+}
+
 }}
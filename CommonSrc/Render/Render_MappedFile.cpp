@@ -0,0 +1,133 @@
+/************************************************************************************
+
+Filename    :   Render_MappedFile.cpp
+Content     :   Read-only memory mapped files - implementation
+Created     :   October 17, 2026
+Authors     :
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************************/
+
+#include "Render_MappedFile.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#if defined(OVR_OS_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+namespace OVR { namespace Render {
+
+#if defined(OVR_OS_WIN32)
+
+MappedFile::MappedFile() : pData(NULL), Size(0), hFile(INVALID_HANDLE_VALUE), hMapping(NULL)
+{
+}
+
+bool MappedFile::Open(const char* fileName)
+{
+    hFile = ::CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                          FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (hFile == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!::GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart == 0)
+    {
+        Close();
+        return false;
+    }
+
+    hMapping = ::CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!hMapping)
+    {
+        Close();
+        return false;
+    }
+
+    pData = (const UByte*)::MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+    Size  = (UPInt)fileSize.QuadPart;
+    if (!pData)
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (pData)
+        ::UnmapViewOfFile(pData);
+    if (hMapping)
+        ::CloseHandle(hMapping);
+    if (hFile != INVALID_HANDLE_VALUE)
+        ::CloseHandle(hFile);
+    pData    = NULL;
+    Size     = 0;
+    hMapping = NULL;
+    hFile    = INVALID_HANDLE_VALUE;
+}
+
+#else
+
+MappedFile::MappedFile() : pData(NULL), Size(0), Fd(-1)
+{
+}
+
+bool MappedFile::Open(const char* fileName)
+{
+    Fd = ::open(fileName, O_RDONLY);
+    if (Fd < 0)
+        return false;
+
+    struct stat st;
+    if (::fstat(Fd, &st) != 0 || st.st_size == 0)
+    {
+        Close();
+        return false;
+    }
+
+    void* p = ::mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, Fd, 0);
+    if (p == MAP_FAILED)
+    {
+        Close();
+        return false;
+    }
+    pData = (const UByte*)p;
+    Size  = (UPInt)st.st_size;
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (pData)
+        ::munmap((void*)pData, Size);
+    if (Fd >= 0)
+        ::close(Fd);
+    pData = NULL;
+    Size  = 0;
+    Fd    = -1;
+}
+
+#endif
+
+}} // OVR::Render
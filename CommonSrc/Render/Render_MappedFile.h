@@ -0,0 +1,57 @@
+/************************************************************************************
+
+Filename    :   Render_MappedFile.h
+Content     :   Read-only memory mapped files
+Created     :   October 17, 2026
+Authors     :
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************************/
+
+#ifndef INC_Render_MappedFile_h
+#define INC_Render_MappedFile_h
+
+#include "Kernel/OVR_Types.h"
+
+namespace OVR { namespace Render {
+
+// Read-only memory mapping of an entire file.
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile() { Close(); }
+
+    bool Open(const char* fileName);
+    void Close();
+
+    const UByte* GetData() const { return pData; }
+    UPInt        GetSize() const { return Size; }
+
+private:
+    const UByte* pData;
+    UPInt        Size;
+#if defined(OVR_OS_WIN32)
+    void*        hFile;      // HANDLE
+    void*        hMapping;
+#else
+    int          Fd;
+#endif
+};
+
+}} // OVR::Render
+
+#endif // INC_Render_MappedFile_h
@@ -0,0 +1,355 @@
+/************************************************************************************
+
+Filename    :   Render_MipChain.cpp
+Content     :   RGBA mipmap chain generation
+Created     :   October 17, 2026
+Authors     :
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************************/
+
+#include "Render_Device.h"
+#include "Render_WorkerPool.h"
+#include "Render_Simd.h"
+
+#include <math.h>
+
+namespace OVR { namespace Render {
+
+// Each destination pixel is a box filter over the source area it covers. Along an
+// even dimension that is 2 texels of weight 1; along an odd dimension n = 2m + 1
+// (m destination texels) it is the 3 texels 2i, 2i + 1, 2i + 2 with weights
+// m - i, m and i + 1, which sum to n. A dimension of 1 is copied. The weighted sum
+// is divided by the total weight with rounding to nearest, so a 2x2 block gives
+// (a + b + c + d + 2) >> 2; the SIMD kernels handle only that even case and
+// produce exactly the same bytes.
+
+struct MipAxisTaps
+{
+    int Offset;       // First source texel.
+    int Count;        // 1, 2 or 3.
+    int Weights[3];
+};
+
+static int GetMipAxisDivisor(int n)
+{
+    return (n == 1) ? 1 : ((n & 1) ? n : 2);
+}
+
+static MipAxisTaps GetMipAxisTaps(int n, int i)
+{
+    MipAxisTaps taps;
+    if (n == 1)
+    {
+        taps.Offset = 0;
+        taps.Count  = 1;
+        taps.Weights[0] = 1;
+    }
+    else if ((n & 1) == 0)
+    {
+        taps.Offset = 2 * i;
+        taps.Count  = 2;
+        taps.Weights[0] = taps.Weights[1] = 1;
+    }
+    else
+    {
+        int m = n >> 1;
+        taps.Offset = 2 * i;
+        taps.Count  = 3;
+        taps.Weights[0] = m - i;
+        taps.Weights[1] = m;
+        taps.Weights[2] = i + 1;
+    }
+    return taps;
+}
+
+// *** sRGB conversion
+
+// 8-bit sRGB to 16-bit linear, and the nearest 8-bit sRGB value for a 16-bit linear
+// value. The table is strictly increasing, so the inverse is a binary search.
+class SrgbTable
+{
+public:
+    UInt16 ToLinear[256];
+
+    SrgbTable()
+    {
+        for (int i = 0; i < 256; i++)
+        {
+            double c = i / 255.0;
+            double l = (c <= 0.04045) ? c / 12.92 : pow((c + 0.055) / 1.055, 2.4);
+            ToLinear[i] = (UInt16)(l * 65535.0 + 0.5);
+        }
+    }
+
+    UByte ToSrgb(UInt32 linear) const
+    {
+        int lo = 0, hi = 255;
+        while (lo < hi)
+        {
+            int mid = (lo + hi + 1) >> 1;
+            if (ToLinear[mid] <= linear)
+                lo = mid;
+            else
+                hi = mid - 1;
+        }
+        if (lo < 255 && (ToLinear[lo + 1] - linear) < (linear - ToLinear[lo]))
+            lo++;
+        return (UByte)lo;
+    }
+};
+
+static const SrgbTable Srgb;
+
+// *** Reference filter
+
+static void FilterRowsScalar(const UByte* src, int w, int h, UByte* dest,
+                             int rowBegin, int rowEnd, int flags)
+{
+    const int    mipw    = Alg::Max(w >> 1, 1);
+    const UInt64 divisor = (UInt64)GetMipAxisDivisor(w) * GetMipAxisDivisor(h);
+    const bool   srgb    = (flags & MipFilter_SRGB) != 0;
+
+    for (int j = rowBegin; j < rowEnd; j++)
+    {
+        MipAxisTaps ty    = GetMipAxisTaps(h, j);
+        UByte*      pdest = dest + (UPInt)mipw * j * 4;
+
+        for (int i = 0; i < mipw; i++, pdest += 4)
+        {
+            MipAxisTaps tx = GetMipAxisTaps(w, i);
+            UInt64      sum[4] = { 0, 0, 0, 0 };
+
+            for (int y = 0; y < ty.Count; y++)
+            {
+                const UByte* psrc = src + ((UPInt)(ty.Offset + y) * w + tx.Offset) * 4;
+                for (int x = 0; x < tx.Count; x++, psrc += 4)
+                {
+                    UInt64 weight = (UInt64)ty.Weights[y] * tx.Weights[x];
+                    for (int c = 0; c < 3; c++)
+                        sum[c] += weight * (srgb ? Srgb.ToLinear[psrc[c]] : psrc[c]);
+                    sum[3] += weight * psrc[3];
+                }
+            }
+
+            for (int c = 0; c < 4; c++)
+            {
+                UInt64 value = (sum[c] + divisor / 2) / divisor;
+                pdest[c] = (srgb && c < 3) ? Srgb.ToSrgb((UInt32)value) : (UByte)value;
+            }
+        }
+    }
+}
+
+// *** SIMD 2x2 filters
+
+// Both kernels widen to 16 bits, add the two rows, then add horizontal pixel pairs
+// by splitting even and odd pixels with 64-bit unpacks. They only handle even w and
+// h and leave any remainder of the row to the scalar filter.
+
+#if defined(OVR_RENDER_SSE2)
+
+static inline __m128i AddPixelPairs(__m128i row0, __m128i row1)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(row0, zero), _mm_unpacklo_epi8(row1, zero));
+    __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(row0, zero), _mm_unpackhi_epi8(row1, zero));
+    return _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+}
+
+// Returns the number of destination pixels written; 4 per iteration.
+static int FilterRowSse2(const UByte* row0, const UByte* row1, UByte* dest, int mipw)
+{
+    const __m128i round = _mm_set1_epi16(2);
+    int i = 0;
+    for (; i + 4 <= mipw; i += 4, row0 += 32, row1 += 32, dest += 16)
+    {
+        __m128i a = AddPixelPairs(_mm_loadu_si128((const __m128i*)row0),
+                                  _mm_loadu_si128((const __m128i*)row1));
+        __m128i b = AddPixelPairs(_mm_loadu_si128((const __m128i*)(row0 + 16)),
+                                  _mm_loadu_si128((const __m128i*)(row1 + 16)));
+        a = _mm_srli_epi16(_mm_add_epi16(a, round), 2);
+        b = _mm_srli_epi16(_mm_add_epi16(b, round), 2);
+        _mm_storeu_si128((__m128i*)dest, _mm_packus_epi16(a, b));
+    }
+    return i;
+}
+
+#if defined(OVR_RENDER_AVX2_INTRINSICS)
+
+OVR_RENDER_TARGET_AVX2
+static inline __m256i AddPixelPairsAvx2(__m256i row0, __m256i row1)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i lo = _mm256_add_epi16(_mm256_unpacklo_epi8(row0, zero), _mm256_unpacklo_epi8(row1, zero));
+    __m256i hi = _mm256_add_epi16(_mm256_unpackhi_epi8(row0, zero), _mm256_unpackhi_epi8(row1, zero));
+    return _mm256_add_epi16(_mm256_unpacklo_epi64(lo, hi), _mm256_unpackhi_epi64(lo, hi));
+}
+
+// 8 destination pixels per iteration. Unpacks work within 128-bit lanes, so the
+// packed result holds pixels 0-1, 4-5, 2-3, 6-7 and is put in order with a permute.
+OVR_RENDER_TARGET_AVX2
+static int FilterRowAvx2(const UByte* row0, const UByte* row1, UByte* dest, int mipw)
+{
+    const __m256i round = _mm256_set1_epi16(2);
+    int i = 0;
+    for (; i + 8 <= mipw; i += 8, row0 += 64, row1 += 64, dest += 32)
+    {
+        __m256i a = AddPixelPairsAvx2(_mm256_loadu_si256((const __m256i*)row0),
+                                      _mm256_loadu_si256((const __m256i*)row1));
+        __m256i b = AddPixelPairsAvx2(_mm256_loadu_si256((const __m256i*)(row0 + 32)),
+                                      _mm256_loadu_si256((const __m256i*)(row1 + 32)));
+        a = _mm256_srli_epi16(_mm256_add_epi16(a, round), 2);
+        b = _mm256_srli_epi16(_mm256_add_epi16(b, round), 2);
+        __m256i packed = _mm256_packus_epi16(a, b);
+        _mm256_storeu_si256((__m256i*)dest, _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+    return i;
+}
+
+#endif // OVR_RENDER_AVX2_INTRINSICS
+
+#endif
+
+static MipFilterPath GetAvailableMipFilterPath(MipFilterPath path)
+{
+#if defined(OVR_RENDER_SSE2)
+#if defined(OVR_RENDER_AVX2_INTRINSICS)
+    if ((path == MipFilterPath_Auto || path == MipFilterPath_AVX2) && (GetCpuFeatures() & CpuFeature_AVX2))
+        return MipFilterPath_AVX2;
+#endif
+    if (path != MipFilterPath_Scalar)
+        return MipFilterPath_SSE2;
+#else
+    OVR_UNUSED(path);
+#endif
+    return MipFilterPath_Scalar;
+}
+
+static void FilterRows(const UByte* src, int w, int h, UByte* dest,
+                       int rowBegin, int rowEnd, int flags, MipFilterPath path)
+{
+    path = GetAvailableMipFilterPath(path);
+
+    // Odd dimensions and sRGB filtering only have the reference implementation.
+    if (path == MipFilterPath_Scalar || (w & 1) || (h & 1) || (flags & MipFilter_SRGB))
+    {
+        FilterRowsScalar(src, w, h, dest, rowBegin, rowEnd, flags);
+        return;
+    }
+
+#if defined(OVR_RENDER_SSE2)
+    const int mipw = w >> 1;
+    for (int j = rowBegin; j < rowEnd; j++)
+    {
+        const UByte* row0  = src + (UPInt)w * (2 * j) * 4;
+        const UByte* row1  = row0 + (UPInt)w * 4;
+        UByte*       pdest = dest + (UPInt)mipw * j * 4;
+
+        int i = 0;
+#if defined(OVR_RENDER_AVX2_INTRINSICS)
+        if (path == MipFilterPath_AVX2)
+            i = FilterRowAvx2(row0, row1, pdest, mipw);
+#endif
+        i += FilterRowSse2(row0 + i * 8, row1 + i * 8, pdest + i * 4, mipw - i);
+
+        for (; i < mipw; i++)
+        {
+            for (int c = 0; c < 4; c++)
+                pdest[i * 4 + c] = (UByte)((row0[i * 8 + c] + row0[i * 8 + 4 + c] +
+                                            row1[i * 8 + c] + row1[i * 8 + 4 + c] + 2) >> 2);
+        }
+    }
+#endif
+}
+
+// *** Public interface
+
+int GetMipChainSize(int w, int h)
+{
+    int size = 0;
+    for (;;)
+    {
+        size += w * h * 4;
+        if (w == 1 && h == 1)
+            return size;
+        w = Alg::Max(w >> 1, 1);
+        h = Alg::Max(h >> 1, 1);
+    }
+}
+
+void FilterRgba2x2(const UByte* src, int w, int h, UByte* dest, int flags, MipFilterPath path)
+{
+    FilterRows(src, w, h, dest, 0, Alg::Max(h >> 1, 1), flags, path);
+}
+
+// Levels with at least this many destination pixels are split into bands of
+// MipBandRows rows across the worker pool.
+enum
+{
+    MipParallelMinPixels = 128 * 128,
+    MipBandRows          = 32
+};
+
+struct MipLevelJob
+{
+    const UByte*  pSrc;
+    UByte*        pDest;
+    int           Width, Height;
+    int           Flags;
+    MipFilterPath Path;
+
+    static void FilterBand(void* context, UPInt band)
+    {
+        const MipLevelJob* job = (const MipLevelJob*)context;
+        int rowBegin = (int)band * MipBandRows;
+        int rowEnd   = Alg::Min(rowBegin + (int)MipBandRows, Alg::Max(job->Height >> 1, 1));
+        FilterRows(job->pSrc, job->Width, job->Height, job->pDest, rowBegin, rowEnd, job->Flags, job->Path);
+    }
+};
+
+void BuildMipChain(const UByte* src, int w, int h, UByte* dest, int flags,
+                   WorkerPool* pWorkers, MipFilterPath path)
+{
+    if (dest != src)
+    {
+        memcpy(dest, src, (UPInt)w * h * 4);
+    }
+
+    const UByte* level = dest;
+    while (w > 1 || h > 1)
+    {
+        int    mipw = Alg::Max(w >> 1, 1);
+        int    miph = Alg::Max(h >> 1, 1);
+        UByte* next = (UByte*)level + (UPInt)w * h * 4;
+
+        if (pWorkers && pWorkers->GetThreadCount() > 1 && mipw * miph >= MipParallelMinPixels)
+        {
+            MipLevelJob job = { level, next, w, h, flags, path };
+            pWorkers->ParallelFor((miph + MipBandRows - 1) / MipBandRows, MipLevelJob::FilterBand, &job);
+        }
+        else
+        {
+            FilterRows(level, w, h, next, 0, miph, flags, path);
+        }
+
+        level = next;
+        w     = mipw;
+        h     = miph;
+    }
+}
+
+}} // OVR::Render
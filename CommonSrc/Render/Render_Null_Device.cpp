@@ -0,0 +1,338 @@
+/************************************************************************************
+
+Filename    :   Render_Null_Device.cpp
+Content     :   RenderDevice that records commands instead of drawing
+Created     :   October 17, 2026
+Authors     :
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************************/
+
+#include "Render_Null_Device.h"
+
+#include <string.h>
+
+namespace OVR { namespace Render { namespace Null {
+
+// The D3D devices send the view matrix with every draw, and the projection
+// only when SetWorldUniforms changes it.
+static const UPInt DrawUniformBytes = sizeof(Matrix4f);
+
+
+//-------------------------------------------------------------------------------------
+// ***** Shader, Buffer and Texture
+
+void Shader::Set(PrimitiveType prim) const
+{
+    OVR_UNUSED(prim);
+    Ren->BindShader(this);
+}
+
+void Shader::SetUniformBuffer(Render::Buffer* buffer, int i)
+{
+    OVR_UNUSED(i);
+    Ren->Record(Command_SetUniforms, buffer, buffer ? buffer->GetSize() : 0);
+}
+
+bool Shader::SetUniform(const char* name, int n, const float* v)
+{
+    OVR_UNUSED2(name, v);
+    Ren->Record(Command_SetUniforms, this, n * sizeof(float));
+    return true;
+}
+
+bool Shader::SetUniform(UniformHandle h, int n, const float* v)
+{
+    OVR_UNUSED2(h, v);
+    Ren->Record(Command_SetUniforms, this, n * sizeof(float));
+    return true;
+}
+
+void* Buffer::Map(size_t start, size_t size, int flags)
+{
+    OVR_UNUSED(flags);
+    if (start + size > Data_.GetSize())
+    {
+        return NULL;
+    }
+    MapStart = start;
+    MapSize  = size;
+    return size ? &Data_[start] : NULL;
+}
+
+bool Buffer::Unmap(void* m)
+{
+    OVR_UNUSED(m);
+    Ren->Record(Command_BufferData, this, MapSize);
+    MapSize = 0;
+    return true;
+}
+
+bool Buffer::Data(int use, const void* buffer, size_t size)
+{
+    OVR_UNUSED(use);
+    Data_.Resize(size);
+    if (buffer && size)
+    {
+        memcpy(&Data_[0], buffer, size);
+        Ren->Record(Command_BufferData, this, size);
+    }
+    return true;
+}
+
+Texture::Texture(RenderDevice* r, int format, int w, int h)
+    : Ren(r), Format(format), Width(w), Height(h), SampleMode(Sample_Linear)
+{
+    Samples = Alg::Max(format & Texture_SamplesMask, 1);
+}
+
+void Texture::Set(int slot, ShaderStage stage) const
+{
+    OVR_UNUSED(stage);
+    Ren->BindTexture(slot, this);
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** RenderDevice
+
+RenderDevice::RenderDevice(const RendererParams& p)
+    : BoundRenderTarget(NULL), BoundDepthMode(-1), KeepCommandLog(true), FramesPresented(0)
+{
+    Params = p;
+
+    for (int i = 0; i < VShader_Count; i++)
+    {
+        VertexShaders[i] = *new Shader(this, Shader_Vertex);
+    }
+    for (int i = 0; i < FShader_Count; i++)
+    {
+        PixelShaders[i] = *new Shader(this, Shader_Fragment);
+    }
+
+    Ptr<ShaderSet> gouraudShaders = *new ShaderSet();
+    gouraudShaders->SetShader(VertexShaders[VShader_MVP]);
+    gouraudShaders->SetShader(PixelShaders[FShader_Gouraud]);
+    DefaultFill = *new ShaderFill(gouraudShaders);
+
+    memset(BoundShaders, 0, sizeof(BoundShaders));
+    memset(BoundTextures, 0, sizeof(BoundTextures));
+}
+
+Render::RenderDevice* RenderDevice::CreateDevice(const RendererParams& rp, void* oswnd)
+{
+    OVR_UNUSED(oswnd);
+    return new RenderDevice(rp);
+}
+
+void RenderDevice::Record(CommandType type, const void* object, UPInt count)
+{
+    switch (type)
+    {
+    case Command_Draw:
+        Stats.Draws++;
+        Stats.Indices += count;
+        break;
+    case Command_SetRenderTarget:
+    case Command_SetViewport:
+    case Command_SetDepthMode:
+    case Command_SetShader:
+    case Command_SetTexture:
+        Stats.StateChanges++;
+        break;
+    case Command_SetUniforms:
+        Stats.UniformBytes += count;
+        AddUniformBytesUploaded(count);
+        break;
+    case Command_BufferData:
+    case Command_TextureData:
+        Stats.UploadBytes += count;
+        break;
+    default:
+        break;
+    }
+
+    if (KeepCommandLog)
+    {
+        Command command = { type, object, count };
+        FrameLog.PushBack(command);
+    }
+}
+
+void RenderDevice::BindShader(const Shader* shader)
+{
+    int stage = shader->GetStage();
+    if (BoundShaders[stage] != shader)
+    {
+        BoundShaders[stage] = shader;
+        Record(Command_SetShader, shader);
+    }
+}
+
+void RenderDevice::BindTexture(int slot, const Texture* texture)
+{
+    if (slot >= 0 && slot < MaxTextureSlots && BoundTextures[slot] != texture)
+    {
+        BoundTextures[slot] = texture;
+        Record(Command_SetTexture, texture, (UPInt)slot);
+    }
+}
+
+void RenderDevice::SetMultipleViewports(int n, const Viewport* vps)
+{
+    OVR_UNUSED(vps);
+    Record(Command_SetViewport, NULL, (UPInt)n);
+}
+
+void RenderDevice::Clear(float r, float g, float b, float a, float depth)
+{
+    OVR_UNUSED5(r, g, b, a, depth);
+    Record(Command_Clear);
+}
+
+void RenderDevice::Rect(float left, float top, float right, float bottom)
+{
+    OVR_UNUSED4(left, top, right, bottom);
+    Record(Command_Draw, NULL, 6);
+}
+
+void RenderDevice::Present()
+{
+    Record(Command_Present);
+
+    LastFrameStats = Stats;
+    Stats          = FrameStats();
+    LastFrameLog.Clear();
+    Alg::Swap(FrameLog, LastFrameLog);
+    FramesPresented++;
+}
+
+Render::Buffer* RenderDevice::CreateBuffer()
+{
+    return new Buffer(this);
+}
+
+Render::Texture* RenderDevice::CreateTexture(int format, int width, int height, const void* data, int mipcount)
+{
+    Texture* texture = new Texture(this, format, width, height);
+
+    // Counted like the D3D devices upload it: the given levels, or the whole
+    // chain built from level 0 for Texture_GenMipmaps.
+    if (data && (format & Texture_TypeMask) != Texture_Depth)
+    {
+        int   levels = (format & Texture_GenMipmaps) ? GetNumMipLevels(width, height) : Alg::Max(mipcount, 1);
+        UPInt bytes  = 0;
+        int   w = width, h = height;
+        for (int i = 0; i < levels; i++)
+        {
+            bytes += GetTextureSize(format, w, h);
+            w = Alg::Max(w >> 1, 1);
+            h = Alg::Max(h >> 1, 1);
+        }
+        TotalTextureMemoryUsage += bytes;
+        Record(Command_TextureData, texture, bytes);
+    }
+    return texture;
+}
+
+Render::Shader* RenderDevice::LoadBuiltinShader(ShaderStage stage, int shader)
+{
+    switch (stage)
+    {
+    case Shader_Vertex:
+        return VertexShaders[shader];
+    case Shader_Pixel:
+        return PixelShaders[shader];
+    default:
+        return NULL;
+    }
+}
+
+void RenderDevice::SetRenderTarget(Render::Texture* color, Render::Texture* depth, Render::Texture* stencil)
+{
+    OVR_UNUSED2(depth, stencil);
+    if (BoundRenderTarget != color)
+    {
+        BoundRenderTarget = color;
+        Record(Command_SetRenderTarget, color);
+    }
+}
+
+void RenderDevice::SetDepthMode(bool enable, bool write, CompareFunc func)
+{
+    int mode = enable ? 1 + (write ? 1 : 0) + 2 * func : 0;
+    if (mode != BoundDepthMode)
+    {
+        BoundDepthMode = mode;
+        Record(Command_SetDepthMode, NULL, (UPInt)mode);
+    }
+}
+
+void RenderDevice::SetWorldUniforms(const Matrix4f& proj)
+{
+    if (memcmp(&proj, &BoundProjection, sizeof(proj)))
+    {
+        BoundProjection = proj;
+        Record(Command_SetUniforms, NULL, sizeof(Matrix4f));
+    }
+}
+
+void RenderDevice::SetCommonUniformBuffer(int i, Render::Buffer* buffer)
+{
+    OVR_UNUSED(i);
+    Record(Command_SetUniforms, buffer, buffer ? buffer->GetSize() : 0);
+}
+
+void RenderDevice::Render(const Matrix4f& matrix, Model* model)
+{
+    // Store data in buffers if not already
+    if (!model->VertexBuffer)
+    {
+        Ptr<Render::Buffer> vb = *CreateBuffer();
+        vb->Data(Buffer_Vertex, model->Vertices.GetSize() ? &model->Vertices[0] : NULL,
+                 model->Vertices.GetSize() * sizeof(Vertex));
+        model->VertexBuffer = vb;
+    }
+    if (!model->IndexBuffer)
+    {
+        Ptr<Render::Buffer> ib = *CreateBuffer();
+        ib->Data(Buffer_Index, model->Indices.GetSize() ? &model->Indices[0] : NULL,
+                 model->Indices.GetSize() * 2);
+        model->IndexBuffer = ib;
+    }
+
+    Render(model->Fill ? model->Fill : DefaultFill,
+           model->VertexBuffer, model->IndexBuffer,
+           matrix, 0, (unsigned)model->Indices.GetSize(), model->GetPrimType());
+}
+
+void RenderDevice::Render(const Fill* fill, Render::Buffer* vertices, Render::Buffer* indices,
+                          const Matrix4f& matrix, int offset, int count, PrimitiveType prim)
+{
+    OVR_UNUSED4(vertices, indices, matrix, offset);
+
+    fill->Set(prim);
+    Record(Command_SetUniforms, NULL, DrawUniformBytes);
+    Record(Command_Draw, fill, (UPInt)count);
+}
+
+Fill* RenderDevice::CreateSimpleFill(int flags)
+{
+    OVR_UNUSED(flags);
+    return DefaultFill;
+}
+
+}}} // OVR::Render::Null
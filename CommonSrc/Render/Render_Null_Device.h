@@ -0,0 +1,185 @@
+/************************************************************************************
+
+Filename    :   Render_Null_Device.h
+Content     :   RenderDevice that records commands instead of drawing
+Created     :   October 17, 2026
+Authors     :
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************************/
+
+#ifndef INC_Render_Null_Device_h
+#define INC_Render_Null_Device_h
+
+#include "Render_Device.h"
+
+namespace OVR { namespace Render { namespace Null {
+
+// The null device needs no GPU, window or graphics API. Everything that would be
+// sent to the GPU is appended to a command log and counted, so the cost of scene
+// traversal, culling and submission can be measured on its own ("-r null").
+
+class RenderDevice;
+
+enum CommandType
+{
+    Command_Clear,
+    Command_Draw,
+    Command_SetRenderTarget,
+    Command_SetViewport,
+    Command_SetDepthMode,
+    Command_SetShader,
+    Command_SetTexture,
+    Command_SetUniforms,
+    Command_BufferData,
+    Command_TextureData,
+    Command_Present
+};
+
+struct Command
+{
+    CommandType Type;
+    const void* Object;  // Buffer, texture or shader the command is about, if any.
+    UPInt       Count;   // Indices drawn, or bytes of data sent.
+};
+
+// Totals of one frame's commands. StateChanges counts render target, viewport,
+// depth mode, shader and texture binds that differ from what was bound before.
+struct FrameStats
+{
+    int    Draws;
+    UPInt  Indices;
+    int    StateChanges;
+    UPInt  UniformBytes;
+    UPInt  UploadBytes;
+
+    FrameStats() : Draws(0), Indices(0), StateChanges(0), UniformBytes(0), UploadBytes(0) { }
+};
+
+class Shader : public Render::Shader
+{
+public:
+    RenderDevice* Ren;
+
+    Shader(RenderDevice* r, ShaderStage stage) : Render::Shader(stage), Ren(r) { }
+
+    virtual void Set(PrimitiveType prim) const;
+    virtual void SetUniformBuffer(Render::Buffer* buffer, int i = 0);
+
+protected:
+    virtual bool SetUniform(const char* name, int n, const float* v);
+    virtual bool SetUniform(UniformHandle h, int n, const float* v);
+};
+
+// Keeps its data in memory, so that Map works.
+class Buffer : public Render::Buffer
+{
+public:
+    RenderDevice* Ren;
+    Array<UByte>  Data_;
+    UPInt         MapStart, MapSize;
+
+    Buffer(RenderDevice* r) : Ren(r), MapStart(0), MapSize(0) { }
+
+    virtual size_t GetSize() { return Data_.GetSize(); }
+    virtual void*  Map(size_t start, size_t size, int flags = 0);
+    virtual bool   Unmap(void* m);
+    virtual bool   Data(int use, const void* buffer, size_t size);
+};
+
+// Only the description of a texture; the texels are counted and dropped.
+class Texture : public Render::Texture
+{
+public:
+    RenderDevice* Ren;
+    int           Format;
+    int           Width, Height;
+    int           Samples;
+    int           SampleMode;
+
+    Texture(RenderDevice* r, int format, int w, int h);
+
+    virtual int  GetWidth() const   { return Width; }
+    virtual int  GetHeight() const  { return Height; }
+    virtual int  GetSamples() const { return Samples; }
+
+    virtual void SetSampleMode(int sm) { SampleMode = sm; }
+    virtual void Set(int slot, ShaderStage stage = Shader_Fragment) const;
+};
+
+class RenderDevice : public Render::RenderDevice
+{
+public:
+    enum { MaxTextureSlots = 8 };
+
+    RenderDevice(const RendererParams& p);
+
+    // Ignores the window; the null device has no output.
+    static Render::RenderDevice* CreateDevice(const RendererParams& rp, void* oswnd);
+
+    // Commands and totals of the last presented frame. Keeping the log can be
+    // turned off when only the totals are needed.
+    const Array<Command>& GetCommandLog() const  { return LastFrameLog; }
+    const FrameStats&     GetFrameStats() const  { return LastFrameStats; }
+    int                   GetFramesPresented() const { return FramesPresented; }
+    void                  SetKeepCommandLog(bool keep) { KeepCommandLog = keep; }
+
+    void         Record(CommandType type, const void* object = NULL, UPInt count = 0);
+    void         BindShader(const Shader* shader);
+    void         BindTexture(int slot, const Texture* texture);
+
+    virtual void SetMultipleViewports(int n, const Viewport* vps);
+    virtual void Clear(float r = 0, float g = 0, float b = 0, float a = 1, float depth = 1);
+    virtual void Rect(float left, float top, float right, float bottom);
+    virtual void Present();
+
+    virtual Render::Buffer*  CreateBuffer();
+    virtual Render::Texture* CreateTexture(int format, int width, int height, const void* data, int mipcount = 1);
+    virtual Render::Shader*  LoadBuiltinShader(ShaderStage stage, int shader);
+
+    virtual void SetRenderTarget(Render::Texture* color, Render::Texture* depth = NULL,
+                                 Render::Texture* stencil = NULL);
+    virtual void SetDepthMode(bool enable, bool write, CompareFunc func = Compare_Less);
+    virtual void SetWorldUniforms(const Matrix4f& proj);
+    virtual void SetCommonUniformBuffer(int i, Render::Buffer* buffer);
+
+    virtual void Render(const Matrix4f& matrix, Model* model);
+    virtual void Render(const Fill* fill, Render::Buffer* vertices, Render::Buffer* indices,
+                        const Matrix4f& matrix, int offset, int count, PrimitiveType prim = Prim_Triangles);
+
+    virtual Fill* CreateSimpleFill(int flags = Fill::F_Solid);
+
+private:
+    Ptr<Shader>           VertexShaders[VShader_Count];
+    Ptr<Shader>           PixelShaders[FShader_Count];
+    Ptr<Fill>             DefaultFill;
+
+    // What is bound, for counting state changes.
+    const Shader*         BoundShaders[Shader_Count];
+    const Texture*        BoundTextures[MaxTextureSlots];
+    const Render::Texture* BoundRenderTarget;
+    int                   BoundDepthMode;
+    Matrix4f              BoundProjection;
+
+    bool                  KeepCommandLog;
+    Array<Command>        FrameLog, LastFrameLog;
+    FrameStats            Stats, LastFrameStats;
+    int                   FramesPresented;
+};
+
+}}} // OVR::Render::Null
+
+#endif // INC_Render_Null_Device_h
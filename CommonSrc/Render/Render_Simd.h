@@ -0,0 +1,121 @@
+/************************************************************************************
+
+Filename    :   Render_Simd.h
+Content     :   SIMD intrinsics selection and CPU feature checks for CPU-side
+                image and geometry kernels
+Created     :   October 17, 2026
+Authors     :
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************************/
+
+#ifndef INC_Render_Simd_h
+#define INC_Render_Simd_h
+
+#include "Kernel/OVR_Types.h"
+
+// OVR_RENDER_SSE2 is defined when SSE2 can be used unconditionally: on x64, and on
+// 32-bit x86 built with /arch:SSE2 (which the Win32 project configurations set) or
+// -msse2. Without it every kernel runs its scalar version. SSSE3 and AVX2 kernels
+// are compiled alongside it and selected at run time with the checks below.
+// OVR_RENDER_AVX2_INTRINSICS is defined when the compiler has the AVX2 integer
+// intrinsics, which Visual C++ first shipped in 2012; kernels that need them fall
+// back to SSE2 without it.
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define OVR_RENDER_SSE2
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include <immintrin.h>
+#if defined(OVR_CC_MSVC)
+#include <intrin.h>
+#define OVR_RENDER_TARGET_SSSE3
+#define OVR_RENDER_TARGET_AVX2
+#else
+#include <cpuid.h>
+#define OVR_RENDER_TARGET_SSSE3 __attribute__((target("ssse3")))
+#define OVR_RENDER_TARGET_AVX2  __attribute__((target("avx2")))
+#endif
+#if !defined(OVR_CC_MSVC) || (_MSC_VER >= 1700)
+#define OVR_RENDER_AVX2_INTRINSICS
+#endif
+#endif
+
+namespace OVR { namespace Render {
+
+enum CpuFeatureFlags
+{
+    CpuFeature_SSSE3 = 0x01,
+    CpuFeature_AVX2  = 0x02
+};
+
+#if defined(OVR_RENDER_SSE2)
+
+inline int DetectCpuFeatures()
+{
+    int features = 0;
+    unsigned regs[4] = { 0, 0, 0, 0 };
+
+#if defined(OVR_CC_MSVC)
+    __cpuid((int*)regs, 0);
+    unsigned maxLeaf = regs[0];
+    __cpuid((int*)regs, 1);
+#else
+    unsigned maxLeaf = __get_cpuid_max(0, NULL);
+    __cpuid(1, regs[0], regs[1], regs[2], regs[3]);
+#endif
+    if (regs[2] & (1u << 9))
+        features |= CpuFeature_SSSE3;
+
+    // AVX2 needs OS support for the YMM state (OSXSAVE + XCR0) as well as the CPUID bit.
+    bool osSavesYmm = false;
+    if ((regs[2] & (1u << 27)) && (regs[2] & (1u << 28)))
+    {
+#if defined(OVR_CC_MSVC) && (_MSC_VER >= 1600) && !(defined(_MSC_FULL_VER) && _MSC_FULL_VER < 160040219)
+        osSavesYmm = (_xgetbv(0) & 6) == 6;
+#elif !defined(OVR_CC_MSVC)
+        unsigned eax, edx;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        osSavesYmm = (eax & 6) == 6;
+#endif
+    }
+    if (osSavesYmm && maxLeaf >= 7)
+    {
+#if defined(OVR_CC_MSVC)
+        __cpuidex((int*)regs, 7, 0);
+#else
+        __cpuid_count(7, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+        if (regs[1] & (1u << 5))
+            features |= CpuFeature_AVX2;
+    }
+    return features;
+}
+
+inline int GetCpuFeatures()
+{
+    static int features = DetectCpuFeatures();
+    return features;
+}
+
+#else
+
+inline int GetCpuFeatures() { return 0; }
+
+#endif
+
+}} // OVR::Render
+
+#endif // INC_Render_Simd_h
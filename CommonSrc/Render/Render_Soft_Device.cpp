@@ -0,0 +1,1342 @@
+/************************************************************************************
+
+Filename    :   Render_Soft_Device.cpp
+Content     :   Tile based software rasterizer RenderDevice
+Created     :   October 17, 2026
+Authors     :
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************************/
+
+#include "Render_Soft_Device.h"
+
+#include <math.h>
+#include <string.h>
+
+#if defined(OVR_OS_WIN32)
+#include <windows.h>
+#endif
+
+namespace OVR { namespace Render { namespace Soft {
+
+// Triangles are clipped to this many times the viewport, in clip space, so that
+// fixed point edge functions can't overflow.
+static const float GuardBand    = 8.0f;
+static const int   SubpixelBits = 4;
+static const int   Subpixels    = 1 << SubpixelBits;
+
+enum VaryingGroups
+{
+    VaryingGroup_Color     = 1,
+    VaryingGroup_TexCoord  = 2,
+    VaryingGroup_TexCoord1 = 4,
+    VaryingGroup_Lighting  = 8     // Normal and VPos.
+};
+
+static int GetVaryingMask(int pixelShader)
+{
+    switch (pixelShader)
+    {
+    case FShader_Gouraud:      return VaryingGroup_Color;
+    case FShader_Texture:
+    case FShader_AlphaTexture: return VaryingGroup_Color | VaryingGroup_TexCoord;
+    case FShader_PostProcess:  return VaryingGroup_TexCoord;
+    case FShader_LitGouraud:   return VaryingGroup_Color | VaryingGroup_Lighting;
+    case FShader_LitTexture:   return VaryingGroup_Color | VaryingGroup_TexCoord | VaryingGroup_Lighting;
+    case FShader_MultiTexture: return VaryingGroup_TexCoord | VaryingGroup_TexCoord1;
+    default:                   return 0;
+    }
+}
+
+// The varyings stored per triangle for a mask, as ranges of ClipVertex::Varyings.
+static int GetVaryingRanges(int mask, int* starts, int* counts)
+{
+    int n = 0;
+    if (mask & VaryingGroup_Color)     { starts[n] = Varying_Color;     counts[n++] = 4; }
+    if (mask & VaryingGroup_TexCoord)  { starts[n] = Varying_TexCoord;  counts[n++] = 2; }
+    if (mask & VaryingGroup_TexCoord1) { starts[n] = Varying_TexCoord1; counts[n++] = 2; }
+    if (mask & VaryingGroup_Lighting)  { starts[n] = Varying_Normal;    counts[n++] = 6; }
+    return n;
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** Shader, Buffer and Texture
+
+void Shader::Set(PrimitiveType prim) const
+{
+    OVR_UNUSED(prim);
+    Ren->BindShader(this);
+}
+
+bool Shader::SetUniform(const char* name, int n, const float* v)
+{
+    return SetUniform(UniformHandle(name), n, v);
+}
+
+bool Shader::SetUniform(UniformHandle h, int n, const float* v)
+{
+    n = Alg::Min(n, 16);
+    for (UPInt i = 0; i < Uniforms.GetSize(); i++)
+    {
+        if (Uniforms[i].Handle == h)
+        {
+            memcpy(Uniforms[i].Value, v, n * sizeof(float));
+            return true;
+        }
+    }
+
+    Uniform u;
+    u.Handle = h;
+    memset(u.Value, 0, sizeof(u.Value));
+    memcpy(u.Value, v, n * sizeof(float));
+    Uniforms.PushBack(u);
+    return true;
+}
+
+bool Shader::GetUniform(const char* name, int n, float* v) const
+{
+    UniformHandle h(name);
+    for (UPInt i = 0; i < Uniforms.GetSize(); i++)
+    {
+        if (Uniforms[i].Handle == h)
+        {
+            memcpy(v, Uniforms[i].Value, Alg::Min(n, 16) * sizeof(float));
+            return true;
+        }
+    }
+    return false;
+}
+
+void* Buffer::Map(size_t start, size_t size, int flags)
+{
+    OVR_UNUSED(flags);
+    if (start + size > Data_.GetSize() || size == 0)
+    {
+        return NULL;
+    }
+    return &Data_[start];
+}
+
+bool Buffer::Data(int use, const void* buffer, size_t size)
+{
+    OVR_UNUSED(use);
+    Data_.Resize(size);
+    if (buffer && size)
+    {
+        memcpy(&Data_[0], buffer, size);
+    }
+    return true;
+}
+
+Texture::Texture(RenderDevice* r, int format, int w, int h)
+    : Ren(r), Format(format), Width(w), Height(h), LevelCount(1), SampleMode(Sample_Linear)
+{
+}
+
+void Texture::Set(int slot, ShaderStage stage) const
+{
+    if (stage == Shader_Fragment)
+    {
+        Ren->BindTexture(slot, this);
+    }
+}
+
+const UByte* Texture::GetLevel(int level, int* w, int* h) const
+{
+    const UByte* texels = &Texels[0];
+    int          lw = Width, lh = Height;
+    for (int i = 0; i < level; i++)
+    {
+        texels += (UPInt)lw * lh * 4;
+        lw = Alg::Max(lw >> 1, 1);
+        lh = Alg::Max(lh >> 1, 1);
+    }
+    *w = lw;
+    *h = lh;
+    return texels;
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** Pixel shading
+
+struct Float4
+{
+    float R, G, B, A;
+};
+
+static inline int WrapTexel(int i, int size, int addressMode, bool* border)
+{
+    if (i >= 0 && i < size)
+    {
+        return i;
+    }
+    switch (addressMode)
+    {
+    case Sample_Clamp:
+        return i < 0 ? 0 : size - 1;
+    case Sample_ClampBorder:
+        *border = true;
+        return 0;
+    default:
+        i %= size;
+        return i < 0 ? i + size : i;
+    }
+}
+
+static inline void FetchTexel(const UByte* texels, int w, int h, int x, int y, int addressMode, float* out)
+{
+    bool border = false;
+    x = WrapTexel(x, w, addressMode, &border);
+    y = WrapTexel(y, h, addressMode, &border);
+    if (border)
+    {
+        out[0] = out[1] = out[2] = out[3] = 0;
+        return;
+    }
+    const UByte* t = texels + ((UPInt)y * w + x) * 4;
+    const float  s = 1.0f / 255.0f;
+    out[0] = t[0] * s;
+    out[1] = t[1] * s;
+    out[2] = t[2] * s;
+    out[3] = t[3] * s;
+}
+
+// lod is log2 of the texels covered by a pixel, on level 0.
+static Float4 SampleTexture(const Texture* tex, float u, float v, float lod)
+{
+    Float4 c = { 1, 1, 1, 1 };
+    if (!tex || !tex->Texels.GetSize())
+    {
+        return c;
+    }
+
+    int level = 0;
+    if (lod > 0.5f && tex->LevelCount > 1)
+    {
+        level = Alg::Min((int)(lod + 0.5f), tex->LevelCount - 1);
+    }
+
+    int          w, h;
+    const UByte* texels      = tex->GetLevel(level, &w, &h);
+    int          addressMode = tex->SampleMode & Sample_AddressMask;
+    float        x           = u * w;
+    float        y           = v * h;
+
+    if ((tex->SampleMode & Sample_FilterMask) == Sample_Nearest)
+    {
+        FetchTexel(texels, w, h, (int)floorf(x), (int)floorf(y), addressMode, &c.R);
+        return c;
+    }
+
+    x -= 0.5f;
+    y -= 0.5f;
+    float x0 = floorf(x), y0 = floorf(y);
+    float fx = x - x0,    fy = y - y0;
+    int   ix = (int)x0,   iy = (int)y0;
+
+    float t00[4], t10[4], t01[4], t11[4];
+    FetchTexel(texels, w, h, ix,     iy,     addressMode, t00);
+    FetchTexel(texels, w, h, ix + 1, iy,     addressMode, t10);
+    FetchTexel(texels, w, h, ix,     iy + 1, addressMode, t01);
+    FetchTexel(texels, w, h, ix + 1, iy + 1, addressMode, t11);
+
+    float* out = &c.R;
+    for (int i = 0; i < 4; i++)
+    {
+        float top    = t00[i] + (t10[i] - t00[i]) * fx;
+        float bottom = t01[i] + (t11[i] - t01[i]) * fx;
+        out[i] = top + (bottom - top) * fy;
+    }
+    return c;
+}
+
+static inline float Saturate(float x)
+{
+    return x < 0 ? 0 : (x > 1 ? 1 : x);
+}
+
+// DoLight of the D3D lighting shaders.
+static Float4 DoLight(const LightingParams& lighting, const float* color, const float* normal, const float* vpos)
+{
+    Vector3f norm(normal[0], normal[1], normal[2]);
+    norm.Normalize();
+
+    Vector3f light(lighting.Ambient.x, lighting.Ambient.y, lighting.Ambient.z);
+    int      lightCount = (int)lighting.LightCount;
+    for (int i = 0; i < lightCount; i++)
+    {
+        const Vector4f& lp    = lighting.LightPos[i];
+        Vector3f        ltp   = Vector3f(lp.x - vpos[0], lp.y - vpos[1], lp.z - vpos[2]);
+        float           ldist = ltp.Dot(ltp);
+        ltp.Normalize();
+        float           scale = norm.Dot(ltp) / sqrtf(ldist);
+        const Vector4f& lc    = lighting.LightColor[i];
+        light.x += Saturate(lc.x * color[0] * scale);
+        light.y += Saturate(lc.y * color[1] * scale);
+        light.z += Saturate(lc.z * color[2] * scale);
+    }
+
+    Float4 c = { light.x, light.y, light.z, color[3] };
+    return c;
+}
+
+// Render target and depth buffer of a tile.
+struct TileTarget
+{
+    UByte* Color;
+    float* Depth;
+    int    Pitch;
+};
+
+// Varyings of the pixel being shaded, and what the texture lookup needs for
+// picking a mip level.
+struct PixelInputs
+{
+    float        V[Varying_Count];
+    float        W;
+    const float* TexCoordPlanes;    // u/w, v/w planes
+    const float* OowPlane;
+    float        Fx, Fy;
+};
+
+static float GetTextureLod(const Texture* tex, const PixelInputs& in, const float* uvPlanes)
+{
+    if (!tex || tex->LevelCount <= 1)
+    {
+        return 0;
+    }
+
+    // d(u/w)/dx = A_u and d(1/w)/dx = A_q, so du/dx = (A_u - u * A_q) * w.
+    float u = in.V[Varying_TexCoord], v = in.V[Varying_TexCoord + 1];
+    if (uvPlanes != in.TexCoordPlanes)
+    {
+        u = in.V[Varying_TexCoord1];
+        v = in.V[Varying_TexCoord1 + 1];
+    }
+    const float* q    = in.OowPlane;
+    float        dudx = (uvPlanes[0] - u * q[0]) * in.W * tex->Width;
+    float        dudy = (uvPlanes[1] - u * q[1]) * in.W * tex->Width;
+    float        dvdx = (uvPlanes[3] - v * q[0]) * in.W * tex->Height;
+    float        dvdy = (uvPlanes[4] - v * q[1]) * in.W * tex->Height;
+    float        rho2 = Alg::Max(dudx * dudx + dvdx * dvdx, dudy * dudy + dvdy * dvdy);
+    return rho2 > 1.0f ? 0.5f * logf(rho2) * 1.44269504f : 0;
+}
+
+// Returns false if the pixel is discarded.
+template<int PixelShader>
+static inline bool ShadePixel(const DrawState& s, const LightingParams* lighting, const PixelInputs& in,
+                              const float* uv1Planes, Float4* out)
+{
+    const float* v = in.V;
+    switch (PixelShader)
+    {
+    case FShader_Solid:
+        out->R = s.Color[0]; out->G = s.Color[1]; out->B = s.Color[2]; out->A = s.Color[3];
+        return true;
+
+    case FShader_Gouraud:
+        out->R = v[0]; out->G = v[1]; out->B = v[2]; out->A = v[3];
+        return true;
+
+    case FShader_Texture:
+    {
+        Float4 t = SampleTexture(s.Textures[0], v[Varying_TexCoord], v[Varying_TexCoord + 1],
+                                 GetTextureLod(s.Textures[0], in, in.TexCoordPlanes));
+        out->R = v[0] * t.R; out->G = v[1] * t.G; out->B = v[2] * t.B; out->A = v[3] * t.A;
+        return out->A > 0.4f;
+    }
+
+    case FShader_AlphaTexture:
+    {
+        Float4 t = SampleTexture(s.Textures[0], v[Varying_TexCoord], v[Varying_TexCoord + 1],
+                                 GetTextureLod(s.Textures[0], in, in.TexCoordPlanes));
+        out->R = v[0]; out->G = v[1]; out->B = v[2]; out->A = v[3] * t.R;
+        return true;
+    }
+
+    case FShader_PostProcess:
+    {
+        // HmdWarp of the D3D post process shader.
+        const float* d      = s.Distortion;
+        float        thetaX = (v[Varying_TexCoord]     - d[0]) * d[6];
+        float        thetaY = (v[Varying_TexCoord + 1] - d[1]) * d[7];
+        float        rSq    = thetaX * thetaX + thetaY * thetaY;
+        float        scale  = d[8] + d[9] * rSq + d[10] * rSq * rSq + d[11] * rSq * rSq * rSq;
+        float        tcX    = d[0] + d[4] * thetaX * scale;
+        float        tcY    = d[1] + d[5] * thetaY * scale;
+        if (tcX < d[2] - 0.25f || tcX > d[2] + 0.25f || tcY < d[3] - 0.5f || tcY > d[3] + 0.5f)
+        {
+            out->R = out->G = out->B = out->A = 0;
+            return true;
+        }
+        *out = SampleTexture(s.Textures[0], tcX, tcY, 0);
+        return true;
+    }
+
+    case FShader_LitGouraud:
+    {
+        Float4 l = DoLight(*lighting, v, v + Varying_Normal, v + Varying_VPos);
+        out->R = l.R * v[0]; out->G = l.G * v[1]; out->B = l.B * v[2]; out->A = l.A * v[3];
+        return true;
+    }
+
+    case FShader_LitTexture:
+    {
+        Float4 l = DoLight(*lighting, v, v + Varying_Normal, v + Varying_VPos);
+        Float4 t = SampleTexture(s.Textures[0], v[Varying_TexCoord], v[Varying_TexCoord + 1],
+                                 GetTextureLod(s.Textures[0], in, in.TexCoordPlanes));
+        out->R = l.R * t.R; out->G = l.G * t.G; out->B = l.B * t.B; out->A = l.A * t.A;
+        return true;
+    }
+
+    case FShader_MultiTexture:
+    {
+        Float4 c1 = SampleTexture(s.Textures[0], v[Varying_TexCoord], v[Varying_TexCoord + 1],
+                                  GetTextureLod(s.Textures[0], in, in.TexCoordPlanes));
+        Float4 c2 = SampleTexture(s.Textures[1], v[Varying_TexCoord1], v[Varying_TexCoord1 + 1],
+                                  GetTextureLod(s.Textures[1], in, uv1Planes));
+        float  len   = Saturate(sqrtf(c2.R * c2.R + c2.G * c2.G + c2.B * c2.B));
+        float  boost = 1.2f + (1.9f - 1.2f) * len;
+        out->R = c1.R * c2.R * boost; out->G = c1.G * c2.G * boost; out->B = c1.B * c2.B * boost;
+        out->A = c1.A * c2.A;
+        return out->A > 0.4f;
+    }
+    }
+    return false;
+}
+
+static inline UByte ToUByte(float x)
+{
+    return (UByte)(Saturate(x) * 255.0f + 0.5f);
+}
+
+template<int PixelShader>
+static void RasterizeTriangle(const TileTarget& target, const Triangle& tri, const DrawState& s,
+                              const LightingParams* lighting, const float* planes,
+                              int minX, int minY, int maxX, int maxY)
+{
+    int starts[4], counts[4];
+    int ranges = GetVaryingRanges(s.VaryingMask, starts, counts);
+
+    const float* zPlane    = planes;
+    const float* oowPlane  = planes + 3;
+    const float* varyings  = planes + 6;
+    const float* uv1Planes = NULL;
+
+    PixelInputs in;
+    in.OowPlane       = oowPlane;
+    in.TexCoordPlanes = NULL;
+    {
+        const float* p = varyings;
+        for (int r = 0; r < ranges; r++)
+        {
+            if (starts[r] == Varying_TexCoord)
+                in.TexCoordPlanes = p;
+            if (starts[r] == Varying_TexCoord1)
+                uv1Planes = p;
+            p += counts[r] * 3;
+        }
+    }
+
+    const SInt64 stepX[3] = { (SInt64)tri.EdgeDx[0], (SInt64)tri.EdgeDx[1], (SInt64)tri.EdgeDx[2] };
+
+    for (int y = minY; y <= maxY; y++)
+    {
+        SInt64 e[3];
+        for (int i = 0; i < 3; i++)
+        {
+            e[i] = tri.EdgeC[i] + (SInt64)tri.EdgeDx[i] * minX + (SInt64)tri.EdgeDy[i] * y;
+        }
+
+        UByte* colorRow = target.Color + (UPInt)y * target.Pitch * 4;
+        float* depthRow = target.Depth ? target.Depth + (UPInt)y * target.Pitch : NULL;
+        in.Fy = (float)y + 0.5f - tri.RefY;
+
+        for (int x = minX; x <= maxX; x++, e[0] += stepX[0], e[1] += stepX[1], e[2] += stepX[2])
+        {
+            if ((e[0] | e[1] | e[2]) < 0)
+            {
+                continue;
+            }
+
+            in.Fx   = (float)x + 0.5f - tri.RefX;
+            float z = zPlane[0] * in.Fx + zPlane[1] * in.Fy + zPlane[2];
+            if (z < 0 || z > 1)
+            {
+                continue;
+            }
+
+            float* depth = depthRow ? depthRow + x : NULL;
+            if (s.DepthTest && depth &&
+                ((s.DepthFunc == RenderDevice::Compare_Less    && !(z < *depth)) ||
+                 (s.DepthFunc == RenderDevice::Compare_Greater && !(z > *depth))))
+            {
+                continue;
+            }
+
+            float oow = oowPlane[0] * in.Fx + oowPlane[1] * in.Fy + oowPlane[2];
+            in.W      = 1.0f / oow;
+
+            const float* p = varyings;
+            for (int r = 0; r < ranges; r++)
+            {
+                float* out = in.V + starts[r];
+                for (int i = 0; i < counts[r]; i++, p += 3)
+                {
+                    out[i] = (p[0] * in.Fx + p[1] * in.Fy + p[2]) * in.W;
+                }
+            }
+
+            Float4 c;
+            if (!ShadePixel<PixelShader>(s, lighting, in, uv1Planes, &c))
+            {
+                continue;
+            }
+
+            if (s.DepthTest && s.DepthWrite && depth)
+            {
+                *depth = z;
+            }
+
+            UByte* dest = colorRow + x * 4;
+            if (s.Blend)
+            {
+                float a   = Saturate(c.A);
+                float inv = (1.0f - a) * (1.0f / 255.0f);
+                dest[0] = ToUByte(c.R * a + dest[0] * inv);
+                dest[1] = ToUByte(c.G * a + dest[1] * inv);
+                dest[2] = ToUByte(c.B * a + dest[2] * inv);
+                dest[3] = ToUByte(c.A * a + dest[3] * inv);
+            }
+            else
+            {
+                dest[0] = ToUByte(c.R);
+                dest[1] = ToUByte(c.G);
+                dest[2] = ToUByte(c.B);
+                dest[3] = ToUByte(c.A);
+            }
+        }
+    }
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** RenderDevice
+
+RenderDevice::RenderDevice(const RendererParams& p, void* window, int threadCount)
+    : Window(window), NumViewports(1), DepthTest(true), DepthWrite(true), Blend(false),
+      DepthFunc(Compare_Less), LightingChanged(true), TilesX(0), TilesY(0)
+{
+    Params  = p;
+    Workers = *new WorkerPool(threadCount);
+
+    for (int i = 0; i < VShader_Count; i++)
+    {
+        VertexShaders[i] = *new Shader(this, Shader_Vertex, i);
+    }
+    for (int i = 0; i < FShader_Count; i++)
+    {
+        PixelShaders[i] = *new Shader(this, Shader_Fragment, i);
+    }
+
+    Ptr<ShaderSet> gouraudShaders = *new ShaderSet();
+    gouraudShaders->SetShader(VertexShaders[VShader_MVP]);
+    gouraudShaders->SetShader(PixelShaders[FShader_Gouraud]);
+    DefaultFill = *new ShaderFill(gouraudShaders);
+
+    memset(BoundShaders, 0, sizeof(BoundShaders));
+    memset(BoundTextures, 0, sizeof(BoundTextures));
+    Viewports[0] = Viewports[1] = Viewport(0, 0, 0, 0);
+    ScissorX0 = ScissorY0 = 0;
+    ScissorX1 = ScissorY1 = -1;
+
+#if defined(OVR_OS_WIN32)
+    if (window)
+    {
+        RECT rc;
+        GetClientRect((HWND)window, &rc);
+        SetWindowSize(rc.right - rc.left, rc.bottom - rc.top);
+    }
+#endif
+}
+
+RenderDevice::~RenderDevice()
+{
+    Shutdown();
+}
+
+Render::RenderDevice* RenderDevice::CreateDevice(const RendererParams& rp, void* oswnd)
+{
+    return new RenderDevice(rp, oswnd);
+}
+
+void RenderDevice::BindShader(const Shader* shader)
+{
+    BoundShaders[shader->GetStage()] = shader;
+}
+
+void RenderDevice::BindTexture(int slot, const Texture* texture)
+{
+    if (slot >= 0 && slot < 2)
+    {
+        BoundTextures[slot] = texture;
+    }
+}
+
+void RenderDevice::SetWindowSize(int w, int h)
+{
+    if (BackBuffer && w == WindowWidth && h == WindowHeight)
+    {
+        return;
+    }
+    Flush();
+
+    Render::RenderDevice::SetWindowSize(w, h);
+    bool targetIsBackBuffer = !CurTarget || CurTarget == BackBuffer;
+    BackBuffer = *(Texture*)CreateTexture(Texture_RGBA | Texture_RenderTarget, w, h, NULL);
+    if (targetIsBackBuffer)
+    {
+        SetRenderTarget(NULL);
+    }
+}
+
+void RenderDevice::SetMultipleViewports(int n, const Viewport* vps)
+{
+    NumViewports = Alg::Min(Alg::Max(n, 1), 2);
+    for (int i = 0; i < NumViewports; i++)
+    {
+        Viewports[i] = vps[i];
+    }
+
+    // Pixels outside of the first viewport and the target are never touched.
+    int w = CurTarget ? CurTarget->Width : 0, h = CurTarget ? CurTarget->Height : 0;
+    ScissorX0 = Alg::Max(Viewports[0].x, 0);
+    ScissorY0 = Alg::Max(Viewports[0].y, 0);
+    ScissorX1 = Alg::Min(Viewports[0].x + Viewports[0].w, w) - 1;
+    ScissorY1 = Alg::Min(Viewports[0].y + Viewports[0].h, h) - 1;
+}
+
+Texture* RenderDevice::GetDepthBuffer(int w, int h)
+{
+    for (UPInt i = 0; i < DepthBuffers.GetSize(); i++)
+    {
+        if (DepthBuffers[i]->Width == w && DepthBuffers[i]->Height == h)
+        {
+            return DepthBuffers[i];
+        }
+    }
+
+    Ptr<Texture> depth = *(Texture*)CreateTexture(Texture_Depth | Texture_RenderTarget, w, h, NULL);
+    DepthBuffers.PushBack(depth);
+    return depth;
+}
+
+void RenderDevice::SetRenderTarget(Render::Texture* color, Render::Texture* depth, Render::Texture* stencil)
+{
+    OVR_UNUSED(stencil);
+    Flush();
+
+    CurTarget = color ? (Texture*)color : BackBuffer.GetPtr();
+    if (!CurTarget)
+    {
+        CurDepth = NULL;
+        TilesX = TilesY = 0;
+        return;
+    }
+    CurDepth = depth ? (Texture*)depth : GetDepthBuffer(CurTarget->Width, CurTarget->Height);
+
+    TilesX = (CurTarget->Width  + TileSize - 1) / TileSize;
+    TilesY = (CurTarget->Height + TileSize - 1) / TileSize;
+    Bins.Resize(TilesX * TilesY);
+
+    SetMultipleViewports(NumViewports, Viewports);
+}
+
+void RenderDevice::Clear(float r, float g, float b, float a, float depth)
+{
+    if (!CurTarget)
+    {
+        return;
+    }
+    Flush();
+
+    const UByte color[4] = { ToUByte(r), ToUByte(g), ToUByte(b), ToUByte(a) };
+    const int   w = CurTarget->Width, h = CurTarget->Height;
+
+    // Like the D3D devices, clears only the viewports.
+    for (int i = 0; i < NumViewports; i++)
+    {
+        const Viewport& vp = Viewports[i];
+        int x0 = Alg::Max(vp.x, 0), x1 = Alg::Min(vp.x + vp.w, w);
+        int y0 = Alg::Max(vp.y, 0), y1 = Alg::Min(vp.y + vp.h, h);
+        for (int y = y0; y < y1; y++)
+        {
+            UByte* row = &CurTarget->Texels[((UPInt)y * w + x0) * 4];
+            for (int x = x0; x < x1; x++, row += 4)
+            {
+                memcpy(row, color, 4);
+            }
+            if (CurDepth && CurDepth->Width == w && CurDepth->Height == h)
+            {
+                float* depthRow = &CurDepth->Depth[(UPInt)y * w];
+                for (int x = x0; x < x1; x++)
+                {
+                    depthRow[x] = depth;
+                }
+            }
+        }
+    }
+}
+
+void RenderDevice::Present()
+{
+    Flush();
+
+#if defined(OVR_OS_WIN32)
+    // GDI takes BGRA; a negative height makes the rows top-down.
+    if (Window && BackBuffer)
+    {
+        const int w = BackBuffer->Width, h = BackBuffer->Height;
+        PresentPixels.Resize((UPInt)w * h * 4);
+        const UByte* src  = &BackBuffer->Texels[0];
+        UByte*       dest = &PresentPixels[0];
+        for (UPInt i = 0; i < PresentPixels.GetSize(); i += 4)
+        {
+            dest[i]     = src[i + 2];
+            dest[i + 1] = src[i + 1];
+            dest[i + 2] = src[i];
+            dest[i + 3] = 255;
+        }
+
+        BITMAPINFO bmi;
+        memset(&bmi, 0, sizeof(bmi));
+        bmi.bmiHeader.biSize        = sizeof(BITMAPINFOHEADER);
+        bmi.bmiHeader.biWidth       = w;
+        bmi.bmiHeader.biHeight      = -h;
+        bmi.bmiHeader.biPlanes      = 1;
+        bmi.bmiHeader.biBitCount    = 32;
+        bmi.bmiHeader.biCompression = BI_RGB;
+
+        HDC dc = GetDC((HWND)Window);
+        StretchDIBits(dc, 0, 0, w, h, 0, 0, w, h, dest, &bmi, DIB_RGB_COLORS, SRCCOPY);
+        ReleaseDC((HWND)Window, dc);
+    }
+#endif
+}
+
+Render::Buffer* RenderDevice::CreateBuffer()
+{
+    return new Buffer;
+}
+
+Render::Texture* RenderDevice::CreateTexture(int format, int width, int height, const void* data, int mipcount)
+{
+    Texture* tex  = new Texture(this, format, width, height);
+    int      type = format & Texture_TypeMask;
+
+    if (type == Texture_Depth)
+    {
+        tex->Depth.Resize((UPInt)width * height);
+        return tex;
+    }
+
+    int levels = 1;
+    if (data && (format & Texture_GenMipmaps))
+    {
+        levels = GetNumMipLevels(width, height);
+    }
+    else if (data)
+    {
+        levels = Alg::Max(mipcount, 1);
+    }
+    tex->LevelCount = levels;
+    tex->Texels.Resize((UPInt)(levels > 1 ? GetMipChainSize(width, height) : width * height * 4));
+    memset(&tex->Texels[0], 0, tex->Texels.GetSize());
+
+    // Converts each level given to rgba; generated mips are filtered from level 0.
+    const UByte* src   = (const UByte*)data;
+    UByte*       dest  = &tex->Texels[0];
+    int          given = (format & Texture_GenMipmaps) ? 1 : levels;
+    int          w = width, h = height;
+    for (int i = 0; src && i < given; i++)
+    {
+        UPInt texels = (UPInt)w * h;
+        switch (type)
+        {
+        case Texture_RGBA:
+            memcpy(dest, src, texels * 4);
+            break;
+        case Texture_R:
+            for (UPInt t = 0; t < texels; t++)
+            {
+                dest[t * 4]     = src[t];
+                dest[t * 4 + 3] = 255;
+            }
+            break;
+        case Texture_DXT1:
+        case Texture_DXT5:
+            DecompressBlocks(src, w, h, type, dest);
+            break;
+        default:
+            memset(dest, 255, texels * 4);
+            break;
+        }
+
+        src  += GetTextureSize(format, w, h);
+        dest += texels * 4;
+        w = Alg::Max(w >> 1, 1);
+        h = Alg::Max(h >> 1, 1);
+    }
+
+    if (src && (format & Texture_GenMipmaps))
+    {
+        BuildMipChain(&tex->Texels[0], width, height, &tex->Texels[0], 0, Workers);
+    }
+
+    TotalTextureMemoryUsage += tex->Texels.GetSize();
+    return tex;
+}
+
+Render::Shader* RenderDevice::LoadBuiltinShader(ShaderStage stage, int shader)
+{
+    switch (stage)
+    {
+    case Shader_Vertex:
+        return VertexShaders[shader];
+    case Shader_Pixel:
+        return PixelShaders[shader];
+    default:
+        return NULL;
+    }
+}
+
+void RenderDevice::SetDepthMode(bool enable, bool write, CompareFunc func)
+{
+    DepthTest  = enable && func != Compare_Always;
+    DepthWrite = enable && write;
+    DepthFunc  = func;
+
+    // Compare_Always still writes depth.
+    if (enable && write && func == Compare_Always)
+    {
+        DepthTest = true;
+    }
+}
+
+void RenderDevice::SetWorldUniforms(const Matrix4f& proj)
+{
+    StdProj = proj;
+}
+
+void RenderDevice::SetCommonUniformBuffer(int i, Render::Buffer* buffer)
+{
+    if (i == 1 && buffer && buffer->GetSize() >= sizeof(LightingParams))
+    {
+        memcpy(&Lighting, &((Buffer*)buffer)->Data_[0], sizeof(LightingParams));
+        LightingChanged = true;
+    }
+}
+
+void RenderDevice::FillRect(float left, float top, float right, float bottom, Color c)
+{
+    Blend = true;
+    Render::RenderDevice::FillRect(left, top, right, bottom, c);
+    Blend = false;
+}
+
+void RenderDevice::RenderText(const struct Font* font, const char* str, float x, float y, float size, Color c)
+{
+    Blend = true;
+    Render::RenderDevice::RenderText(font, str, x, y, size, c);
+    Blend = false;
+}
+
+Fill* RenderDevice::CreateSimpleFill(int flags)
+{
+    OVR_UNUSED(flags);
+    return DefaultFill;
+}
+
+void RenderDevice::Render(const Matrix4f& matrix, Model* model)
+{
+    // Store data in buffers if not already
+    if (!model->VertexBuffer)
+    {
+        Ptr<Render::Buffer> vb = *CreateBuffer();
+        vb->Data(Buffer_Vertex, model->Vertices.GetSize() ? &model->Vertices[0] : NULL,
+                 model->Vertices.GetSize() * sizeof(Vertex));
+        model->VertexBuffer = vb;
+    }
+    if (!model->IndexBuffer)
+    {
+        Ptr<Render::Buffer> ib = *CreateBuffer();
+        ib->Data(Buffer_Index, model->Indices.GetSize() ? &model->Indices[0] : NULL,
+                 model->Indices.GetSize() * 2);
+        model->IndexBuffer = ib;
+    }
+
+    Render(model->Fill ? model->Fill : DefaultFill,
+           model->VertexBuffer, model->IndexBuffer,
+           matrix, 0, (unsigned)model->Indices.GetSize(), model->GetPrimType());
+}
+
+// The builtin vertex shaders.
+void RenderDevice::ShadeVertices(const Vertex* vertices, int count, const Matrix4f& view)
+{
+    const Shader* vs      = BoundShaders[Shader_Vertex];
+    int           program = vs ? vs->Index : VShader_MVP;
+    Matrix4f      m       = (program == VShader_MVP) ? StdProj * view : view;
+
+    Matrix4f texm;
+    if (program == VShader_PostProcess)
+    {
+        vs->GetUniform("Texm", 16, &texm.M[0][0]);
+    }
+
+    ClipVertices.Resize(count);
+    for (int i = 0; i < count; i++)
+    {
+        const Vertex& in  = vertices[i];
+        ClipVertex&   out = ClipVertices[i];
+        float         x = in.Pos.x, y = in.Pos.y, z = in.Pos.z;
+
+        for (int r = 0; r < 4; r++)
+        {
+            out.Pos[r] = m.M[r][0] * x + m.M[r][1] * y + m.M[r][2] * z + m.M[r][3];
+        }
+
+        float* v = out.Varyings;
+        v[Varying_Color]     = in.C.R * (1.0f / 255.0f);
+        v[Varying_Color + 1] = in.C.G * (1.0f / 255.0f);
+        v[Varying_Color + 2] = in.C.B * (1.0f / 255.0f);
+        v[Varying_Color + 3] = in.C.A * (1.0f / 255.0f);
+
+        if (program == VShader_PostProcess)
+        {
+            v[Varying_TexCoord]     = texm.M[0][0] * in.U + texm.M[0][1] * in.V + texm.M[0][3];
+            v[Varying_TexCoord + 1] = texm.M[1][0] * in.U + texm.M[1][1] * in.V + texm.M[1][3];
+        }
+        else
+        {
+            v[Varying_TexCoord]     = in.U;
+            v[Varying_TexCoord + 1] = in.V;
+        }
+        v[Varying_TexCoord1]     = in.U2;
+        v[Varying_TexCoord1 + 1] = in.V2;
+
+        for (int r = 0; r < 3; r++)
+        {
+            v[Varying_Normal + r] = view.M[r][0] * in.Norm.x + view.M[r][1] * in.Norm.y + view.M[r][2] * in.Norm.z;
+            v[Varying_VPos + r]   = view.M[r][0] * x + view.M[r][1] * y + view.M[r][2] * z + view.M[r][3];
+        }
+    }
+}
+
+void RenderDevice::Render(const Fill* fill, Render::Buffer* vertices, Render::Buffer* indices,
+                          const Matrix4f& matrix, int offset, int count, PrimitiveType prim)
+{
+    fill->Set(prim);
+    if (!CurTarget || !vertices || count <= 0 || ScissorX1 < ScissorX0 || ScissorY1 < ScissorY0 ||
+        (prim != Prim_Triangles && prim != Prim_TriangleStrip))
+    {
+        return;
+    }
+
+    const Array<UByte>& vertexData  = ((Buffer*)vertices)->Data_;
+    int                 vertexCount = (int)((vertexData.GetSize() - Alg::Min<UPInt>(offset, vertexData.GetSize())) / sizeof(Vertex));
+    if (vertexCount == 0)
+    {
+        return;
+    }
+
+    const Shader* ps = BoundShaders[Shader_Fragment];
+    DrawState     s;
+    s.PixelShader = ps ? ps->Index : FShader_Gouraud;
+    s.VaryingMask = GetVaryingMask(s.PixelShader);
+    s.Textures[0] = (Texture*)BoundTextures[0];
+    s.Textures[1] = (Texture*)BoundTextures[1];
+    s.Color[0] = s.Color[1] = s.Color[2] = s.Color[3] = 1;
+    memset(s.Distortion, 0, sizeof(s.Distortion));
+    if (ps)
+    {
+        ps->GetUniform("Color", 4, s.Color);
+        ps->GetUniform("LensCenter",   2, s.Distortion);
+        ps->GetUniform("ScreenCenter", 2, s.Distortion + 2);
+        ps->GetUniform("Scale",        2, s.Distortion + 4);
+        ps->GetUniform("ScaleIn",      2, s.Distortion + 6);
+        ps->GetUniform("HmdWarpParam", 4, s.Distortion + 8);
+    }
+    s.Lighting = -1;
+    if (s.VaryingMask & VaryingGroup_Lighting)
+    {
+        if (LightingChanged || Lightings.GetSize() == 0)
+        {
+            Lightings.PushBack(Lighting);
+            LightingChanged = false;
+        }
+        s.Lighting = (int)Lightings.GetSize() - 1;
+    }
+    s.DepthTest  = DepthTest;
+    s.DepthWrite = DepthWrite;
+    s.DepthFunc  = DepthFunc;
+    s.Blend      = Blend;
+    States.PushBack(s);
+
+    ShadeVertices((const Vertex*)&vertexData[offset], vertexCount, matrix);
+
+    const UInt16* index = NULL;
+    int           indexCount = count;
+    if (indices)
+    {
+        const Array<UByte>& indexData = ((Buffer*)indices)->Data_;
+        index      = indexData.GetSize() ? (const UInt16*)&indexData[0] : NULL;
+        indexCount = Alg::Min(count, (int)(indexData.GetSize() / 2));
+    }
+
+    int triangleCount = (prim == Prim_Triangles) ? indexCount / 3 : indexCount - 2;
+    for (int t = 0; t < triangleCount; t++)
+    {
+        int i0, i1, i2;
+        if (prim == Prim_Triangles)
+        {
+            i0 = t * 3; i1 = t * 3 + 1; i2 = t * 3 + 2;
+        }
+        else
+        {
+            // Every other strip triangle is flipped to keep the winding.
+            i0 = t; i1 = (t & 1) ? t + 2 : t + 1; i2 = (t & 1) ? t + 1 : t + 2;
+        }
+        if (index)
+        {
+            i0 = index[i0]; i1 = index[i1]; i2 = index[i2];
+        }
+        if (i0 >= vertexCount || i1 >= vertexCount || i2 >= vertexCount)
+        {
+            continue;
+        }
+        DrawTriangle(ClipVertices[i0], ClipVertices[i1], ClipVertices[i2]);
+    }
+}
+
+// Signed distance of a clip space vertex to one of the clipping planes; the near
+// plane and the four sides of the guard band.
+static inline float GetClipDistance(const ClipVertex& v, int plane)
+{
+    switch (plane)
+    {
+    case 0:  return v.Pos[2];
+    case 1:  return GuardBand * v.Pos[3] - v.Pos[0];
+    case 2:  return GuardBand * v.Pos[3] + v.Pos[0];
+    case 3:  return GuardBand * v.Pos[3] - v.Pos[1];
+    default: return GuardBand * v.Pos[3] + v.Pos[1];
+    }
+}
+
+static inline int GetClipCode(const ClipVertex& v)
+{
+    int code = 0;
+    for (int p = 0; p < 5; p++)
+    {
+        if (GetClipDistance(v, p) < 0)
+            code |= 1 << p;
+    }
+    // Beyond the far plane; only used to reject whole triangles.
+    if (v.Pos[2] > v.Pos[3])
+        code |= 32;
+    return code;
+}
+
+void RenderDevice::DrawTriangle(const ClipVertex& a, const ClipVertex& b, const ClipVertex& c)
+{
+    int codeA = GetClipCode(a), codeB = GetClipCode(b), codeC = GetClipCode(c);
+    if (codeA & codeB & codeC)
+    {
+        return;
+    }
+    int clip = (codeA | codeB | codeC) & 31;
+    if (!clip)
+    {
+        SetupTriangle(a, b, c);
+        return;
+    }
+
+    // Sutherland-Hodgman against the planes the triangle crosses.
+    ClipVertex polygons[2][9];
+    int        count = 3;
+    polygons[0][0] = a;
+    polygons[0][1] = b;
+    polygons[0][2] = c;
+
+    int in = 0;
+    for (int p = 0; p < 5 && count >= 3; p++)
+    {
+        if (!(clip & (1 << p)))
+        {
+            continue;
+        }
+
+        const ClipVertex* src  = polygons[in];
+        ClipVertex*       dest = polygons[in ^ 1];
+        int               outCount = 0;
+        for (int i = 0; i < count; i++)
+        {
+            const ClipVertex& v0 = src[i];
+            const ClipVertex& v1 = src[(i + 1) % count];
+            float             d0 = GetClipDistance(v0, p), d1 = GetClipDistance(v1, p);
+
+            if (d0 >= 0)
+            {
+                dest[outCount++] = v0;
+            }
+            if ((d0 >= 0) != (d1 >= 0))
+            {
+                float       t = d0 / (d0 - d1);
+                ClipVertex& v = dest[outCount++];
+                for (int k = 0; k < 4; k++)
+                    v.Pos[k] = v0.Pos[k] + (v1.Pos[k] - v0.Pos[k]) * t;
+                for (int k = 0; k < Varying_Count; k++)
+                    v.Varyings[k] = v0.Varyings[k] + (v1.Varyings[k] - v0.Varyings[k]) * t;
+            }
+        }
+        count = outCount;
+        in ^= 1;
+    }
+
+    for (int i = 2; i < count; i++)
+    {
+        SetupTriangle(polygons[in][0], polygons[in][i - 1], polygons[in][i]);
+    }
+}
+
+void RenderDevice::SetupTriangle(const ClipVertex& a, const ClipVertex& b, const ClipVertex& c)
+{
+    const ClipVertex* v[3] = { &a, &b, &c };
+    const Viewport&   vp   = Viewports[0];
+
+    float  sx[3], sy[3], z[3], oow[3];
+    SInt32 fx[3], fy[3];
+    for (int i = 0; i < 3; i++)
+    {
+        oow[i] = 1.0f / v[i]->Pos[3];
+        float ndcX = v[i]->Pos[0] * oow[i];
+        float ndcY = v[i]->Pos[1] * oow[i];
+        z[i]  = v[i]->Pos[2] * oow[i];
+        fx[i] = (SInt32)floorf((vp.x + (ndcX + 1.0f) * 0.5f * vp.w) * Subpixels + 0.5f);
+        fy[i] = (SInt32)floorf((vp.y + (1.0f - ndcY) * 0.5f * vp.h) * Subpixels + 0.5f);
+        sx[i] = fx[i] * (1.0f / Subpixels);
+        sy[i] = fy[i] * (1.0f / Subpixels);
+    }
+
+    // Front faces are clockwise on screen, as with the D3D rasterizer state; the
+    // back faces and degenerate triangles are dropped.
+    SInt64 area = (SInt64)(fx[1] - fx[0]) * (fy[2] - fy[0]) - (SInt64)(fx[2] - fx[0]) * (fy[1] - fy[0]);
+    if (area <= 0)
+    {
+        return;
+    }
+
+    Triangle tri;
+    tri.MinX = Alg::Max(ScissorX0, (Alg::Min(fx[0], Alg::Min(fx[1], fx[2])) + Subpixels / 2 - 1) >> SubpixelBits);
+    tri.MinY = Alg::Max(ScissorY0, (Alg::Min(fy[0], Alg::Min(fy[1], fy[2])) + Subpixels / 2 - 1) >> SubpixelBits);
+    tri.MaxX = Alg::Min(ScissorX1, (Alg::Max(fx[0], Alg::Max(fx[1], fx[2])) - Subpixels / 2) >> SubpixelBits);
+    tri.MaxY = Alg::Min(ScissorY1, (Alg::Max(fy[0], Alg::Max(fy[1], fy[2])) - Subpixels / 2) >> SubpixelBits);
+    if (tri.MinX > tri.MaxX || tri.MinY > tri.MaxY)
+    {
+        return;
+    }
+
+    // Edge i runs from vertex i to vertex i + 1, and is positive inside. Pixels
+    // exactly on an edge belong to it only if it is a top or left edge.
+    for (int i = 0; i < 3; i++)
+    {
+        int    j    = (i + 1) % 3;
+        SInt32 dx   = fx[j] - fx[i];
+        SInt32 dy   = fy[j] - fy[i];
+        bool   topLeft = (dy < 0) || (dy == 0 && dx > 0);
+        tri.EdgeDx[i] = -dy * Subpixels;
+        tri.EdgeDy[i] = dx * Subpixels;
+        tri.EdgeC[i]  = (SInt64)dx * (Subpixels / 2 - fy[i]) - (SInt64)dy * (Subpixels / 2 - fx[i]) - (topLeft ? 0 : 1);
+    }
+
+    // Plane equations of the interpolants, relative to the first vertex.
+    tri.RefX = sx[0];
+    tri.RefY = sy[0];
+    float dx1 = sx[1] - sx[0], dy1 = sy[1] - sy[0];
+    float dx2 = sx[2] - sx[0], dy2 = sy[2] - sy[0];
+    float invDet = 1.0f / (dx1 * dy2 - dx2 * dy1);
+
+    tri.PlaneOffset = (UInt32)PlaneData.GetSize();
+    tri.State       = (UInt32)States.GetSize() - 1;
+
+    const DrawState& s = States.Back();
+    int starts[4], counts[4];
+    int ranges = GetVaryingRanges(s.VaryingMask, starts, counts);
+    int planeCount = 2;
+    for (int r = 0; r < ranges; r++)
+    {
+        planeCount += counts[r];
+    }
+    PlaneData.Resize(tri.PlaneOffset + planeCount * 3);
+    float* plane = &PlaneData[tri.PlaneOffset];
+
+    for (int p = 0; p < planeCount; p++, plane += 3)
+    {
+        float f[3];
+        for (int i = 0; i < 3; i++)
+        {
+            if (p == 0)
+            {
+                f[i] = z[i];
+            }
+            else if (p == 1)
+            {
+                f[i] = oow[i];
+            }
+            else
+            {
+                // Find varying p - 2 in the ranges.
+                int k = p - 2, r = 0;
+                while (k >= counts[r])
+                {
+                    k -= counts[r++];
+                }
+                f[i] = v[i]->Varyings[starts[r] + k] * oow[i];
+            }
+        }
+        plane[0] = ((f[1] - f[0]) * dy2 - (f[2] - f[0]) * dy1) * invDet;
+        plane[1] = ((f[2] - f[0]) * dx1 - (f[1] - f[0]) * dx2) * invDet;
+        plane[2] = f[0];
+    }
+
+    UInt32 index = (UInt32)Triangles.GetSize();
+    Triangles.PushBack(tri);
+    BinTriangle(tri, index);
+}
+
+void RenderDevice::BinTriangle(const Triangle& tri, UInt32 index)
+{
+    int tx0 = tri.MinX / TileSize, tx1 = tri.MaxX / TileSize;
+    int ty0 = tri.MinY / TileSize, ty1 = tri.MaxY / TileSize;
+
+    for (int ty = ty0; ty <= ty1; ty++)
+    {
+        for (int tx = tx0; tx <= tx1; tx++)
+        {
+            // Skip tiles that are entirely outside of an edge; the corner where the
+            // edge is largest is enough to check.
+            if (tx0 != tx1 || ty0 != ty1)
+            {
+                bool outside = false;
+                for (int i = 0; i < 3 && !outside; i++)
+                {
+                    int    x = tri.EdgeDx[i] > 0 ? tx * TileSize + TileSize - 1 : tx * TileSize;
+                    int    y = tri.EdgeDy[i] > 0 ? ty * TileSize + TileSize - 1 : ty * TileSize;
+                    SInt64 e = tri.EdgeC[i] + (SInt64)tri.EdgeDx[i] * x + (SInt64)tri.EdgeDy[i] * y;
+                    outside = e < 0;
+                }
+                if (outside)
+                {
+                    continue;
+                }
+            }
+            Bins[ty * TilesX + tx].PushBack(index);
+        }
+    }
+}
+
+void RenderDevice::RasterizeTileJob(void* context, UPInt tile)
+{
+    ((RenderDevice*)context)->RasterizeTile((int)tile);
+}
+
+void RenderDevice::RasterizeTile(int tile)
+{
+    const Array<UInt32>& bin = Bins[tile];
+    if (!bin.GetSize())
+    {
+        return;
+    }
+
+    int tx0 = (tile % TilesX) * TileSize, ty0 = (tile / TilesX) * TileSize;
+    int tx1 = Alg::Min(tx0 + TileSize, CurTarget->Width) - 1;
+    int ty1 = Alg::Min(ty0 + TileSize, CurTarget->Height) - 1;
+
+    TileTarget target;
+    target.Color = &CurTarget->Texels[0];
+    target.Depth = (CurDepth && CurDepth->Width == CurTarget->Width && CurDepth->Height == CurTarget->Height) ?
+                   &CurDepth->Depth[0] : NULL;
+    target.Pitch = CurTarget->Width;
+
+    for (UPInt i = 0; i < bin.GetSize(); i++)
+    {
+        const Triangle&       tri      = Triangles[bin[i]];
+        const DrawState&      s        = States[tri.State];
+        const LightingParams* lighting = s.Lighting >= 0 ? &Lightings[s.Lighting] : NULL;
+        const float*          planes   = &PlaneData[tri.PlaneOffset];
+        int minX = Alg::Max(tri.MinX, tx0), maxX = Alg::Min(tri.MaxX, tx1);
+        int minY = Alg::Max(tri.MinY, ty0), maxY = Alg::Min(tri.MaxY, ty1);
+
+        switch (s.PixelShader)
+        {
+        case FShader_Solid:
+            RasterizeTriangle<FShader_Solid>(target, tri, s, lighting, planes, minX, minY, maxX, maxY);
+            break;
+        case FShader_Gouraud:
+            RasterizeTriangle<FShader_Gouraud>(target, tri, s, lighting, planes, minX, minY, maxX, maxY);
+            break;
+        case FShader_Texture:
+            RasterizeTriangle<FShader_Texture>(target, tri, s, lighting, planes, minX, minY, maxX, maxY);
+            break;
+        case FShader_AlphaTexture:
+            RasterizeTriangle<FShader_AlphaTexture>(target, tri, s, lighting, planes, minX, minY, maxX, maxY);
+            break;
+        case FShader_PostProcess:
+            RasterizeTriangle<FShader_PostProcess>(target, tri, s, lighting, planes, minX, minY, maxX, maxY);
+            break;
+        case FShader_LitGouraud:
+            RasterizeTriangle<FShader_LitGouraud>(target, tri, s, lighting, planes, minX, minY, maxX, maxY);
+            break;
+        case FShader_LitTexture:
+            RasterizeTriangle<FShader_LitTexture>(target, tri, s, lighting, planes, minX, minY, maxX, maxY);
+            break;
+        case FShader_MultiTexture:
+            RasterizeTriangle<FShader_MultiTexture>(target, tri, s, lighting, planes, minX, minY, maxX, maxY);
+            break;
+        }
+    }
+}
+
+void RenderDevice::Flush()
+{
+    if (Triangles.GetSize() && CurTarget)
+    {
+        Workers->ParallelFor(Bins.GetSize(), RasterizeTileJob, this);
+    }
+
+    for (UPInt i = 0; i < Bins.GetSize(); i++)
+    {
+        Bins[i].Clear();
+    }
+    Triangles.Clear();
+    PlaneData.Clear();
+    States.Clear();
+    Lightings.Clear();
+    LightingChanged = true;
+}
+
+}}} // OVR::Render::Soft
@@ -0,0 +1,245 @@
+/************************************************************************************
+
+Filename    :   Render_Soft_Device.h
+Content     :   Tile based software rasterizer RenderDevice
+Created     :   October 17, 2026
+Authors     :
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************************/
+
+#ifndef INC_Render_Soft_Device_h
+#define INC_Render_Soft_Device_h
+
+#include "Render_Device.h"
+#include "Render_WorkerPool.h"
+
+namespace OVR { namespace Render { namespace Soft {
+
+// The software device runs the builtin shaders on the CPU ("-r soft"), so rendering
+// can be checked and timed without a GPU. Vertices are shaded when a draw is
+// submitted; triangles are set up and sorted into 64x64 pixel tiles, and the tiles
+// are rasterized in parallel when the render target changes or the frame is
+// presented. Each tile is drawn in submission order by a single thread, so the
+// image doesn't depend on the thread count.
+//
+// Differences from the D3D devices: no multisampling, lines are not drawn, mip
+// levels are picked per pixel without blending between them, and DXT3 textures
+// are not decoded (they sample as white).
+
+class RenderDevice;
+
+// Per-vertex shader outputs, as offsets into ClipVertex::Varyings.
+enum Varying
+{
+    Varying_Color     = 0,
+    Varying_TexCoord  = 4,
+    Varying_TexCoord1 = 6,
+    Varying_Normal    = 8,
+    Varying_VPos      = 11,
+    Varying_Count     = 14
+};
+
+struct ClipVertex
+{
+    float Pos[4];
+    float Varyings[Varying_Count];
+};
+
+class Shader : public Render::Shader
+{
+public:
+    RenderDevice* Ren;
+    int           Index;    // VShader_* or FShader_*
+
+    Shader(RenderDevice* r, ShaderStage stage, int index) : Render::Shader(stage), Ren(r), Index(index) { }
+
+    virtual void Set(PrimitiveType prim) const;
+
+    // Copies n floats of the named uniform to v; returns false if it was never set.
+    bool GetUniform(const char* name, int n, float* v) const;
+
+protected:
+    virtual bool SetUniform(const char* name, int n, const float* v);
+    virtual bool SetUniform(UniformHandle h, int n, const float* v);
+
+private:
+    // Uniforms are kept by handle, so a name and its handle set the same one.
+    struct Uniform
+    {
+        UniformHandle Handle;
+        float         Value[16];
+    };
+    Array<Uniform> Uniforms;
+};
+
+class Buffer : public Render::Buffer
+{
+public:
+    Array<UByte> Data_;
+
+    virtual size_t GetSize() { return Data_.GetSize(); }
+    virtual void*  Map(size_t start, size_t size, int flags = 0);
+    virtual bool   Unmap(void* m) { OVR_UNUSED(m); return true; }
+    virtual bool   Data(int use, const void* buffer, size_t size);
+};
+
+// RGBA textures with their mip levels back to back; Texture_R is expanded to
+// (r, 0, 0, 1) and DXT is decoded when the texture is created. Depth textures
+// hold floats.
+class Texture : public Render::Texture
+{
+public:
+    RenderDevice* Ren;
+    int           Format;
+    int           Width, Height;
+    int           LevelCount;
+    int           SampleMode;
+    Array<UByte>  Texels;
+    Array<float>  Depth;
+
+    Texture(RenderDevice* r, int format, int w, int h);
+
+    virtual int  GetWidth() const  { return Width; }
+    virtual int  GetHeight() const { return Height; }
+
+    virtual void SetSampleMode(int sm) { SampleMode = sm; }
+    virtual void Set(int slot, ShaderStage stage = Shader_Fragment) const;
+
+    const UByte* GetLevel(int level, int* w, int* h) const;
+};
+
+// State of a draw, as the tiles need it after the draw call has returned.
+struct DrawState
+{
+    int           PixelShader;
+    int           VaryingMask;      // Groups of varyings the pixel shader reads.
+    Ptr<Texture>  Textures[2];
+    float         Color[4];         // FShader_Solid
+    float         Distortion[12];   // FShader_PostProcess: LensCenter, ScreenCenter, Scale, ScaleIn, HmdWarpParam
+    int           Lighting;         // Index into the frame's LightingParams, or -1.
+    bool          DepthTest, DepthWrite, Blend;
+    int           DepthFunc;
+};
+
+// A set up triangle. Edge functions are in 1/16 pixel fixed point, so coverage is
+// exact and follows the top-left rule. Interpolants are plane equations relative
+// to (RefX, RefY) in PlaneData: z, 1/w, then the varyings of the pixel shader,
+// divided by w.
+struct Triangle
+{
+    SInt64 EdgeC[3];        // Edge values at the center of pixel (0, 0).
+    SInt32 EdgeDx[3];       // Steps per pixel.
+    SInt32 EdgeDy[3];
+    int    MinX, MinY, MaxX, MaxY;
+    float  RefX, RefY;
+    UInt32 PlaneOffset;
+    UInt32 State;
+};
+
+class RenderDevice : public Render::RenderDevice
+{
+public:
+    enum { TileSize = 64 };
+
+    // window may be NULL; on Win32 presented frames are copied to it.
+    // threadCount of 0 uses one thread per CPU core.
+    RenderDevice(const RendererParams& p, void* window = NULL, int threadCount = 0);
+    ~RenderDevice();
+
+    static Render::RenderDevice* CreateDevice(const RendererParams& rp, void* oswnd);
+
+    // The back buffer, complete once Present has been called.
+    const Texture* GetFrameBuffer() const { return BackBuffer; }
+    int            GetThreadCount() const { return Workers->GetThreadCount(); }
+
+    void         BindShader(const Shader* shader);
+    void         BindTexture(int slot, const Texture* texture);
+
+    virtual void SetWindowSize(int w, int h);
+    virtual void SetMultipleViewports(int n, const Viewport* vps);
+    virtual void Clear(float r = 0, float g = 0, float b = 0, float a = 1, float depth = 1);
+    virtual void Rect(float left, float top, float right, float bottom) { OVR_UNUSED4(left, top, right, bottom); }
+    virtual void Present();
+
+    virtual Render::Buffer*    CreateBuffer();
+    virtual Render::Texture*   CreateTexture(int format, int width, int height, const void* data, int mipcount = 1);
+    virtual ShaderSet*         CreateShaderSet() { return new ShaderSet; }
+    virtual Render::Shader*    LoadBuiltinShader(ShaderStage stage, int shader);
+
+    virtual void SetRenderTarget(Render::Texture* color, Render::Texture* depth = NULL,
+                                 Render::Texture* stencil = NULL);
+    virtual void SetDepthMode(bool enable, bool write, CompareFunc func = Compare_Less);
+    virtual void SetWorldUniforms(const Matrix4f& proj);
+    virtual void SetCommonUniformBuffer(int i, Render::Buffer* buffer);
+
+    virtual void Render(const Matrix4f& matrix, Model* model);
+    virtual void Render(const Fill* fill, Render::Buffer* vertices, Render::Buffer* indices,
+                        const Matrix4f& matrix, int offset, int count, PrimitiveType prim = Prim_Triangles);
+
+    virtual Fill* CreateSimpleFill(int flags = Fill::F_Solid);
+
+    virtual void FillRect(float left, float top, float right, float bottom, Color c);
+    virtual void RenderText(const struct Font* font, const char* str, float x, float y, float size, Color c);
+
+private:
+    void         ShadeVertices(const Vertex* vertices, int count, const Matrix4f& view);
+    void         DrawTriangle(const ClipVertex& a, const ClipVertex& b, const ClipVertex& c);
+    void         SetupTriangle(const ClipVertex& a, const ClipVertex& b, const ClipVertex& c);
+    void         BinTriangle(const Triangle& tri, UInt32 index);
+    void         Flush();
+    void         RasterizeTile(int tile);
+    static void  RasterizeTileJob(void* context, UPInt tile);
+    Texture*     GetDepthBuffer(int w, int h);
+
+    void*                 Window;
+    Ptr<WorkerPool>       Workers;
+
+    Ptr<Shader>           VertexShaders[VShader_Count];
+    Ptr<Shader>           PixelShaders[FShader_Count];
+    Ptr<Fill>             DefaultFill;
+
+    const Shader*         BoundShaders[Shader_Count];
+    const Texture*        BoundTextures[2];
+    Matrix4f              StdProj;
+    Viewport              Viewports[2];
+    int                   NumViewports;
+    bool                  DepthTest, DepthWrite, Blend;
+    int                   DepthFunc;
+    LightingParams        Lighting;
+    bool                  LightingChanged;
+
+    Ptr<Texture>          BackBuffer;
+    Ptr<Texture>          CurTarget;
+    Ptr<Texture>          CurDepth;
+    Array<Ptr<Texture> >  DepthBuffers;
+
+    // Work since the last flush.
+    Array<ClipVertex>     ClipVertices;
+    Array<DrawState>      States;
+    Array<LightingParams> Lightings;
+    Array<Triangle>       Triangles;
+    Array<float>          PlaneData;
+    Array<Array<UInt32> > Bins;
+    int                   TilesX, TilesY;
+    int                   ScissorX0, ScissorY0, ScissorX1, ScissorY1;
+
+    Array<UByte>          PresentPixels;
+};
+
+}}} // OVR::Render::Soft
+
+#endif // INC_Render_Soft_Device_h
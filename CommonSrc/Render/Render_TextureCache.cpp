@@ -0,0 +1,247 @@
+/************************************************************************************
+
+Filename    :   Render_TextureCache.cpp
+Content     :   On-disk cache of decoded, mipmapped textures - implementation
+Created     :   October 17, 2026
+Authors     :
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************************/
+
+#include "Render_TextureCache.h"
+#include "Render_MappedFile.h"
+#include <Kernel/OVR_SysFile.h>
+#include <Kernel/OVR_Log.h>
+
+#include <stdio.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#if defined(OVR_OS_WIN32)
+#include <direct.h>
+#endif
+
+namespace OVR { namespace Render {
+
+// FNV-1a, 64-bit.
+static UInt64 HashBytes(UInt64 hash, const void* data, UPInt size)
+{
+    const UByte* p = (const UByte*)data;
+    for (UPInt i = 0; i < size; i++)
+    {
+        hash ^= p[i];
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+static UPInt GetEntryDataOffset(UPInt pathLength)
+{
+    return (sizeof(TextureCacheHeader) + pathLength + 15) & ~(UPInt)15;
+}
+
+// Size of all MipCount levels of data, laid out back to back.
+static UPInt GetTextureDataSize(const TextureData* data)
+{
+    UPInt size = 0;
+    int   w = data->Width, h = data->Height;
+    for (int i = 0; i < data->MipCount; i++)
+    {
+        size += GetTextureSize(data->Format, w, h);
+        w = Alg::Max(w >> 1, 1);
+        h = Alg::Max(h >> 1, 1);
+    }
+    return size;
+}
+
+TextureCache::TextureCache(const char* directory, bool rebuild)
+    : Directory(directory), Rebuild(rebuild)
+{
+    UPInt length = strlen(directory);
+    if (length && directory[length - 1] != '/' && directory[length - 1] != '\\')
+    {
+        Directory += "/";
+    }
+
+    // Fails harmlessly if the directory exists; if it can't be created every
+    // Store fails and the cache just misses.
+#if defined(OVR_OS_WIN32)
+    _mkdir(directory);
+#else
+    mkdir(directory, 0755);
+#endif
+}
+
+bool TextureCache::GetSourceKey(const char* sourceFileName, SourceKey* key) const
+{
+#if defined(OVR_OS_WIN32)
+    struct _stat sourceStat;
+    if (_stat(sourceFileName, &sourceStat) != 0)
+        return false;
+#else
+    struct stat sourceStat;
+    if (stat(sourceFileName, &sourceStat) != 0)
+        return false;
+#endif
+    key->Size = (UInt64)sourceStat.st_size;
+    key->Time = (UInt64)sourceStat.st_mtime;
+    return true;
+}
+
+String TextureCache::GetEntryPath(const char* sourceFileName, const SourceKey& key, int options) const
+{
+    UInt64 hash = 0xCBF29CE484222325ull;
+    hash = HashBytes(hash, sourceFileName, strlen(sourceFileName));
+    hash = HashBytes(hash, &key.Size, sizeof(key.Size));
+    hash = HashBytes(hash, &key.Time, sizeof(key.Time));
+    hash = HashBytes(hash, &options, sizeof(options));
+
+    char name[32];
+    OVR_sprintf(name, sizeof(name), "%08x%08x" OVR_TEXTURE_CACHE_EXT,
+                (UInt32)(hash >> 32), (UInt32)hash);
+    return Directory + name;
+}
+
+TextureData* TextureCache::Load(const char* sourceFileName, int options)
+{
+    SourceKey    key;
+    TextureData* data = NULL;
+
+    if (!Rebuild && GetSourceKey(sourceFileName, &key))
+    {
+        MappedFile* mapping = new MappedFile;
+        String      entryPath = GetEntryPath(sourceFileName, key, options);
+
+        TextureCacheHeader header;
+        if (mapping->Open(entryPath.ToCStr()) && mapping->GetSize() >= sizeof(header))
+        {
+            memcpy(&header, mapping->GetData(), sizeof(header));
+
+            UPInt pathLength = strlen(sourceFileName);
+            UPInt dataOffset = GetEntryDataOffset(header.PathLength);
+            bool  valid =
+                header.Magic == TextureCache_Magic && header.Version == TextureCache_Version &&
+                header.SourceSizeLow == (UInt32)key.Size && header.SourceSizeHigh == (UInt32)(key.Size >> 32) &&
+                header.SourceTimeLow == (UInt32)key.Time && header.SourceTimeHigh == (UInt32)(key.Time >> 32) &&
+                header.PathLength == pathLength && header.Options == (UInt32)options &&
+                !(header.Format & Texture_GenMipmaps) &&
+                header.Width > 0 && header.Height > 0 && header.MipCount > 0 &&
+                dataOffset <= mapping->GetSize() &&
+                header.DataSize <= mapping->GetSize() - dataOffset &&
+                !memcmp(mapping->GetData() + sizeof(header), sourceFileName, pathLength);
+
+            if (valid)
+            {
+                data = new TextureData;
+                data->Format   = header.Format;
+                data->Width    = header.Width;
+                data->Height   = header.Height;
+                data->MipCount = header.MipCount;
+                data->Clamp    = header.Clamp != 0;
+
+                if (GetTextureDataSize(data) == header.DataSize)
+                {
+                    data->pData    = (UByte*)mapping->GetData() + dataOffset;
+                    data->pMapping = mapping;
+                    mapping        = NULL;
+                }
+                else
+                {
+                    data->Release();
+                    data = NULL;
+                }
+            }
+        }
+        delete mapping;
+    }
+
+    Mutex::Locker lock(&StatsLock);
+    if (data)
+    {
+        CacheStats.Hits++;
+        CacheStats.BytesSaved += GetTextureDataSize(data);
+    }
+    else
+    {
+        CacheStats.Misses++;
+    }
+    return data;
+}
+
+bool TextureCache::Store(const char* sourceFileName, const TextureData* data, int options)
+{
+    SourceKey key;
+    if (!data || !data->pData || (data->Format & Texture_GenMipmaps) ||
+        !GetSourceKey(sourceFileName, &key))
+    {
+        return false;
+    }
+
+    TextureCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    header.Magic          = TextureCache_Magic;
+    header.Version        = TextureCache_Version;
+    header.SourceSizeLow  = (UInt32)key.Size;
+    header.SourceSizeHigh = (UInt32)(key.Size >> 32);
+    header.SourceTimeLow  = (UInt32)key.Time;
+    header.SourceTimeHigh = (UInt32)(key.Time >> 32);
+    header.PathLength     = (UInt32)strlen(sourceFileName);
+    header.Format         = data->Format;
+    header.Width          = data->Width;
+    header.Height         = data->Height;
+    header.MipCount       = data->MipCount;
+    header.Clamp          = data->Clamp ? 1 : 0;
+    header.DataSize       = (UInt32)GetTextureDataSize(data);
+    header.Options        = (UInt32)options;
+
+    static const UByte zeros[16] = { 0 };
+    UPInt  padding   = GetEntryDataOffset(header.PathLength) - sizeof(header) - header.PathLength;
+    String entryPath = GetEntryPath(sourceFileName, key, options);
+
+    SysFile f(entryPath, File::Open_Write | File::Open_Create | File::Open_Truncate);
+    bool ok = f.IsValid() &&
+              f.Write((const UByte*)&header, sizeof(header)) == (int)sizeof(header) &&
+              f.Write((const UByte*)sourceFileName, header.PathLength) == (int)header.PathLength &&
+              f.Write(zeros, (int)padding) == (int)padding &&
+              f.Write(data->pData, header.DataSize) == (int)header.DataSize;
+    f.Close();
+
+    if (!ok)
+    {
+        // Don't leave a truncated entry behind; it would be rejected, but only after mapping it.
+        remove(entryPath.ToCStr());
+        OVR_DEBUG_LOG(("Failed writing texture cache entry %s", entryPath.ToCStr()));
+        return false;
+    }
+
+    Mutex::Locker lock(&StatsLock);
+    CacheStats.Stores++;
+    return true;
+}
+
+TextureCache::Stats TextureCache::GetStats() const
+{
+    Mutex::Locker lock(&StatsLock);
+    return CacheStats;
+}
+
+void TextureCache::LogStats() const
+{
+    Stats stats = GetStats();
+    LogText("Texture cache: %d hits, %d misses, %d stored, %.1f MB saved\n",
+            stats.Hits, stats.Misses, stats.Stores, stats.BytesSaved / (1024.0 * 1024.0));
+}
+
+}} // OVR::Render
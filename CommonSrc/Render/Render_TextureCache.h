@@ -0,0 +1,120 @@
+/************************************************************************************
+
+Filename    :   Render_TextureCache.h
+Content     :   On-disk cache of decoded, mipmapped textures
+Created     :   October 17, 2026
+Authors     :
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************************/
+
+#ifndef INC_Render_TextureCache_h
+#define INC_Render_TextureCache_h
+
+#include "Render_Device.h"
+#include "Kernel/OVR_String.h"
+#include "Kernel/OVR_Threads.h"
+
+namespace OVR { namespace Render {
+
+// TextureCache keeps textures in the exact form they are uploaded in: a complete
+// mip chain, in whichever format TextureData ends up in. Entries are files in one
+// directory, named by a hash of the source path, size and modification time, so an
+// edited or replaced texture misses and gets a new entry; the key is also stored
+// in the entry and checked on load. Hits are memory-mapped, not read.
+//
+// Load and Store may be called from several threads at once, for different sources.
+//
+// Entry layout:
+//   TextureCacheHeader
+//   char sourcePath[PathLength], padded to 16 bytes
+//   mip chain, DataSize bytes
+
+#define OVR_TEXTURE_CACHE_EXT ".texcache"
+
+enum
+{
+    TextureCache_Magic   = 0x58455443, // "CTEX"
+    TextureCache_Version = 1
+};
+
+struct TextureCacheHeader
+{
+    UInt32 Magic;
+    UInt32 Version;
+    UInt32 SourceSizeLow, SourceSizeHigh;
+    UInt32 SourceTimeLow, SourceTimeHigh;
+    UInt32 PathLength;
+    SInt32 Format;
+    SInt32 Width, Height;
+    SInt32 MipCount;
+    UInt32 Clamp;
+    UInt32 DataSize;
+    UInt32 Options;
+    UInt32 Reserved[2];
+};
+
+class TextureCache : public RefCountBase<TextureCache>
+{
+public:
+    struct Stats
+    {
+        int    Hits;
+        int    Misses;
+        int    Stores;
+        // Size of the mip chains served by hits; data that did not have to be
+        // decoded, mipmapped or compressed.
+        UInt64 BytesSaved;
+
+        Stats() : Hits(0), Misses(0), Stores(0), BytesSaved(0) { }
+    };
+
+    // Entries are kept in directory, which is created if needed. With rebuild set
+    // every Load misses and Store overwrites, so the cache is regenerated.
+    TextureCache(const char* directory, bool rebuild = false);
+
+    // Returns the cached texture for sourceFileName, or NULL if there is no
+    // entry for its current size and time. options is part of the key and
+    // identifies how the data was processed (the TextureCompression used).
+    TextureData* Load(const char* sourceFileName, int options = 0);
+
+    // Stores data, which should be ready to upload (no Texture_GenMipmaps), as the
+    // entry for sourceFileName and options.
+    bool         Store(const char* sourceFileName, const TextureData* data, int options = 0);
+
+    Stats        GetStats() const;
+    void         LogStats() const;
+
+private:
+    struct SourceKey
+    {
+        UInt64 Size;
+        UInt64 Time;
+    };
+
+    bool   GetSourceKey(const char* sourceFileName, SourceKey* key) const;
+    String GetEntryPath(const char* sourceFileName, const SourceKey& key, int options) const;
+
+    String          Directory;
+    bool            Rebuild;
+
+    mutable Mutex   StatsLock;
+    Stats           CacheStats;
+};
+
+}} // OVR::Render
+
+#endif // INC_Render_TextureCache_h
@@ -0,0 +1,171 @@
+/************************************************************************************
+
+Filename    :   Render_WorkerPool.cpp
+Content     :   Fixed-size pool of worker threads for data-parallel loops
+Created     :   October 17, 2026
+Authors     :
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************************/
+
+#include "Render_WorkerPool.h"
+#include "Kernel/OVR_Alg.h"
+
+namespace OVR { namespace Render {
+
+int WorkerPool::GetDefaultThreadCount()
+{
+#ifdef OVR_ENABLE_THREADS
+    return Alg::Max(1, Thread::GetCPUCount());
+#else
+    return 1;
+#endif
+}
+
+#ifdef OVR_ENABLE_THREADS
+
+WorkerPool::WorkerPool(int threadCount)
+    : JobFn(NULL), JobContext(NULL), JobCount(0), NextIndex(0), JobGeneration(0),
+      BusyWorkers(0), RunningWorkers(0), Quit(false),
+      ThreadCount(threadCount > 0 ? threadCount : GetDefaultThreadCount())
+{
+    for (int i = 1; i < ThreadCount; i++)
+    {
+        Ptr<WorkerThread> worker = *new WorkerThread(this);
+        {
+            Mutex::Locker lock(&JobLock);
+            RunningWorkers++;
+        }
+        if (!worker->Start())
+        {
+            Mutex::Locker lock(&JobLock);
+            RunningWorkers--;
+            break;
+        }
+        Threads.PushBack(worker);
+    }
+    ThreadCount = (int)Threads.GetSize() + 1;
+}
+
+WorkerPool::~WorkerPool()
+{
+    Mutex::Locker lock(&JobLock);
+    Quit = true;
+    JobCondition.NotifyAll();
+    while (RunningWorkers > 0)
+    {
+        DoneCondition.Wait(&JobLock);
+    }
+}
+
+void WorkerPool::RunJobItems()
+{
+    for (;;)
+    {
+        UPInt index = (UPInt)NextIndex.ExchangeAdd_Sync(1);
+        if (index >= JobCount)
+            break;
+        JobFn(JobContext, index);
+    }
+}
+
+int WorkerPool::WorkerThread::Run()
+{
+    WorkerPool* pool           = pPool;
+    UInt32      seenGeneration = 0;
+
+    pool->JobLock.DoLock();
+    for (;;)
+    {
+        while (!pool->Quit && pool->JobGeneration == seenGeneration)
+        {
+            pool->JobCondition.Wait(&pool->JobLock);
+        }
+        if (pool->Quit)
+            break;
+
+        seenGeneration = pool->JobGeneration;
+        pool->JobLock.Unlock();
+
+        pool->RunJobItems();
+
+        pool->JobLock.DoLock();
+        if (--pool->BusyWorkers == 0)
+        {
+            pool->DoneCondition.NotifyAll();
+        }
+    }
+    pool->RunningWorkers--;
+    pool->DoneCondition.NotifyAll();
+    pool->JobLock.Unlock();
+    return 0;
+}
+
+void WorkerPool::ParallelFor(UPInt count, WorkerPoolFn fn, void* context)
+{
+    if (Threads.GetSize() == 0 || count <= 1)
+    {
+        for (UPInt i = 0; i < count; i++)
+        {
+            fn(context, i);
+        }
+        return;
+    }
+
+    {
+        Mutex::Locker lock(&JobLock);
+        JobFn       = fn;
+        JobContext  = context;
+        JobCount    = count;
+        NextIndex   = 0;
+        BusyWorkers = (int)Threads.GetSize();
+        JobGeneration++;
+        JobCondition.NotifyAll();
+    }
+
+    RunJobItems();
+
+    // Wait for the workers to finish their last items and go back to sleep,
+    // so the next job cannot be confused with this one.
+    Mutex::Locker lock(&JobLock);
+    while (BusyWorkers > 0)
+    {
+        DoneCondition.Wait(&JobLock);
+    }
+}
+
+#else // OVR_ENABLE_THREADS
+
+WorkerPool::WorkerPool(int)
+    : ThreadCount(1)
+{
+}
+
+WorkerPool::~WorkerPool()
+{
+}
+
+void WorkerPool::ParallelFor(UPInt count, WorkerPoolFn fn, void* context)
+{
+    for (UPInt i = 0; i < count; i++)
+    {
+        fn(context, i);
+    }
+}
+
+#endif // OVR_ENABLE_THREADS
+
+}} // OVR::Render
@@ -0,0 +1,92 @@
+/************************************************************************************
+
+Filename    :   Render_WorkerPool.h
+Content     :   Fixed-size pool of worker threads for data-parallel loops
+Created     :   October 17, 2026
+Authors     :
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************************/
+
+#ifndef INC_Render_WorkerPool_h
+#define INC_Render_WorkerPool_h
+
+#include "Kernel/OVR_Types.h"
+#include "Kernel/OVR_RefCount.h"
+#include "Kernel/OVR_Array.h"
+#include "Kernel/OVR_Threads.h"
+#include "Kernel/OVR_Atomic.h"
+
+namespace OVR { namespace Render {
+
+// Callback for WorkerPool::ParallelFor; called once for every index in the range.
+typedef void (*WorkerPoolFn)(void* context, UPInt index);
+
+// WorkerPool keeps threadCount - 1 threads waiting for work; the thread calling
+// ParallelFor also takes part, so a pool of one thread runs everything inline.
+// Indices are handed out one at a time, so the callback should do a reasonable
+// amount of work per index (a model, a texture, a block of rows).
+class WorkerPool : public RefCountBase<WorkerPool>
+{
+public:
+    // threadCount of 0 uses one thread per CPU core.
+    WorkerPool(int threadCount = 0);
+    ~WorkerPool();
+
+    int  GetThreadCount() const { return ThreadCount; }
+
+    // Calls fn(context, i) for every i in [0, count) and returns once all calls are done.
+    // Calls for different indices may run concurrently and in any order.
+    // ParallelFor must not be called from inside a callback, and calls from
+    // different threads must not overlap.
+    void ParallelFor(UPInt count, WorkerPoolFn fn, void* context);
+
+    static int GetDefaultThreadCount();
+
+private:
+#ifdef OVR_ENABLE_THREADS
+    class WorkerThread : public Thread
+    {
+    public:
+        WorkerThread(WorkerPool* pool) : pPool(pool) { }
+        virtual int Run();
+    private:
+        WorkerPool* pPool;
+    };
+
+    void RunJobItems();
+
+    Mutex                      JobLock;
+    WaitCondition              JobCondition;
+    WaitCondition              DoneCondition;
+    Array<Ptr<WorkerThread> >  Threads;
+
+    // Job state, protected by JobLock except for NextIndex.
+    WorkerPoolFn               JobFn;
+    void*                      JobContext;
+    UPInt                      JobCount;
+    AtomicInt<SInt32>          NextIndex;
+    UInt32                     JobGeneration;
+    int                        BusyWorkers;
+    int                        RunningWorkers;
+    bool                       Quit;
+#endif
+    int                        ThreadCount;
+};
+
+}} // OVR::Render
+
+#endif // INC_Render_WorkerPool_h
@@ -0,0 +1,197 @@
+/************************************************************************************
+
+Filename    :   Render_XmlCollisionLoader.cpp
+Content     :   The collision hull part of XmlHandler, which needs no renderer
+Created     :   October 17, 2026
+Authors     :
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************************/
+
+// Kept apart from Render_XmlSceneLoader.cpp so that collision tools can link
+// ParseCollisionFile with only the kernel, TinyXml and the collision code.
+
+#include "Render_XmlSceneLoader.h"
+#include <Kernel/OVR_Log.h>
+
+#ifdef OVR_DEFINE_NEW
+#undef new
+#endif
+
+namespace OVR { namespace Render {
+
+// Wall hulls are grown by this much, in the units of the planes' normals, to keep
+// the player back from them. Ground hulls are not: eye height is measured from them.
+static const float CollisionHullInflation = 0.5f;
+
+XmlHandler::XmlHandler()
+    : pXmlDocument(NULL), textureCount(0), TextureQuality(TextureCompress_None), modelCount(0),
+      collisionModelCount(0), groundCollisionModelCount(0),
+      vectorBytesParsed(0), ParseModelCount(0), ParseModelsDecoded(0)
+{
+    filePath[0] = 0;
+    pXmlDocument = new tinyxml2::XMLDocument();
+}
+
+XmlHandler::~XmlHandler()
+{
+    delete pXmlDocument;
+}
+
+void XmlHandler::ClearData()
+{
+    textureCount              = 0;
+    modelCount                = 0;
+    collisionModelCount       = 0;
+    groundCollisionModelCount = 0;
+    vectorBytesParsed         = 0;
+    ParseModelCount           = 0;
+    ParseModelsDecoded        = 0;
+    TextureNames.Clear();
+    Textures.Clear();
+    TextureImages.Clear();
+    Models.Clear();
+    ModelTextureIndices.Clear();
+    CollisionModels.Clear();
+    GroundCollisionModels.Clear();
+}
+
+void XmlHandler::SetFilePath(const char* fileName)
+{
+    // Extract the relative path to our working directory for loading textures
+    filePath[0] = 0;
+	SPInt len = strlen(fileName);
+    for(SPInt i = len; i > 0; i--)
+    {
+        if (fileName[i-1]=='\\' || fileName[i-1]=='/')
+        {
+            memcpy(filePath, fileName, i);
+            filePath[i] = 0;
+            break;
+        }        
+    }    
+}
+
+bool XmlHandler::ParseCollisionFile(const char* fileName)
+{
+    if(pXmlDocument->LoadFile(fileName) != 0)
+    {
+        return false;
+    }
+
+    ClearData();
+    SetFilePath(fileName);
+    ParseCollisionModels();
+    return true;
+}
+
+void XmlHandler::ParseCollisionModels()
+{
+    UPInt planesRead = 0, planesKept = 0;
+
+    //load the collision models
+	OVR_DEBUG_LOG(("Loading collision models... "));
+    pXmlDocument->FirstChildElement("scene")->FirstChildElement("collisionModels")->
+		          QueryIntAttribute("count", &collisionModelCount);
+    XMLElement* pXmlCollisionModel = pXmlDocument->FirstChildElement("scene")->
+		                                           FirstChildElement("collisionModels")->
+                                                   FirstChildElement("collisionModel");
+    XMLElement* pXmlPlane = NULL;
+    for(int i = 0; i < collisionModelCount; ++i)
+    {
+        Ptr<CollisionModel> cm = *new CollisionModel();
+        int planeCount = 0;
+        pXmlCollisionModel->QueryIntAttribute("planeCount", &planeCount);
+
+        pXmlPlane = pXmlCollisionModel->FirstChildElement("plane");
+        for(int j = 0; j < planeCount; ++j)
+        {
+            Vector3f norm;
+            pXmlPlane->QueryFloatAttribute("nx", &norm.x);
+            pXmlPlane->QueryFloatAttribute("ny", &norm.y);
+            pXmlPlane->QueryFloatAttribute("nz", &norm.z);
+            float D;
+            pXmlPlane->QueryFloatAttribute("d", &D);
+            D -= CollisionHullInflation;
+            Planef p(norm.z, norm.y, norm.x * -1.0f, D);
+            cm->Add(p);
+            pXmlPlane = pXmlPlane->NextSiblingElement("plane");
+        }
+
+        planesRead += cm->Planes.GetSize();
+        cm->Optimize();
+        planesKept += cm->Planes.GetSize();
+        CollisionModels.PushBack(cm);
+        pXmlCollisionModel = pXmlCollisionModel->NextSiblingElement("collisionModel");
+    }
+	OVR_DEBUG_LOG(("done."));
+
+    //load the ground collision models
+	OVR_DEBUG_LOG(("Loading ground collision models..."));
+    pXmlDocument->FirstChildElement("scene")->FirstChildElement("groundCollisionModels")->
+		QueryIntAttribute("count", &groundCollisionModelCount);
+    pXmlCollisionModel = pXmlDocument->FirstChildElement("scene")->
+		FirstChildElement("groundCollisionModels")->FirstChildElement("collisionModel");
+    pXmlPlane = NULL;
+    for(int i = 0; i < groundCollisionModelCount; ++i)
+    {
+        Ptr<CollisionModel> cm = *new CollisionModel();
+        int planeCount = 0;
+        pXmlCollisionModel->QueryIntAttribute("planeCount", &planeCount);
+
+        pXmlPlane = pXmlCollisionModel->FirstChildElement("plane");
+        for(int j = 0; j < planeCount; ++j)
+        {
+            Vector3f norm;
+            pXmlPlane->QueryFloatAttribute("nx", &norm.x);
+            pXmlPlane->QueryFloatAttribute("ny", &norm.y);
+            pXmlPlane->QueryFloatAttribute("nz", &norm.z);
+            float D;
+            pXmlPlane->QueryFloatAttribute("d", &D);
+            Planef p(norm.z, norm.y, norm.x * -1.0f, D);
+            cm->Add(p);
+            pXmlPlane = pXmlPlane->NextSiblingElement("plane");
+        }
+
+        planesRead += cm->Planes.GetSize();
+        cm->Optimize();
+        planesKept += cm->Planes.GetSize();
+        GroundCollisionModels.PushBack(cm);
+        pXmlCollisionModel = pXmlCollisionModel->NextSiblingElement("collisionModel");
+    }
+	OVR_DEBUG_LOG(("done."));
+    OVR_DEBUG_LOG(("Collision planes: %d read, %d after removing duplicates.",
+                   (int)planesRead, (int)planesKept));
+}
+
+void XmlHandler::AddCollisionModels(OVR::Array<Ptr<CollisionModel> >* pCollisions,
+                                    OVR::Array<Ptr<CollisionModel> >* pGroundCollisions)
+{
+    for(UPInt i = 0; i < CollisionModels.GetSize(); ++i)
+    {
+        pCollisions->PushBack(CollisionModels[i]);
+    }
+    for(UPInt i = 0; i < GroundCollisionModels.GetSize(); ++i)
+    {
+        pGroundCollisions->PushBack(GroundCollisionModels[i]);
+    }
+}
+
+}} // OVR::Render
+
+#ifdef OVR_DEFINE_NEW
+#define new OVR_DEFINE_NEW
+#endif
@@ -23,6 +23,15 @@ limitations under the License.
 
 #include "Render_XmlSceneLoader.h"
 #include <Kernel/OVR_Log.h>
+#include <Kernel/OVR_Timer.h>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define OVR_XML_SSE2
+#include <emmintrin.h>
+#if defined(OVR_CC_MSVC)
+#include <intrin.h>
+#endif
+#endif
 
 #ifdef OVR_DEFINE_NEW
 #undef new
@@ -30,42 +39,48 @@ limitations under the License.
 
 namespace OVR { namespace Render {
 
-XmlHandler::XmlHandler() : pXmlDocument(NULL)
+bool XmlHandler::ReadFile(const char* fileName, OVR::Render::RenderDevice* pRender,
+	                      OVR::Render::Scene* pScene,
+                          OVR::Array<Ptr<CollisionModel> >* pCollisions,
+	                      OVR::Array<Ptr<CollisionModel> >* pGroundCollisions,
+                          WorkerPool* pWorkers)
 {
-    pXmlDocument = new tinyxml2::XMLDocument();
+    if (!ParseFile(fileName, pWorkers))
+    {
+        return false;
+    }
+
+    BuildScene(pRender, pScene, pCollisions, pGroundCollisions);
+    return true;
 }
 
-XmlHandler::~XmlHandler()
+bool XmlHandler::ParseFile(const char* fileName, WorkerPool* pWorkers)
 {
-    delete pXmlDocument;
+    if(pXmlDocument->LoadFile(fileName) != 0)
+    {
+        return false;
+    }
+
+    ClearData();
+    SetFilePath(fileName);
+    return ParseDocument(pWorkers);
 }
 
-bool XmlHandler::ReadFile(const char* fileName, OVR::Render::RenderDevice* pRender,
-	                      OVR::Render::Scene* pScene,
-                          OVR::Array<Ptr<CollisionModel> >* pCollisions,
-	                      OVR::Array<Ptr<CollisionModel> >* pGroundCollisions)
+bool XmlHandler::ParseText(const char* xmlText, WorkerPool* pWorkers)
 {
-    if(pXmlDocument->LoadFile(fileName) != 0)
+    if(pXmlDocument->Parse(xmlText) != 0)
     {
         return false;
     }
 
-    // Extract the relative path to our working directory for loading textures
+    ClearData();
     filePath[0] = 0;
-    SPInt pos = 0;
-	SPInt len = strlen(fileName);
-    for(SPInt i = len; i > 0; i--)
-    {
-        if (fileName[i-1]=='\\' || fileName[i-1]=='/')
-        {
-            memcpy(filePath, fileName, i);
-            filePath[i] = 0;
-            break;
-        }        
-    }    
+    return ParseDocument(pWorkers);
+}
 
-    // Load the textures
-	OVR_DEBUG_LOG_TEXT(("Loading textures..."));
+bool XmlHandler::ParseDocument(WorkerPool* pWorkers)
+{
+    // Read the texture names; the textures themselves are loaded in BuildScene.
     pXmlDocument->FirstChildElement("scene")->FirstChildElement("textures")->
 		          QueryIntAttribute("count", &textureCount);
     XMLElement* pXmlTexture = pXmlDocument->FirstChildElement("scene")->
@@ -73,308 +88,574 @@ bool XmlHandler::ReadFile(const char* fileName, OVR::Render::RenderDevice* pRend
 
     for(int i = 0; i < textureCount; ++i)
     {
-        const char* textureName = pXmlTexture->Attribute("fileName");
-		SPInt       dotpos = strcspn(textureName, ".");
-        char        fname[300];
-
-		if (pos == len)
-		{            
-			OVR_sprintf(fname, 300, "%s", textureName);
-		}
-		else
-		{
-			OVR_sprintf(fname, 300, "%s%s", filePath, textureName);
-		}
-
-        SysFile* pFile = new SysFile(fname);
-		Ptr<Texture> texture;
-		if (textureName[dotpos + 1] == 'd' || textureName[dotpos + 1] == 'D')
-		{
-			// DDS file
-			texture.SetPtr(*LoadTextureDDS(pRender, pFile));
-		}
-		else
-		{
-			texture.SetPtr(*LoadTextureTga(pRender, pFile));
-		}
-
-        Textures.PushBack(texture);
-		pFile->Close();
-		pFile->Release();
+        TextureNames.PushBack(String(pXmlTexture->Attribute("fileName")));
         pXmlTexture = pXmlTexture->NextSiblingElement("texture");
     }
-	OVR_DEBUG_LOG_TEXT(("Done.\n"));
 
-    // Load the models
+    // Load the models. The DOM is only read from here on, so the model elements
+    // can be decoded independently; results go to fixed slots in document order.
 	pXmlDocument->FirstChildElement("scene")->FirstChildElement("models")->
 		          QueryIntAttribute("count", &modelCount);
 	
 		OVR_DEBUG_LOG(("Loading models... %i models to load...", modelCount));
+    OVR::Array<XMLElement*> modelElements;
     XMLElement* pXmlModel = pXmlDocument->FirstChildElement("scene")->
 		                                  FirstChildElement("models")->FirstChildElement("model");
-    for(int i = 0; i < modelCount; ++i)
+    for(int i = 0; i < modelCount && pXmlModel; ++i)
     {
-		if (i % 15 == 0)
-		{
-			OVR_DEBUG_LOG_TEXT(("%i models remaining...", modelCount - i));
-		}
+        modelElements.PushBack(pXmlModel);
 		Models.PushBack(*new Model(Prim_Triangles));
-        bool isCollisionModel = false;
-        pXmlModel->QueryBoolAttribute("isCollisionModel", &isCollisionModel);
-        Models[i]->IsCollisionModel = isCollisionModel;
-		if (isCollisionModel)
-		{
-			Models[i]->Visible = false;
-		}
-
-        //read the vertices
-        OVR::Array<Vector3f> *vertices = new OVR::Array<Vector3f>();
-        ParseVectorString(pXmlModel->FirstChildElement("vertices")->FirstChild()->
-			              ToText()->Value(), vertices);
-
-		for (unsigned int vertexIndex = 0; vertexIndex < vertices->GetSize(); ++vertexIndex)
-		{
-			vertices->At(vertexIndex).x *= -1.0f;
-		}
-
-        //read the normals
-        OVR::Array<Vector3f> *normals = new OVR::Array<Vector3f>();
-        ParseVectorString(pXmlModel->FirstChildElement("normals")->FirstChild()->
-			              ToText()->Value(), normals);
-
-		for (unsigned int normalIndex = 0; normalIndex < normals->GetSize(); ++normalIndex)
-		{
-			normals->At(normalIndex).z *= -1.0f;
-		}
-
-        //read the textures
-        OVR::Array<Vector3f> *diffuseUVs = new OVR::Array<Vector3f>();
-        OVR::Array<Vector3f> *lightmapUVs = new OVR::Array<Vector3f>();
-        int         diffuseTextureIndex = -1;
-        int         lightmapTextureIndex = -1;
-        XMLElement* pXmlCurMaterial = pXmlModel->FirstChildElement("material");
-
-        while(pXmlCurMaterial != NULL)
+        ModelTextures textures = { -1, -1 };
+        ModelTextureIndices.PushBack(textures);
+        pXmlModel = pXmlModel->NextSiblingElement("model");
+    }
+    modelCount = (int)modelElements.GetSize();
+    ParseModelCount = modelCount;
+
+    ModelDecodeJob job;
+    job.pHandler = this;
+    job.Elements = modelElements.GetSize() ? &modelElements[0] : NULL;
+    job.BytesParsed.Resize(modelElements.GetSize());
+
+    const UInt64 startTicks = Timer::GetTicks();
+    if (pWorkers)
+    {
+        pWorkers->ParallelFor(modelElements.GetSize(), DecodeModelJob, &job);
+    }
+    else
+    {
+        for(UPInt i = 0; i < modelElements.GetSize(); ++i)
         {
-            if(pXmlCurMaterial->Attribute("name", "diffuse"))
+            if (i % 15 == 0)
             {
-                pXmlCurMaterial->FirstChildElement("texture")->
-					             QueryIntAttribute("index", &diffuseTextureIndex);
-                if(diffuseTextureIndex > -1)
-                {
-                    ParseVectorString(pXmlCurMaterial->FirstChildElement("texture")->
-						              FirstChild()->ToText()->Value(), diffuseUVs, true);
-                }
+                OVR_DEBUG_LOG_TEXT(("%i models remaining...", modelCount - (int)i));
             }
-            else if(pXmlCurMaterial->Attribute("name", "lightmap"))
+            DecodeModelJob(&job, i);
+        }
+    }
+    const double seconds = (double)(Timer::GetTicks() - startTicks) / Timer::MksPerSecond;
+
+    for(UPInt i = 0; i < job.BytesParsed.GetSize(); ++i)
+    {
+        vectorBytesParsed += job.BytesParsed[i];
+    }
+	OVR_DEBUG_LOG(("Done."));
+    if (seconds > 0.0)
+    {
+        OVR_DEBUG_LOG(("Parsed %.1f MB of model data in %.1f ms (%.1f MB/s, %d threads)",
+                       vectorBytesParsed / (1024.0 * 1024.0), seconds * 1000.0,
+                       vectorBytesParsed / (1024.0 * 1024.0) / seconds,
+                       pWorkers ? pWorkers->GetThreadCount() : 1));
+    }
+
+    ParseCollisionModels();
+
+    InitTextureSlots();
+	return true;
+}
+
+UPInt XmlHandler::DecodeModel(XMLElement* pXmlModel, Model* pModel, ModelTextures* pTextures)
+{
+    UPInt bytesParsed = 0;
+
+    bool isCollisionModel = false;
+    pXmlModel->QueryBoolAttribute("isCollisionModel", &isCollisionModel);
+    pModel->IsCollisionModel = isCollisionModel;
+    if (isCollisionModel)
+    {
+        pModel->Visible = false;
+    }
+
+    //read the vertices
+    OVR::Array<Vector3f> *vertices = new OVR::Array<Vector3f>();
+    bytesParsed += ParseVectorString(pXmlModel->FirstChildElement("vertices")->FirstChild()->
+                                     ToText()->Value(), vertices);
+
+    for (unsigned int vertexIndex = 0; vertexIndex < vertices->GetSize(); ++vertexIndex)
+    {
+        vertices->At(vertexIndex).x *= -1.0f;
+    }
+
+    //read the normals
+    OVR::Array<Vector3f> *normals = new OVR::Array<Vector3f>();
+    bytesParsed += ParseVectorString(pXmlModel->FirstChildElement("normals")->FirstChild()->
+                                     ToText()->Value(), normals);
+
+    for (unsigned int normalIndex = 0; normalIndex < normals->GetSize(); ++normalIndex)
+    {
+        normals->At(normalIndex).z *= -1.0f;
+    }
+
+    //read the textures
+    OVR::Array<Vector3f> *diffuseUVs = new OVR::Array<Vector3f>();
+    OVR::Array<Vector3f> *lightmapUVs = new OVR::Array<Vector3f>();
+    int         diffuseTextureIndex = -1;
+    int         lightmapTextureIndex = -1;
+    XMLElement* pXmlCurMaterial = pXmlModel->FirstChildElement("material");
+
+    while(pXmlCurMaterial != NULL)
+    {
+        if(pXmlCurMaterial->Attribute("name", "diffuse"))
+        {
+            pXmlCurMaterial->FirstChildElement("texture")->
+                             QueryIntAttribute("index", &diffuseTextureIndex);
+            if(diffuseTextureIndex > -1)
             {
-                pXmlCurMaterial->FirstChildElement("texture")->
-					                               QueryIntAttribute("index", &lightmapTextureIndex);
-                if(lightmapTextureIndex > -1)
-                {
-                    XMLElement* firstChildElement = pXmlCurMaterial->FirstChildElement("texture");
-                    XMLNode* firstChild = firstChildElement->FirstChild();
-                    XMLText* text = firstChild->ToText();
-                    const char* value = text->Value();
-                    ParseVectorString(value, lightmapUVs, true);
-                }
+                bytesParsed += ParseVectorString(pXmlCurMaterial->FirstChildElement("texture")->
+                                                 FirstChild()->ToText()->Value(), diffuseUVs, true);
+            }
+        }
+        else if(pXmlCurMaterial->Attribute("name", "lightmap"))
+        {
+            pXmlCurMaterial->FirstChildElement("texture")->
+                             QueryIntAttribute("index", &lightmapTextureIndex);
+            if(lightmapTextureIndex > -1)
+            {
+                XMLElement* firstChildElement = pXmlCurMaterial->FirstChildElement("texture");
+                XMLNode* firstChild = firstChildElement->FirstChild();
+                XMLText* text = firstChild->ToText();
+                const char* value = text->Value();
+                bytesParsed += ParseVectorString(value, lightmapUVs, true);
             }
-
-            pXmlCurMaterial = pXmlCurMaterial->NextSiblingElement("material");
         }
 
-        //set up the shader
-        Ptr<ShaderFill> shader = *new ShaderFill(*pRender->CreateShaderSet());
-        shader->GetShaders()->SetShader(pRender->LoadBuiltinShader(Shader_Vertex, VShader_MVP));
+        pXmlCurMaterial = pXmlCurMaterial->NextSiblingElement("material");
+    }
+
+    pTextures->DiffuseIndex  = diffuseTextureIndex;
+    pTextures->LightmapIndex = lightmapTextureIndex;
+
+    //add all the vertices to the model
+    const UPInt numVerts = vertices->GetSize();
+    pModel->Vertices.Reserve(numVerts);
+    for(UPInt v = 0; v < numVerts; ++v)
+    {
         if(diffuseTextureIndex > -1)
         {
-            shader->SetTexture(0, Textures[diffuseTextureIndex]);
             if(lightmapTextureIndex > -1)
             {
-                shader->GetShaders()->SetShader(pRender->LoadBuiltinShader(Shader_Fragment, FShader_MultiTexture));
-                shader->SetTexture(1, Textures[lightmapTextureIndex]);
+                pModel->AddVertex(vertices->At(v).z, vertices->At(v).y, vertices->At(v).x, Color(255, 255, 255),
+                                  diffuseUVs->At(v).x, diffuseUVs->At(v).y, lightmapUVs->At(v).x, lightmapUVs->At(v).y,
+                                  normals->At(v).x, normals->At(v).y, normals->At(v).z);
             }
             else
             {
-                shader->GetShaders()->SetShader(pRender->LoadBuiltinShader(Shader_Fragment, FShader_Texture));
+                pModel->AddVertex(vertices->At(v).z, vertices->At(v).y, vertices->At(v).x, Color(255, 255, 255),
+                                  diffuseUVs->At(v).x, diffuseUVs->At(v).y, 0, 0,
+                                  normals->At(v).x, normals->At(v).y, normals->At(v).z);
             }
         }
         else
         {
-            shader->GetShaders()->SetShader(pRender->LoadBuiltinShader(Shader_Fragment, FShader_LitGouraud));
+            pModel->AddVertex(vertices->At(v).z, vertices->At(v).y, vertices->At(v).x, Color(255, 0, 0, 128),
+                              0, 0, 0, 0,
+                              normals->At(v).x, normals->At(v).y, normals->At(v).z);
         }
-        Models[i]->Fill = shader;
+    }
+
+    // Read the vertex indices for the triangles
+    XMLElement* pXmlIndices = pXmlModel->FirstChildElement("indices");
+    int         indexCount  = 0;
+    pXmlIndices->QueryIntAttribute("count", &indexCount);
+    ParseIndexString(pXmlIndices->FirstChild()->ToText()->Value(), indexCount,
+                     &pModel->Indices);
+    bytesParsed += strlen(pXmlIndices->FirstChild()->ToText()->Value());
+
+    pModel->ComputeBounds();
+
+    delete vertices;
+    delete normals;
+    delete diffuseUVs;
+    delete lightmapUVs;
+    return bytesParsed;
+}
 
-        //add all the vertices to the model
-        const UPInt numVerts = vertices->GetSize();
-        for(UPInt v = 0; v < numVerts; ++v)
+void XmlHandler::DecodeModelJob(void* context, UPInt index)
+{
+    ModelDecodeJob* job = (ModelDecodeJob*)context;
+    XmlHandler*     handler = job->pHandler;
+    job->BytesParsed[index] = handler->DecodeModel(job->Elements[index], handler->Models[index],
+                                                   &handler->ModelTextureIndices[index]);
+    handler->ParseModelsDecoded.ExchangeAdd_Sync(1);
+}
+
+void XmlHandler::BuildScene(OVR::Render::RenderDevice* pRender, OVR::Render::Scene* pScene,
+                            OVR::Array<Ptr<CollisionModel> >* pCollisions,
+                            OVR::Array<Ptr<CollisionModel> >* pGroundCollisions)
+{
+    // Load the textures
+	OVR_DEBUG_LOG_TEXT(("Loading textures..."));
+    for(UPInt i = 0; i < TextureNames.GetSize(); ++i)
+    {
+        CreateTexture(pRender, i);
+    }
+	OVR_DEBUG_LOG_TEXT(("Done.\n"));
+
+    for(UPInt i = 0; i < Models.GetSize(); ++i)
+    {
+        AddModel(pRender, pScene, i);
+    }
+
+    AddCollisionModels(pCollisions, pGroundCollisions);
+}
+
+void XmlHandler::LoadTextureData(UPInt index)
+{
+    const char* textureName = TextureNames[index].ToCStr();
+    SPInt       dotpos = strcspn(textureName, ".");
+    char        fname[300];
+
+    OVR_sprintf(fname, 300, "%s%s", filePath, textureName);
+
+    if (pTextureCache)
+    {
+        TextureImages[index] = *pTextureCache->Load(fname, TextureQuality);
+        if (TextureImages[index])
         {
-            if(diffuseTextureIndex > -1)
-            {
-                if(lightmapTextureIndex > -1)
-                {
-                    Models[i]->AddVertex(vertices->At(v).z, vertices->At(v).y, vertices->At(v).x, Color(255, 255, 255),
-                                          diffuseUVs->At(v).x, diffuseUVs->At(v).y, lightmapUVs->At(v).x, lightmapUVs->At(v).y,
-                                          normals->At(v).x, normals->At(v).y, normals->At(v).z);
-                }
-                else
-                {
-                    Models[i]->AddVertex(vertices->At(v).z, vertices->At(v).y, vertices->At(v).x, Color(255, 255, 255),
-                                          diffuseUVs->At(v).x, diffuseUVs->At(v).y, 0, 0,
-                                          normals->At(v).x, normals->At(v).y, normals->At(v).z);
-                }
-            }
-            else
-            {
-                Models[i]->AddVertex(vertices->At(v).z, vertices->At(v).y, vertices->At(v).x, Color(255, 0, 0, 128),
-                                      0, 0, 0, 0,
-                                      normals->At(v).x, normals->At(v).y, normals->At(v).z);
-            }
+            return;
         }
+    }
 
-        // Read the vertex indices for the triangles
-        const char* indexStr = pXmlModel->FirstChildElement("indices")->
-                                          FirstChild()->ToText()->Value();
-        UPInt stringLength = strlen(indexStr);
+    SysFile* pFile = new SysFile(fname);
+    if (textureName[dotpos] && (textureName[dotpos + 1] == 'd' || textureName[dotpos + 1] == 'D'))
+    {
+        // DDS file
+        TextureImages[index] = *LoadTextureDataDDS(pFile);
+    }
+    else
+    {
+        TextureImages[index] = *LoadTextureDataTga(pFile);
+    }
+    pFile->Close();
+    pFile->Release();
 
-        for(UPInt j = 0; j < stringLength;)
+    // Build mipmaps and compress here too, so it is done on the loader thread when streaming.
+    if (TextureImages[index])
+    {
+        TextureImages[index]->GenerateMipmaps();
+        TextureImages[index]->Compress(TextureQuality);
+        if (pTextureCache)
         {
-            UPInt k = j + 1;
-            for(; k < stringLength; ++k)
-            {
-                if(indexStr[k] == ' ')
-                {
-                    break;
-                }
-            }
-            char text[20];
-            for(UPInt l = 0; l < k - j; ++l)
-            {
-                text[l] = indexStr[j + l];
-            }
-            text[k - j] = '\0';
-            Models[i]->Indices.InsertAt(0, (unsigned short)atoi(text));
-            j = k + 1;
+            pTextureCache->Store(fname, TextureImages[index], TextureQuality);
         }
+    }
+}
 
-        delete vertices;
-        delete normals;
-        delete diffuseUVs;
-        delete lightmapUVs;
-
-        pScene->World.Add(Models[i]);
-        pScene->Models.PushBack(Models[i]);
-        pXmlModel = pXmlModel->NextSiblingElement("model");
+void XmlHandler::CreateTexture(OVR::Render::RenderDevice* pRender, UPInt index)
+{
+    if (!TextureImages[index])
+    {
+        LoadTextureData(index);
+    }
+    if (TextureImages[index])
+    {
+        Textures[index] = *TextureImages[index]->CreateTexture(pRender);
     }
-	OVR_DEBUG_LOG(("Done."));
 
-    //load the collision models
-	OVR_DEBUG_LOG(("Loading collision models... "));
-    pXmlDocument->FirstChildElement("scene")->FirstChildElement("collisionModels")->
-		          QueryIntAttribute("count", &collisionModelCount);
-    XMLElement* pXmlCollisionModel = pXmlDocument->FirstChildElement("scene")->
-		                                           FirstChildElement("collisionModels")->
-                                                   FirstChildElement("collisionModel");
-    XMLElement* pXmlPlane = NULL;
-    for(int i = 0; i < collisionModelCount; ++i)
-    {
-        Ptr<CollisionModel> cm = *new CollisionModel();
-        int planeCount = 0;
-        pXmlCollisionModel->QueryIntAttribute("planeCount", &planeCount);
-
-        pXmlPlane = pXmlCollisionModel->FirstChildElement("plane");
-        for(int j = 0; j < planeCount; ++j)
+    // The decoded image is no longer needed once it is on the GPU.
+    TextureImages[index].Clear();
+}
+
+void XmlHandler::AddModel(OVR::Render::RenderDevice* pRender, OVR::Render::Scene* pScene, UPInt index)
+{
+    int diffuseTextureIndex  = ModelTextureIndices[index].DiffuseIndex;
+    int lightmapTextureIndex = ModelTextureIndices[index].LightmapIndex;
+
+    //set up the shader
+    Ptr<ShaderFill> shader = *new ShaderFill(*pRender->CreateShaderSet());
+    shader->GetShaders()->SetShader(pRender->LoadBuiltinShader(Shader_Vertex, VShader_MVP));
+    if(diffuseTextureIndex > -1)
+    {
+        shader->SetTexture(0, Textures[diffuseTextureIndex]);
+        if(lightmapTextureIndex > -1)
+        {
+            shader->GetShaders()->SetShader(pRender->LoadBuiltinShader(Shader_Fragment, FShader_MultiTexture));
+            shader->SetTexture(1, Textures[lightmapTextureIndex]);
+        }
+        else
         {
-            Vector3f norm;
-            pXmlPlane->QueryFloatAttribute("nx", &norm.x);
-            pXmlPlane->QueryFloatAttribute("ny", &norm.y);
-            pXmlPlane->QueryFloatAttribute("nz", &norm.z);
-            float D;
-            pXmlPlane->QueryFloatAttribute("d", &D);
-            D -= 0.5f;
-            Planef p(norm.z, norm.y, norm.x * -1.0f, D);
-            cm->Add(p);
-            pXmlPlane = pXmlPlane->NextSiblingElement("plane");
+            shader->GetShaders()->SetShader(pRender->LoadBuiltinShader(Shader_Fragment, FShader_Texture));
         }
+    }
+    else
+    {
+        shader->GetShaders()->SetShader(pRender->LoadBuiltinShader(Shader_Fragment, FShader_LitGouraud));
+    }
+    Models[index]->Fill = shader;
+
+    pScene->World.Add(Models[index]);
+    pScene->Models.PushBack(Models[index]);
+}
+
+void XmlHandler::InitTextureSlots()
+{
+    Textures.Resize(TextureNames.GetSize());
+    TextureImages.Resize(TextureNames.GetSize());
+}
 
-        pCollisions->PushBack(cm);
-        pXmlCollisionModel = pXmlCollisionModel->NextSiblingElement("collisionModel");
+void XmlHandler::ParseIndexString(const char* str, UPInt countHint,
+                                  OVR::Array<UInt16>* indices)
+{
+    // Scene files store the triangles with the opposite winding, so the indices
+    // are appended in file order and the whole run is reversed once at the end.
+    const UPInt start = indices->GetSize();
+
+    // Without a count attribute, assume about four characters per index.
+    if (countHint == 0)
+    {
+        countHint = strlen(str) / 4;
     }
-	OVR_DEBUG_LOG(("done."));
+    indices->Reserve(start + countHint);
 
-    //load the ground collision models
-	OVR_DEBUG_LOG(("Loading ground collision models..."));
-    pXmlDocument->FirstChildElement("scene")->FirstChildElement("groundCollisionModels")->
-		QueryIntAttribute("count", &groundCollisionModelCount);
-    pXmlCollisionModel = pXmlDocument->FirstChildElement("scene")->
-		FirstChildElement("groundCollisionModels")->FirstChildElement("collisionModel");
-    pXmlPlane = NULL;
-    for(int i = 0; i < groundCollisionModelCount; ++i)
+    // Tokens run from the current character up to the next space, and each one is
+    // converted like atoi: leading whitespace is skipped and conversion stops at
+    // the first non-digit.
+    const char* p = str;
+    while (*p)
     {
-        Ptr<CollisionModel> cm = *new CollisionModel();
-        int planeCount = 0;
-        pXmlCollisionModel->QueryIntAttribute("planeCount", &planeCount);
+        const char* tokenEnd = p + 1;
+        while (*tokenEnd && *tokenEnd != ' ')
+        {
+            ++tokenEnd;
+        }
 
-        pXmlPlane = pXmlCollisionModel->FirstChildElement("plane");
-        for(int j = 0; j < planeCount; ++j)
+        while (p < tokenEnd && (*p == ' ' || (*p >= '\t' && *p <= '\r')))
         {
-            Vector3f norm;
-            pXmlPlane->QueryFloatAttribute("nx", &norm.x);
-            pXmlPlane->QueryFloatAttribute("ny", &norm.y);
-            pXmlPlane->QueryFloatAttribute("nz", &norm.z);
-            float D;
-            pXmlPlane->QueryFloatAttribute("d", &D);
-            Planef p(norm.z, norm.y, norm.x * -1.0f, D);
-            cm->Add(p);
-            pXmlPlane = pXmlPlane->NextSiblingElement("plane");
+            ++p;
         }
+        bool negative = false;
+        if (p < tokenEnd && (*p == '-' || *p == '+'))
+        {
+            negative = (*p == '-');
+            ++p;
+        }
+        int value = 0;
+        for (; p < tokenEnd && *p >= '0' && *p <= '9'; ++p)
+        {
+            value = value * 10 + (*p - '0');
+        }
+        indices->PushBack((UInt16)(negative ? -value : value));
 
-        pGroundCollisions->PushBack(cm);
-        pXmlCollisionModel = pXmlCollisionModel->NextSiblingElement("collisionModel");
+        p = *tokenEnd ? tokenEnd + 1 : tokenEnd;
     }
-	OVR_DEBUG_LOG(("done."));
-	return true;
+
+    const UPInt count = indices->GetSize() - start;
+    if (count > 1)
+    {
+        UInt16* first = &indices->At(start);
+        UInt16* last  = first + count - 1;
+        while (first < last)
+        {
+            Alg::Swap(*first++, *last--);
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------
+// ***** Float list parsing
+
+#if defined(OVR_XML_SSE2)
+
+static inline unsigned FirstSetBit(unsigned mask)
+{
+#if defined(OVR_CC_MSVC)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (unsigned)index;
+#else
+    return (unsigned)__builtin_ctz(mask);
+#endif
+}
+
+// Skips spaces, tabs and line breaks 16 bytes at a time. Loads are 16-byte aligned,
+// so they never cross into a page past the terminating zero.
+static const char* SkipWhitespace(const char* p)
+{
+    if ((UByte)*p > ' ')
+        return p;
+
+    const __m128i spaceMax = _mm_set1_epi8(' ');
+    const __m128i zero     = _mm_setzero_si128();
+
+    const char* block  = (const char*)((UPInt)p & ~(UPInt)15);
+    unsigned    ignore = (1u << (unsigned)(p - block)) - 1;
+    for (;;)
+    {
+        __m128i bytes = _mm_load_si128((const __m128i*)block);
+        // A byte ends the run if it is above ' ' or is the terminating zero.
+        __m128i isSpace = _mm_cmpeq_epi8(_mm_max_epu8(bytes, spaceMax), spaceMax);
+        __m128i isEnd   = _mm_or_si128(_mm_andnot_si128(isSpace, _mm_set1_epi8(-1)),
+                                       _mm_cmpeq_epi8(bytes, zero));
+        unsigned mask = (unsigned)_mm_movemask_epi8(isEnd) & ~ignore;
+        if (mask)
+            return block + FirstSetBit(mask);
+        block += 16;
+        ignore = 0;
+    }
+}
+
+#else
+
+static const char* SkipWhitespace(const char* p)
+{
+    while (*p && (UByte)*p <= ' ')
+        p++;
+    return p;
 }
 
-void XmlHandler::ParseVectorString(const char* str, OVR::Array<OVR::Vector3f> *array,
-	                               bool is2element)
+#endif
+
+static inline bool IsFloatSeparator(char c)
 {
-    UPInt stride = is2element ? 2 : 3;
-    UPInt stringLength = strlen(str);
-    UPInt element = 0;
-    float v[3];
+    return (UByte)c <= ' ';
+}
+
+// Converts the token at p without using the C locale. Values with at most 19
+// significant digits and a decimal exponent within +/-22 are computed exactly in
+// double precision (both operands are exact, so the single operation is correctly
+// rounded), which gives the same result as atof. Anything else falls back to atof.
+static const char* ParseFloat(const char* p, float* out)
+{
+    static const double powersOf10[] =
+    {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
 
-    for(UPInt j = 0; j < stringLength;)
+    const char* token    = p;
+    bool        negative = false;
+    if (*p == '-' || *p == '+')
     {
-        UPInt k = j + 1;
-        for(; k < stringLength; ++k)
+        negative = (*p == '-');
+        p++;
+    }
+
+    UInt64 mantissa    = 0;
+    int    digitCount  = 0;
+    int    exponent    = 0;
+    bool   anyDigits   = false;
+    bool   fastPath    = true;
+
+    for (; *p >= '0' && *p <= '9'; p++)
+    {
+        anyDigits = true;
+        if (mantissa == 0 && *p == '0')
+            continue;
+        if (digitCount < 19)
+            mantissa = mantissa * 10 + (*p - '0');
+        else
+            fastPath = false;
+        digitCount++;
+    }
+    if (*p == '.')
+    {
+        for (p++; *p >= '0' && *p <= '9'; p++)
         {
-            if(str[k] == ' ')
+            anyDigits = true;
+            if (mantissa == 0 && *p == '0')
+            {
+                exponent--;
+                continue;
+            }
+            if (digitCount < 19)
             {
-                break;
+                mantissa = mantissa * 10 + (*p - '0');
+                exponent--;
             }
+            else
+                fastPath = false;
+            digitCount++;
         }
-        char text[20];
-        for(UPInt l = 0; l < k - j; ++l)
+    }
+    if (anyDigits && (*p == 'e' || *p == 'E'))
+    {
+        const char* e = p + 1;
+        bool expNegative = false;
+        if (*e == '-' || *e == '+')
         {
-            text[l] = str[j + l];
+            expNegative = (*e == '-');
+            e++;
         }
-        text[k - j] = '\0';
-        v[element] = (float)atof(text);
-
-        if(element == (stride - 1))
+        if (*e >= '0' && *e <= '9')
         {
-            //we've got all the elements of our vertex, so store them
-            OVR::Vector3f vect;
-            vect.x = v[0];
-            vect.y = v[1];
-            vect.z = is2element ? 0.0f : v[2];
-            array->PushBack(vect);
+            int value = 0;
+            for (; *e >= '0' && *e <= '9'; e++)
+            {
+                if (value < 10000)
+                    value = value * 10 + (*e - '0');
+            }
+            exponent += expNegative ? -value : value;
+            p = e;
         }
+    }
 
-        j = k + 1;
-        element = (element + 1) % stride;
+    if (mantissa > ((UInt64)1 << 53) || exponent < -22 || exponent > 22)
+        fastPath = false;
+
+    if (!anyDigits || !fastPath || !IsFloatSeparator(*p))
+    {
+        // Out of range, inf/nan or malformed: let the CRT handle the token.
+        char        text[64];
+        const char* end = token;
+        while (!IsFloatSeparator(*end))
+            end++;
+        UPInt length = Alg::Min<UPInt>(end - token, sizeof(text) - 1);
+        memcpy(text, token, length);
+        text[length] = 0;
+        *out = (float)atof(text);
+        return end;
     }
+
+    double value = (double)mantissa;
+    if (exponent < 0)
+        value /= powersOf10[-exponent];
+    else
+        value *= powersOf10[exponent];
+    *out = (float)(negative ? -value : value);
+    return p;
+}
+
+// Parses whitespace-separated floats from str into up to maxCount elements of
+// componentCount floats each, placed elementStride floats apart in dest.
+// Returns the number of complete elements written.
+static UPInt ParseFloatList(const char* str, float* dest, UPInt maxCount,
+                            UPInt componentCount, UPInt elementStride)
+{
+    UPInt       count     = 0;
+    UPInt       component = 0;
+    const char* p         = SkipWhitespace(str);
+
+    while (*p && count < maxCount)
+    {
+        p = ParseFloat(p, dest + component);
+        p = SkipWhitespace(p);
+
+        if (++component == componentCount)
+        {
+            component = 0;
+            dest     += elementStride;
+            count++;
+        }
+    }
+    return count;
+}
+
+UPInt XmlHandler::ParseVectorString(const char* str, OVR::Array<OVR::Vector3f> *array,
+	                                bool is2element)
+{
+    const UPInt stride       = is2element ? 2 : 3;
+    const UPInt stringLength = strlen(str);
+
+    // Every value takes at least one character plus a separator, which bounds the
+    // element count; the array is sized once and trimmed after parsing.
+    const UPInt start    = array->GetSize();
+    const UPInt maxCount = (stringLength / 2 + 1) / stride;
+    array->Resize(start + maxCount);
+
+    const UPInt count    = (maxCount == 0) ? 0 :
+        ParseFloatList(str, &array->At(start).x, maxCount, stride, sizeof(Vector3f) / sizeof(float));
+    array->Resize(start + count);
+    return stringLength;
 }
 
 }} // OVR::Render
@@ -25,6 +25,8 @@ limitations under the License.
 #define INC_Render_XMLSceneLoader_h
 
 #include "Render_Device.h"
+#include "Render_WorkerPool.h"
+#include "Render_TextureCache.h"
 #include <Kernel/OVR_SysFile.h>
 using namespace OVR;
 using namespace OVR::Render;
@@ -45,24 +47,126 @@ public:
     XmlHandler();
     ~XmlHandler();
 
+    // Parses fileName and builds the scene from it; same as ParseFile followed by BuildScene.
     bool ReadFile(const char* fileName, OVR::Render::RenderDevice* pRender,
                   OVR::Render::Scene* pScene,
 		          OVR::Array<Ptr<CollisionModel> >* pColisions,
-                  OVR::Array<Ptr<CollisionModel> >* pGroundCollisions);
+                  OVR::Array<Ptr<CollisionModel> >* pGroundCollisions,
+                  WorkerPool* pWorkers = NULL);
+
+    // Loads models, texture names and collision hulls from a scene XML into memory.
+    // No renderer is needed, so this can also be used to compile scenes offline.
+    // If pWorkers is given, the model elements are decoded in parallel on it; the
+    // result is the same as a serial load.
+    bool ParseFile(const char* fileName, WorkerPool* pWorkers = NULL);
+
+    // Same as ParseFile for a scene already in memory; texture paths are used as is.
+    bool ParseText(const char* xmlText, WorkerPool* pWorkers = NULL);
+
+    // Loads only the collision hulls of a scene XML, for collision tools and tests;
+    // get them with AddCollisionModels.
+    bool ParseCollisionFile(const char* fileName);
+
+    // Parsed models, in document order.
+    UPInt        GetModelCount() const     { return Models.GetSize(); }
+    const Model* GetModel(UPInt i) const   { return Models[i]; }
+
+    // Reads and writes the binary form of the parsed data (see Render_CompiledScene.h).
+    bool ReadCompiledFile(const char* fileName);
+    bool WriteCompiledFile(const char* fileName) const;
+
+    // Loads the referenced textures, sets up shaders and adds the parsed models
+    // and collision hulls to the scene.
+    void BuildScene(OVR::Render::RenderDevice* pRender, OVR::Render::Scene* pScene,
+                    OVR::Array<Ptr<CollisionModel> >* pCollisions,
+                    OVR::Array<Ptr<CollisionModel> >* pGroundCollisions);
+
+    // The steps of BuildScene, for callers that spread the work over several frames.
+    // LoadTextureData only reads the file, decodes it and builds its mipmaps, so it
+    // may run on another thread (one call per index); the rest must be called on the
+    // rendering thread.
+    // CreateTexture loads the texture data itself if it was not loaded before.
+    // With a texture cache set, LoadTextureData takes textures from it when possible
+    // and stores the ones it had to decode.
+    void  SetTextureCache(TextureCache* cache) { pTextureCache = cache; }
+    // Block compresses RGBA textures after building their mipmaps; off by default.
+    void  SetTextureCompression(TextureCompression quality) { TextureQuality = quality; }
+    UPInt GetTextureCount() const { return TextureNames.GetSize(); }
+    // Texture file name as LoadTextureData opens it, relative to the working directory.
+    String GetTexturePath(UPInt index) const { return String(filePath) + TextureNames[index]; }
+    void  LoadTextureData(UPInt index);
+    void  CreateTexture(OVR::Render::RenderDevice* pRender, UPInt index);
+    void  AddModel(OVR::Render::RenderDevice* pRender, OVR::Render::Scene* pScene, UPInt index);
+    void  AddCollisionModels(OVR::Array<Ptr<CollisionModel> >* pCollisions,
+                             OVR::Array<Ptr<CollisionModel> >* pGroundCollisions);
+
+    // Number of models decoded so far by a ParseFile running on another thread,
+    // and the total once the model elements have been counted (0 before that).
+    int   GetModelsDecoded() const    { return ParseModelsDecoded; }
+    int   GetModelsToDecode() const   { return ParseModelCount; }
+
+    // Appends the space-separated triangle indices in str in reverse order, matching
+    // the winding the renderer expects. countHint is used to reserve storage; pass 0
+    // if the count is unknown.
+    static void ParseIndexString(const char* str, UPInt countHint, OVR::Array<UInt16>* indices);
 
 protected:
-    void ParseVectorString(const char* str, OVR::Array<OVR::Vector3f> *array,
-		                   bool is2element = false);
+    // Parses whitespace-separated 3-element (or 2-element, with z = 0) vectors and
+    // appends them to array. Returns the length of str in bytes.
+    static UPInt ParseVectorString(const char* str, OVR::Array<OVR::Vector3f> *array,
+		                           bool is2element = false);
+    void SetFilePath(const char* fileName);
 
 private:
+    // Drops anything loaded by a previous ParseFile or ReadCompiledFile.
+    void ClearData();
+
+    bool ParseDocument(WorkerPool* pWorkers);
+    void ParseCollisionModels();
+    void InitTextureSlots();
+
+    // Texture indices used by each model; -1 if the material is absent.
+    struct ModelTextures
+    {
+        int DiffuseIndex;
+        int LightmapIndex;
+    };
+
+    // Shared state for decoding the model elements on a WorkerPool.
+    struct ModelDecodeJob
+    {
+        XmlHandler*         pHandler;
+        XMLElement**        Elements;
+        OVR::Array<UPInt>   BytesParsed;
+    };
+
+    // Fills pModel and pTextures from a <model> element; only reads the DOM, so
+    // separate models may be decoded concurrently. Returns the bytes of text parsed.
+    UPInt DecodeModel(XMLElement* pXmlModel, Model* pModel, ModelTextures* pTextures);
+    static void DecodeModelJob(void* context, UPInt index);
+
     tinyxml2::XMLDocument* pXmlDocument;
     char                   filePath[250];
     int                    textureCount;
+    OVR::Array<String>     TextureNames;
     OVR::Array<Ptr<Texture> > Textures;
+    OVR::Array<Ptr<TextureData> > TextureImages;
+    Ptr<TextureCache>      pTextureCache;
+    TextureCompression     TextureQuality;
     int                    modelCount;
     OVR::Array<Ptr<Model> > Models;
+    OVR::Array<ModelTextures> ModelTextureIndices;
     int                    collisionModelCount;
     int                    groundCollisionModelCount;
+    OVR::Array<Ptr<CollisionModel> > CollisionModels;
+    OVR::Array<Ptr<CollisionModel> > GroundCollisionModels;
+
+    // Model data parsing statistics for the "Loading models" log.
+    UPInt                  vectorBytesParsed;
+
+    // Parse progress, read from other threads.
+    AtomicInt<SInt32>      ParseModelCount;
+    AtomicInt<SInt32>      ParseModelsDecoded;
 };
 
 }} // OVR::Render
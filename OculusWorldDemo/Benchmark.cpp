@@ -0,0 +1,2812 @@
+/************************************************************************************
+
+Filename    :   Benchmark.cpp
+Content     :   Command-line micro-benchmarks for the loader, collision and renderer
+Created     :   October 17, 2026
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*************************************************************************************/
+
+#include "Benchmark.h"
+#include "OculusWorldDemo.h"
+#include "CollisionWalk.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <math.h>
+
+#if defined(OVR_OS_LINUX)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+//-------------------------------------------------------------------------------------
+// ***** Index parsing
+
+// Builds an index string the way the exporter writes it: space separated, no
+// trailing space, with indices spread over the 16-bit range.
+static void MakeIndexString(UPInt count, Array<char>* str)
+{
+    str->Clear();
+    str->Reserve(count * 6 + 1);
+
+    unsigned seed = 1;
+    for (UPInt i = 0; i < count; i++)
+    {
+        char buffer[16];
+        seed = seed * 1103515245u + 12345u;
+        int  len = OVR_sprintf(buffer, sizeof(buffer), (i + 1 < count) ? "%u " : "%u",
+                               (seed >> 16) & 0xFFFF);
+        str->Append(buffer, len);
+    }
+    str->PushBack(0);
+}
+
+// The per-index InsertAt(0) parser the loader used originally; only run on the
+// smaller sizes since it is quadratic in the index count.
+static void ParseIndicesInsertAt(const char* indexStr, Array<UInt16>* indices)
+{
+    UPInt stringLength = strlen(indexStr);
+    for (UPInt j = 0; j < stringLength;)
+    {
+        UPInt k = j + 1;
+        while (k < stringLength && indexStr[k] != ' ')
+            k++;
+
+        char text[20];
+        UPInt len = Alg::Min<UPInt>(k - j, sizeof(text) - 1);
+        memcpy(text, indexStr + j, len);
+        text[len] = 0;
+        indices->InsertAt(0, (UInt16)atoi(text));
+        j = k + 1;
+    }
+}
+
+static bool BenchmarkIndexParsing()
+{
+    static const UPInt sizes[]         = { 10000, 50000, 100000, 250000, 500000 };
+    static const UPInt maxInsertAtSize = 50000;
+    static const int   repeatCount     = 5;
+    bool passed = true;
+
+    LogText("Index parsing (best of %d runs)\n", repeatCount);
+    LogText("%10s %12s %12s %12s\n", "Indices", "Hint ms", "No hint ms", "InsertAt ms");
+
+    Array<char>   str;
+    Array<UInt16> indices;
+    Array<UInt16> reference;
+
+    for (UPInt s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+        MakeIndexString(sizes[s], &str);
+
+        double bestHint = 1e10, bestNoHint = 1e10, bestInsertAt = -1.0;
+        for (int r = 0; r < repeatCount; r++)
+        {
+            indices.ClearAndRelease();
+            double t0 = GetBenchmarkTime();
+            XmlHandler::ParseIndexString(&str[0], sizes[s], &indices);
+            bestHint = Alg::Min(bestHint, GetBenchmarkTime() - t0);
+
+            indices.ClearAndRelease();
+            t0 = GetBenchmarkTime();
+            XmlHandler::ParseIndexString(&str[0], 0, &indices);
+            bestNoHint = Alg::Min(bestNoHint, GetBenchmarkTime() - t0);
+        }
+
+        if (sizes[s] <= maxInsertAtSize)
+        {
+            reference.ClearAndRelease();
+            double t0 = GetBenchmarkTime();
+            ParseIndicesInsertAt(&str[0], &reference);
+            bestInsertAt = GetBenchmarkTime() - t0;
+
+            bool match = (reference.GetSize() == indices.GetSize()) &&
+                         !memcmp(&reference[0], &indices[0], indices.GetSize() * sizeof(UInt16));
+            if (!match)
+            {
+                LogText("  ERROR: parsed indices differ from the InsertAt parser\n");
+                passed = false;
+            }
+        }
+
+        char insertAtText[16] = "-";
+        if (bestInsertAt >= 0.0)
+        {
+            OVR_sprintf(insertAtText, sizeof(insertAtText), "%.2f", bestInsertAt * 1000.0);
+        }
+        LogText("%10u %12.2f %12.2f %12s\n", (unsigned)sizes[s],
+                bestHint * 1000.0, bestNoHint * 1000.0, insertAtText);
+    }
+
+    return passed;
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** Parallel model decoding
+
+// Appends formatted text to an Array<char> buffer, without the terminating zero.
+static void AppendText(Array<char>* buffer, const char* format, ...)
+{
+    char    text[256];
+    va_list args;
+    va_start(args, format);
+    int length = OVR_vsprintf(text, sizeof(text), format, args);
+    va_end(args);
+    buffer->Append(text, length);
+}
+
+// Builds a scene XML in the exporter's layout with modelCount textured grid
+// models of gridSize x gridSize vertices each.
+static void MakeSceneXml(int modelCount, int gridSize, Array<char>* xml)
+{
+    xml->Clear();
+    AppendText(xml, "<scene>\n<textures count=\"1\"><texture fileName=\"bench.tga\"/></textures>\n");
+    AppendText(xml, "<models count=\"%d\">\n", modelCount);
+
+    const int vertexCount = gridSize * gridSize;
+    const int indexCount  = (gridSize - 1) * (gridSize - 1) * 6;
+    for (int m = 0; m < modelCount; m++)
+    {
+        AppendText(xml, "<model isCollisionModel=\"false\">\n<vertices count=\"%d\">", vertexCount);
+        for (int v = 0; v < vertexCount; v++)
+        {
+            AppendText(xml, v ? " %.6f %.6f %.6f" : "%.6f %.6f %.6f",
+                       (v % gridSize) * 0.25f + m, 0.125f * (v % 7), (v / gridSize) * 0.25f);
+        }
+        AppendText(xml, "</vertices>\n<normals count=\"%d\">", vertexCount);
+        for (int v = 0; v < vertexCount; v++)
+        {
+            AppendText(xml, v ? " 0 1 0" : "0 1 0");
+        }
+        AppendText(xml, "</normals>\n<material name=\"diffuse\"><texture index=\"0\">");
+        for (int v = 0; v < vertexCount; v++)
+        {
+            AppendText(xml, v ? " %.6f %.6f" : "%.6f %.6f",
+                       (v % gridSize) / (float)gridSize, (v / gridSize) / (float)gridSize);
+        }
+        AppendText(xml, "</texture></material>\n<indices count=\"%d\">", indexCount);
+        for (int y = 0; y < gridSize - 1; y++)
+        {
+            for (int x = 0; x < gridSize - 1; x++)
+            {
+                int i = y * gridSize + x;
+                AppendText(xml, (x || y) ? " %d %d %d %d %d %d" : "%d %d %d %d %d %d",
+                           i, i + gridSize, i + 1, i + 1, i + gridSize, i + gridSize + 1);
+            }
+        }
+        AppendText(xml, "</indices>\n</model>\n");
+    }
+
+    AppendText(xml, "</models>\n<collisionModels count=\"0\"></collisionModels>\n");
+    AppendText(xml, "<groundCollisionModels count=\"0\"></groundCollisionModels>\n</scene>\n");
+    xml->PushBack(0);
+}
+
+static bool ModelsMatch(const Model* a, const Model* b)
+{
+    if (a->Vertices.GetSize() != b->Vertices.GetSize() ||
+        a->Indices.GetSize() != b->Indices.GetSize())
+        return false;
+    if (a->Vertices.GetSize() &&
+        memcmp(&a->Vertices[0], &b->Vertices[0], a->Vertices.GetSize() * sizeof(Vertex)))
+        return false;
+    if (a->Indices.GetSize() &&
+        memcmp(&a->Indices[0], &b->Indices[0], a->Indices.GetSize() * sizeof(UInt16)))
+        return false;
+    return true;
+}
+
+static bool BenchmarkParallelDecode()
+{
+    static const int threadCounts[] = { 1, 2, 4, 8 };
+    static const int modelCount     = 256;
+    static const int gridSize       = 64;
+    static const int repeatCount    = 3;
+    bool passed = true;
+
+    Array<char> xml;
+    MakeSceneXml(modelCount, gridSize, &xml);
+    LogText("Scene decode, %d models x %d vertices, %.1f MB of XML (best of %d runs)\n",
+            modelCount, gridSize * gridSize, xml.GetSize() / (1024.0 * 1024.0), repeatCount);
+    LogText("%8s %12s %10s\n", "Threads", "ms", "Speedup");
+
+    XmlHandler reference;
+    reference.ParseText(&xml[0]);
+
+    double serialTime = 0.0;
+    for (UPInt t = 0; t < sizeof(threadCounts) / sizeof(threadCounts[0]); t++)
+    {
+        Ptr<WorkerPool> pool = *new WorkerPool(threadCounts[t]);
+        double best = 1e10;
+        bool   match = true;
+
+        for (int r = 0; r < repeatCount; r++)
+        {
+            XmlHandler handler;
+            double t0 = GetBenchmarkTime();
+            handler.ParseText(&xml[0], pool);
+            best = Alg::Min(best, GetBenchmarkTime() - t0);
+
+            match = match && (handler.GetModelCount() == reference.GetModelCount());
+            for (UPInt m = 0; match && m < handler.GetModelCount(); m++)
+            {
+                match = ModelsMatch(handler.GetModel(m), reference.GetModel(m));
+            }
+        }
+
+        if (t == 0)
+            serialTime = best;
+        LogText("%8d %12.2f %9.2fx%s\n", pool->GetThreadCount(), best * 1000.0,
+                serialTime / best, match ? "" : "  ERROR: output differs from serial load");
+        passed = passed && match;
+    }
+
+    return passed;
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** TGA decoding
+
+// Builds an in-memory TGA of the given type and depth filled with a smooth gradient,
+// the kind of content lightmaps have. For RLE images every row is stored as runs
+// of 4 equal pixels.
+static void MakeTgaFile(int size, int bpp, bool rle, Array<UByte>* file)
+{
+    const int pixelSize = bpp / 8;
+    UByte header[18] = { 0 };
+    header[2]  = rle ? 10 : 2;
+    header[12] = (UByte)(size & 0xFF);
+    header[13] = (UByte)(size >> 8);
+    header[14] = (UByte)(size & 0xFF);
+    header[15] = (UByte)(size >> 8);
+    header[16] = (UByte)bpp;
+
+    file->Clear();
+    file->Append(header, sizeof(header));
+    for (int y = 0; y < size; y++)
+    {
+        for (int x = 0; x < size; x += rle ? 4 : 1)
+        {
+            UByte pixel[4] = { (UByte)x, (UByte)y, (UByte)(x + y), (UByte)(255 - x) };
+            if (rle)
+                file->PushBack(0x80 | 3);
+            file->Append(pixel, pixelSize);
+        }
+    }
+}
+
+// The original loader, which reads one pixel per File::Read call; uncompressed
+// 24 and 32-bit images only.
+static UByte* DecodeTgaPerPixel(File* f, int* pwidth, int* pheight)
+{
+    int desclen = f->ReadUByte();
+    f->ReadUByte();
+    int imgtype = f->ReadUByte();
+    f->ReadUInt16();
+    int palCount = f->ReadUInt16();
+    int palSize = f->ReadUByte();
+    f->ReadUInt16();
+    f->ReadUInt16();
+    int width = f->ReadUInt16();
+    int height = f->ReadUInt16();
+    int bpp = f->ReadUByte();
+    f->ReadUByte();
+    unsigned char* imgdata = (unsigned char*) OVR_ALLOC(width * height * 4);
+    unsigned char buf[16];
+    f->Read(imgdata, desclen);
+    f->Read(imgdata, palCount * (palSize + 7) >> 3);
+    int bpl = width * 4;
+
+    if (imgtype != 2 || (bpp != 24 && bpp != 32))
+    {
+        OVR_FREE(imgdata);
+        return NULL;
+    }
+    for (int y = 0; y < height; y++)
+        for (int x = 0; x < width; x++)
+        {
+            f->Read(buf, bpp / 8);
+            imgdata[y*bpl+x*4+0] = buf[2];
+            imgdata[y*bpl+x*4+1] = buf[1];
+            imgdata[y*bpl+x*4+2] = buf[0];
+            imgdata[y*bpl+x*4+3] = (bpp == 32) ? buf[3] : 255;
+        }
+
+    *pwidth  = width;
+    *pheight = height;
+    return imgdata;
+}
+
+static bool BenchmarkTgaDecode()
+{
+    static const int sizes[]     = { 512, 2048, 4096 };
+    static const int repeatCount = 3;
+    bool passed = true;
+
+    LogText("TGA decode (best of %d runs)\n", repeatCount);
+    LogText("%6s %8s %12s %12s %10s %12s\n", "Size", "Format", "Per-pixel ms", "Bulk ms", "Speedup", "Bulk MB/s");
+
+    Array<UByte> file;
+    for (UPInt s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+        for (int format = 0; format < 3; format++)
+        {
+            const int   bpp  = (format == 1) ? 32 : 24;
+            const bool  rle  = (format == 2);
+            const char* name = rle ? "RLE24" : (bpp == 32 ? "BGRA32" : "BGR24");
+            MakeTgaFile(sizes[s], bpp, rle, &file);
+
+            double bestOld = -1.0, bestNew = 1e10;
+            bool   match   = true;
+            for (int r = 0; r < repeatCount; r++)
+            {
+                Ptr<File> newFile = *new MemoryFile("bench.tga", &file[0], (int)file.GetSize());
+                double t0 = GetBenchmarkTime();
+                Ptr<TextureData> data = *LoadTextureDataTga(newFile);
+                bestNew = Alg::Min(bestNew, GetBenchmarkTime() - t0);
+                if (!data)
+                {
+                    match = false;
+                    break;
+                }
+
+                if (rle)
+                    continue;
+
+                Ptr<File> oldFile = *new MemoryFile("bench.tga", &file[0], (int)file.GetSize());
+                int width = 0, height = 0;
+                t0 = GetBenchmarkTime();
+                UByte* oldData = DecodeTgaPerPixel(oldFile, &width, &height);
+                double oldTime = GetBenchmarkTime() - t0;
+                bestOld = (bestOld < 0.0) ? oldTime : Alg::Min(bestOld, oldTime);
+
+                match = match && oldData && !memcmp(oldData, data->pData, (UPInt)width * height * 4);
+                OVR_FREE(oldData);
+            }
+
+            char oldText[16] = "-", speedupText[16] = "-";
+            if (bestOld >= 0.0)
+            {
+                OVR_sprintf(oldText, sizeof(oldText), "%.2f", bestOld * 1000.0);
+                OVR_sprintf(speedupText, sizeof(speedupText), "%.1fx", bestOld / bestNew);
+            }
+            double megabytes = (double)sizes[s] * sizes[s] * 4 / (1024.0 * 1024.0);
+            LogText("%6d %8s %12s %12.2f %10s %12.1f%s\n", sizes[s], name, oldText, bestNew * 1000.0,
+                    speedupText, megabytes / bestNew, match ? "" : "  ERROR: output differs");
+            passed = passed && match;
+        }
+    }
+
+    return passed;
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** Mipmap generation
+
+static const char* GetMipFilterPathName(MipFilterPath path)
+{
+    switch (path)
+    {
+    case MipFilterPath_Scalar: return "Scalar";
+    case MipFilterPath_SSE2:   return "SSE2";
+    case MipFilterPath_AVX2:   return "AVX2";
+    default:                   return "Auto";
+    }
+}
+
+// Builds full chains with every filter path, single threaded and on a worker pool,
+// and checks each one is bit-exact against the scalar reference. Odd sizes and sRGB
+// run on the scalar filter, but are still checked for the threaded split. A constant
+// image must give the same color on every level, which catches dropped texels and
+// wrong weights on odd dimensions.
+static bool BenchmarkMipChain()
+{
+    static const int sizes[][2] =
+    {
+        { 512, 512 }, { 2048, 2048 }, { 4096, 4096 }, { 1000, 750 }, { 1023, 511 }, { 3, 1 }
+    };
+    static const MipFilterPath paths[] = { MipFilterPath_Scalar, MipFilterPath_SSE2, MipFilterPath_AVX2 };
+    static const int repeatCount = 3;
+    bool passed = true;
+
+    Ptr<WorkerPool> pool = *new WorkerPool();
+    LogText("Mip chain generation (best of %d runs, %d threads)\n", repeatCount, pool->GetThreadCount());
+    LogText("%11s %6s %8s %12s %12s %10s\n", "Size", "sRGB", "Path", "1 thread ms", "Pool ms", "Pool MB/s");
+
+    for (UPInt s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+        const int   w = sizes[s][0], h = sizes[s][1];
+        const UPInt imageSize = (UPInt)w * h * 4;
+        const int   chainSize = GetMipChainSize(w, h);
+
+        Array<UByte> image, constant, reference, chain;
+        image.Resize(imageSize);
+        constant.Resize(imageSize);
+        reference.Resize(chainSize);
+        chain.Resize(chainSize);
+
+        unsigned seed = 1;
+        for (UPInt i = 0; i < imageSize; i++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            image[i]    = (UByte)(seed >> 16);
+            constant[i] = (UByte)(0x4DC87A0Bu >> ((i & 3) * 8));
+        }
+
+        for (int flags = 0; flags <= MipFilter_SRGB; flags++)
+        {
+            bool constantOk = true;
+            BuildMipChain(&constant[0], w, h, &chain[0], flags);
+            for (int i = 0; i < chainSize; i++)
+                constantOk = constantOk && (chain[i] == constant[i & 3]);
+
+            BuildMipChain(&image[0], w, h, &reference[0], flags, NULL, MipFilterPath_Scalar);
+
+            for (UPInt p = 0; p < sizeof(paths) / sizeof(paths[0]); p++)
+            {
+                double bestSingle = 1e10, bestPool = 1e10;
+                bool   match = constantOk;
+                for (int r = 0; r < repeatCount; r++)
+                {
+                    double t0 = GetBenchmarkTime();
+                    BuildMipChain(&image[0], w, h, &chain[0], flags, NULL, paths[p]);
+                    bestSingle = Alg::Min(bestSingle, GetBenchmarkTime() - t0);
+                    match = match && !memcmp(&chain[0], &reference[0], chainSize);
+
+                    memset(&chain[0], 0, chainSize);
+                    t0 = GetBenchmarkTime();
+                    BuildMipChain(&image[0], w, h, &chain[0], flags, pool, paths[p]);
+                    bestPool = Alg::Min(bestPool, GetBenchmarkTime() - t0);
+                    match = match && !memcmp(&chain[0], &reference[0], chainSize);
+                }
+
+                char sizeText[16];
+                OVR_sprintf(sizeText, sizeof(sizeText), "%dx%d", w, h);
+                LogText("%11s %6s %8s %12.2f %12.2f %10.1f%s\n", sizeText, flags ? "yes" : "no",
+                        GetMipFilterPathName(paths[p]), bestSingle * 1000.0, bestPool * 1000.0,
+                        (chainSize - imageSize) / (1024.0 * 1024.0) / bestPool,
+                        match ? "" : "  ERROR: differs from reference");
+                passed = passed && match;
+            }
+        }
+    }
+
+    return passed;
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** Block compression
+
+static const char* const TextureCompressionNames[] = { "None", "Fast", "Normal", "High" };
+
+static double GetPsnr(double squaredError, double count)
+{
+    if (squaredError <= 0.0)
+        return 99.0;
+    return 10.0 * log10(255.0 * 255.0 * count / squaredError);
+}
+
+// Compresses level 0 of image at each quality on pool and logs time, throughput and
+// the PSNR of the decoded result; accumulates totals for the summary.
+static void CompressAndMeasure(const char* name, const UByte* image, int w, int h, WorkerPool* pool,
+                               double* totalSeconds, double* totalMegabytes)
+{
+    int          format = ChooseBlockFormat(image, w, h);
+    UPInt        pixels = (UPInt)w * h;
+    Array<UByte> blocks, decoded;
+    blocks.Resize(GetTextureSize(format, w, h));
+    decoded.Resize(pixels * 4);
+
+    for (int quality = TextureCompress_Fast; quality <= TextureCompress_High; quality++)
+    {
+        double t0 = GetBenchmarkTime();
+        CompressRgbaBlocks(image, w, h, &blocks[0], format, (TextureCompression)quality, pool);
+        double seconds = GetBenchmarkTime() - t0;
+        DecompressBlocks(&blocks[0], w, h, format, &decoded[0]);
+
+        double colorError = 0.0, alphaError = 0.0;
+        for (UPInt i = 0; i < pixels * 4; i++)
+        {
+            double d = (double)image[i] - decoded[i];
+            if ((i & 3) == 3)
+                alphaError += d * d;
+            else
+                colorError += d * d;
+        }
+
+        double megabytes = pixels * 4 / (1024.0 * 1024.0);
+        totalSeconds[quality]   += seconds;
+        totalMegabytes[quality] += megabytes;
+
+        char alphaText[16] = "-";
+        if (format == Texture_DXT5)
+            OVR_sprintf(alphaText, sizeof(alphaText), "%.2f", GetPsnr(alphaError, (double)pixels));
+        LogText("%-28s %9dx%-5d %4s %7s %10.2f %10.1f %9.2f %9s\n", name, w, h,
+                format == Texture_DXT5 ? "BC3" : "BC1", TextureCompressionNames[quality],
+                seconds * 1000.0, megabytes / seconds, GetPsnr(colorError, pixels * 3.0), alphaText);
+    }
+}
+
+// Runs over the TGA textures of the default scene, or a synthetic image if the
+// scene isn't found from the working directory.
+static bool BenchmarkBlockCompression()
+{
+    static const char* const scenePaths[] =
+    {
+        WORLDDEMO_ASSET_PATH1 WORLDDEMO_ASSET_FILE,
+        WORLDDEMO_ASSET_PATH2 WORLDDEMO_ASSET_FILE,
+        WORLDDEMO_ASSET_PATH3 WORLDDEMO_ASSET_FILE
+    };
+
+    Ptr<WorkerPool> pool = *new WorkerPool();
+    double totalSeconds[TextureCompress_High + 1]   = { 0 };
+    double totalMegabytes[TextureCompress_High + 1] = { 0 };
+
+    LogText("Block compression (%d threads)\n", pool->GetThreadCount());
+    LogText("%-28s %15s %4s %7s %10s %10s %9s %9s\n", "Texture", "Size", "Fmt", "Quality",
+            "ms", "MB/s", "PSNR RGB", "PSNR A");
+
+    XmlHandler handler;
+    bool       sceneFound = false;
+    for (UPInt p = 0; p < sizeof(scenePaths) / sizeof(scenePaths[0]) && !sceneFound; p++)
+    {
+        sceneFound = SysFile(scenePaths[p]).IsValid() && ParseSceneFile(&handler, scenePaths[p]);
+    }
+
+    for (UPInt i = 0; sceneFound && i < handler.GetTextureCount(); i++)
+    {
+        String      path = handler.GetTexturePath(i);
+        const char* ext  = strrchr(path.ToCStr(), '.');
+        if (!ext || OVR_stricmp(ext, ".tga"))
+            continue;
+
+        Ptr<File>        file = *new SysFile(path);
+        Ptr<TextureData> data = *LoadTextureDataTga(file);
+        if (!data || (data->Width & 3) || (data->Height & 3))
+            continue;
+
+        const char* name = strrchr(path.ToCStr(), '/');
+        CompressAndMeasure(name ? name + 1 : path.ToCStr(), data->pData, data->Width, data->Height, pool,
+                           totalSeconds, totalMegabytes);
+    }
+
+    if (!sceneFound)
+    {
+        LogText("%s not found, using a synthetic image\n", WORLDDEMO_ASSET_FILE);
+
+        const int    size = 2048;
+        Array<UByte> image;
+        image.Resize(size * size * 4);
+        unsigned seed = 1;
+        for (int y = 0; y < size; y++)
+        {
+            for (int x = 0; x < size; x++)
+            {
+                seed = seed * 1103515245u + 12345u;
+                int    noise = (seed >> 16) & 15;
+                UByte* p     = &image[((UPInt)y * size + x) * 4];
+                p[0] = (UByte)Alg::Min(255, x / 8 + noise);
+                p[1] = (UByte)Alg::Min(255, y / 8 + noise);
+                p[2] = (UByte)(((x / 64) ^ (y / 64)) & 1 ? 200 : 40);
+                p[3] = 255;
+            }
+        }
+        CompressAndMeasure("synthetic", &image[0], size, size, pool, totalSeconds, totalMegabytes);
+    }
+
+    for (int quality = TextureCompress_Fast; quality <= TextureCompress_High; quality++)
+    {
+        if (totalSeconds[quality] > 0.0)
+        {
+            LogText("%s: %.1f MB in %.1f ms, %.1f MB/s\n", TextureCompressionNames[quality],
+                    totalMegabytes[quality], totalSeconds[quality] * 1000.0,
+                    totalMegabytes[quality] / totalSeconds[quality]);
+        }
+    }
+
+    return true;
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** Collision tree
+
+// A box turned about Y, with a sloped top on every third one so that the
+// trees also see models that aren't boxes.
+static Ptr<CollisionModel> MakeCollisionHull(const Vector3f& center, const Vector3f& halfSize,
+                                             float yaw, bool slopedTop)
+{
+    Ptr<CollisionModel> hull = *new CollisionModel();
+    Vector3f right(cosf(yaw), 0, -sinf(yaw));
+    Vector3f forward(sinf(yaw), 0, cosf(yaw));
+    Vector3f up(0, 1, 0);
+
+    hull->Add(Planef( right,   -right.Dot(center)   - halfSize.x));
+    hull->Add(Planef(-right,    right.Dot(center)   - halfSize.x));
+    hull->Add(Planef(-up,       up.Dot(center)      - halfSize.y));
+    hull->Add(Planef( forward, -forward.Dot(center) - halfSize.z));
+    hull->Add(Planef(-forward,  forward.Dot(center) - halfSize.z));
+    if (slopedTop)
+    {
+        Vector3f n = (up + right * 0.5f).Normalized();
+        hull->Add(Planef(n, -n.Dot(center + up * halfSize.y)));
+    }
+    else
+    {
+        hull->Add(Planef(up, -up.Dot(center) - halfSize.y));
+    }
+    return hull;
+}
+
+// Walls spread over a square whose area grows with the hull count, and a grid of
+// floor tiles with a quarter as many hulls.
+static float MakeCollisionScene(int hullCount, Array<Ptr<CollisionModel> >* walls,
+                                Array<Ptr<CollisionModel> >* ground)
+{
+    float    size = sqrtf((float)hullCount) * 4.0f;
+    unsigned seed = (unsigned)hullCount;
+
+    for (int i = 0; i < hullCount; i++)
+    {
+        float r[6];
+        for (int j = 0; j < 6; j++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            r[j] = ((seed >> 8) & 0xFFFF) / 65535.0f;
+        }
+        Vector3f halfSize(0.2f + r[3], 0.5f + r[4] * 1.5f, 0.2f + r[5]);
+        Vector3f center(r[0] * size, halfSize.y, r[1] * size);
+        walls->PushBack(MakeCollisionHull(center, halfSize, r[2] * 3.0f, (i % 3) == 0));
+    }
+
+    int   tiles    = Alg::Max(1, (int)sqrtf(hullCount / 4.0f));
+    float tileSize = size / tiles;
+    for (int z = 0; z < tiles; z++)
+    {
+        for (int x = 0; x < tiles; x++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            float    height = ((seed >> 8) & 0xFF) / 1024.0f;
+            // Deep enough to hold the end of the 10 unit ground probe.
+            Vector3f halfSize(tileSize * 0.5f, 10.0f, tileSize * 0.5f);
+            Vector3f center((x + 0.5f) * tileSize, height - 10.0f, (z + 0.5f) * tileSize);
+            ground->PushBack(MakeCollisionHull(center, halfSize, 0, false));
+        }
+    }
+    return size;
+}
+
+// Everything Player::HandleCollision asks for at one position.
+struct CollisionProbe
+{
+    float  Length[3];
+    Planef Plane[3];
+    bool   Hit[3];
+    bool   Corner;
+    float  Ground;
+};
+
+static bool ProbesMatch(const CollisionProbe& a, const CollisionProbe& b)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        if (a.Hit[i] != b.Hit[i] || a.Length[i] != b.Length[i] ||
+            (a.Hit[i] && (a.Plane[i].N != b.Plane[i].N || a.Plane[i].D != b.Plane[i].D)))
+            return false;
+    }
+    return a.Corner == b.Corner && a.Ground == b.Ground;
+}
+
+static void ProbeModels(const Array<Ptr<CollisionModel> >& walls, const Array<Ptr<CollisionModel> >& ground,
+                        const Vector3f& pos, const Vector3f* dirs, float moveLength, CollisionProbe* probe)
+{
+    for (int d = 0; d < 3; d++)
+    {
+        probe->Length[d] = moveLength;
+        probe->Hit[d]    = false;
+        for (UPInt i = 0; i < walls.GetSize(); i++)
+            if (walls[i]->TestRay(pos, dirs[d], probe->Length[d], &probe->Plane[d]))
+                probe->Hit[d] = true;
+    }
+
+    probe->Corner = false;
+    for (UPInt i = 0; i < walls.GetSize() && !probe->Corner; i++)
+        probe->Corner = walls[i]->TestPoint(pos + dirs[0] * moveLength);
+
+    probe->Ground = 10.0f;
+    for (UPInt i = 0; i < ground.GetSize(); i++)
+    {
+        float  checkLength = 10.0f;
+        Planef plane;
+        if (ground[i]->TestRay(pos, Vector3f(0, -1, 0), checkLength, &plane))
+            probe->Ground = Alg::Min(probe->Ground, checkLength);
+    }
+}
+
+static void ProbeTrees(const CollisionTree& walls, const CollisionTree& ground,
+                       const Vector3f& pos, const Vector3f* dirs, float moveLength, CollisionProbe* probe)
+{
+    CollisionRay rays[3];
+    for (int d = 0; d < 3; d++)
+        rays[d] = CollisionRay(pos, dirs[d], moveLength);
+    walls.TestRays(rays, 3);
+    for (int d = 0; d < 3; d++)
+    {
+        probe->Length[d] = rays[d].Length;
+        probe->Plane[d]  = rays[d].Plane;
+        probe->Hit[d]    = rays[d].Hit;
+    }
+    probe->Corner = walls.TestPoint(pos + dirs[0] * moveLength);
+    probe->Ground = 10.0f;
+    ground.TestRayNearest(pos, Vector3f(0, -1, 0), probe->Ground);
+}
+
+// Sweeps the same path through each scene with the per-model loops of
+// Player::HandleCollision and with the trees, and checks every result matches.
+static bool BenchmarkCollisionTree()
+{
+    static const int hullCounts[] = { 100, 1000, 10000, 100000 };
+    bool passed = true;
+
+    LogText("Collision queries along a player path, per-model loops vs. tree\n");
+    LogText("%8s %8s %10s %7s %14s %14s %8s\n", "Hulls", "Nodes", "Build ms", "Steps",
+            "Loop us/step", "Tree us/step", "Speedup");
+
+    for (UPInt c = 0; c < sizeof(hullCounts) / sizeof(hullCounts[0]); c++)
+    {
+        int hullCount = hullCounts[c];
+        Array<Ptr<CollisionModel> > walls, ground;
+        float size = MakeCollisionScene(hullCount, &walls, &ground);
+
+        double        t0 = GetBenchmarkTime();
+        CollisionTree wallTree, groundTree;
+        wallTree.Build(walls);
+        groundTree.Build(ground);
+        double buildSeconds = GetBenchmarkTime() - t0;
+
+        // The per-model loops get slow with many hulls; fewer steps keep the run short.
+        int steps = Alg::Max(200, Alg::Min(5000, 20000000 / hullCount));
+
+        Array<CollisionProbe> loopProbes, treeProbes;
+        loopProbes.Resize(steps);
+        treeProbes.Resize(steps);
+
+        Matrix4f leftRotation  = Matrix4f::RotationY( 45 * (Math<float>::Pi / 180.0f));
+        Matrix4f rightRotation = Matrix4f::RotationY(-45 * (Math<float>::Pi / 180.0f));
+        Array<Vector3f> positions, directions;
+        for (int i = 0; i < steps; i++)
+        {
+            // A Lissajous curve covers the scene without leaving it.
+            float t = (float)i / steps * 2.0f * Math<float>::Pi;
+            Vector3f pos(size * (0.5f + 0.45f * sinf(3 * t)), 1.8f, size * (0.5f + 0.45f * sinf(2 * t)));
+            Vector3f dir(3 * cosf(3 * t), 0, 2 * cosf(2 * t));
+            dir.Normalize();
+            positions.PushBack(pos);
+            directions.PushBack(dir);
+            directions.PushBack(leftRotation.Transform(dir));
+            directions.PushBack(rightRotation.Transform(dir));
+        }
+
+        t0 = GetBenchmarkTime();
+        for (int i = 0; i < steps; i++)
+            ProbeModels(walls, ground, positions[i], &directions[i * 3], 0.5f, &loopProbes[i]);
+        double loopSeconds = GetBenchmarkTime() - t0;
+
+        t0 = GetBenchmarkTime();
+        for (int i = 0; i < steps; i++)
+            ProbeTrees(wallTree, groundTree, positions[i], &directions[i * 3], 0.5f, &treeProbes[i]);
+        double treeSeconds = GetBenchmarkTime() - t0;
+
+        int mismatches = 0;
+        for (int i = 0; i < steps; i++)
+            if (!ProbesMatch(loopProbes[i], treeProbes[i]))
+                mismatches++;
+
+        LogText("%8d %8d %10.2f %7d %14.2f %14.2f %7.1fx", hullCount,
+                (int)(wallTree.GetNodeCount() + groundTree.GetNodeCount()), buildSeconds * 1000.0, steps,
+                loopSeconds * 1e6 / steps, treeSeconds * 1e6 / steps, loopSeconds / treeSeconds);
+        if (mismatches)
+        {
+            LogText("  ERROR: %d steps differ", mismatches);
+            passed = false;
+        }
+        LogText("\n");
+    }
+
+    return passed;
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** Ray vs. hull kernels
+
+static const char* GetCollisionKernelName(CollisionKernelPath path)
+{
+    switch (path)
+    {
+    case CollisionKernel_Scalar: return "Scalar";
+    case CollisionKernel_SSE2:   return "SSE2";
+    case CollisionKernel_AVX2:   return "AVX2";
+    default:                     return "Auto";
+    }
+}
+
+// A vertical prism with the given number of sides, closed at both ends.
+static Ptr<CollisionModel> MakePrismHull(const Vector3f& center, float radius, float halfHeight, int sides)
+{
+    Ptr<CollisionModel> hull = *new CollisionModel();
+    for (int i = 0; i < sides; i++)
+    {
+        float    angle = (i + 0.5f) * 2.0f * Math<float>::Pi / sides;
+        Vector3f n(cosf(angle), 0, sinf(angle));
+        hull->Add(Planef(n, -n.Dot(center) - radius));
+    }
+    hull->Add(Planef(Vector3f(0,  1, 0), -center.y - halfHeight));
+    hull->Add(Planef(Vector3f(0, -1, 0),  center.y - halfHeight));
+    return hull;
+}
+
+static bool CollisionRaysMatch(const CollisionRay& a, const CollisionRay& b)
+{
+    return a.Hit == b.Hit && a.Length == b.Length &&
+           (!a.Hit || (a.Plane.N == b.Plane.N && a.Plane.D == b.Plane.D));
+}
+
+// Fires batches of rays, as HandleCollision does, at hulls with more and more
+// planes, and checks each kernel against the scalar TestRay code.
+static bool BenchmarkCollisionKernel()
+{
+    static const int                 planeCounts[] = { 6, 10, 18, 34 };
+    static const CollisionKernelPath paths[] = { CollisionKernel_Scalar, CollisionKernel_SSE2, CollisionKernel_AVX2 };
+    static const int hullCount   = 256;
+    static const int raysPerHull = 256;
+    static const int batchSize   = 4;
+    static const int repeatCount = 5;
+    bool passed = true;
+
+    LogText("Ray vs. hull tests, batches of %d rays (best of %d runs)\n", batchSize, repeatCount);
+    LogText("%7s %8s %12s %9s %8s\n", "Planes", "Path", "ns/ray test", "Hits", "Speedup");
+
+    for (UPInt c = 0; c < sizeof(planeCounts) / sizeof(planeCounts[0]); c++)
+    {
+        Array<Ptr<CollisionModel> > hulls;
+        Array<CollisionRay>         rays, reference, results;
+        unsigned seed = 7;
+        for (int h = 0; h < hullCount; h++)
+        {
+            // Every hull and its rays share one frame near the origin: far from
+            // it, float rounding moves TestRay's hit point off the plane by more
+            // than its assert allows.
+            Vector3f center(0, 1.0f, 0);
+            hulls.PushBack(MakePrismHull(center, 1.0f, 1.0f, planeCounts[c] - 2));
+
+            // Rays start within two radii and reach about one radius, so some start
+            // inside, some cross a plane and most miss.
+            for (int r = 0; r < raysPerHull; r++)
+            {
+                float v[6];
+                for (int j = 0; j < 6; j++)
+                {
+                    seed = seed * 1103515245u + 12345u;
+                    v[j] = ((seed >> 8) & 0xFFFF) / 32767.5f - 1.0f;
+                }
+                Vector3f dir(v[3], v[4] * 0.25f, v[5]);
+                if (dir.LengthSq() < 1e-4f)
+                    dir = Vector3f(1, 0, 0);
+                rays.PushBack(CollisionRay(center + Vector3f(v[0], v[1], v[2]) * 2.0f, dir.Normalized(), 1.0f));
+            }
+        }
+        results.Resize(rays.GetSize());
+
+        double scalarSeconds = 0;
+        for (UPInt p = 0; p < sizeof(paths) / sizeof(paths[0]); p++)
+        {
+            double best = 1e10;
+            int    hits = 0;
+            for (int repeat = 0; repeat < repeatCount; repeat++)
+            {
+                for (UPInt i = 0; i < rays.GetSize(); i++)
+                    results[i] = rays[i];
+
+                hits = 0;
+                double t0 = GetBenchmarkTime();
+                for (int h = 0; h < hullCount; h++)
+                    for (int r = 0; r < raysPerHull; r += batchSize)
+                        hits += hulls[h]->TestRays(&results[h * raysPerHull + r], batchSize, paths[p]);
+                best = Alg::Min(best, GetBenchmarkTime() - t0);
+            }
+
+            int mismatches = 0;
+            if (p == 0)
+            {
+                scalarSeconds = best;
+                reference = results;
+            }
+            for (UPInt i = 0; i < results.GetSize(); i++)
+                if (!CollisionRaysMatch(results[i], reference[i]))
+                    mismatches++;
+
+            LogText("%7d %8s %12.2f %9d %7.1fx", planeCounts[c], GetCollisionKernelName(paths[p]),
+                    best * 1e9 / rays.GetSize(), hits, scalarSeconds / best);
+            if (mismatches)
+            {
+                LogText("  ERROR: %d rays differ from scalar", mismatches);
+                passed = false;
+            }
+            LogText("\n");
+        }
+    }
+
+    return passed;
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** Ground grid
+
+// Floor tiles of varied height, every other one sloped, like the ground hulls of
+// a terrain export. Tiles are deep enough to hold the end of the ground probe.
+static float MakeGroundScene(int tilesPerSide, Array<Ptr<CollisionModel> >* ground)
+{
+    const float tileSize = 4.0f;
+    unsigned    seed = (unsigned)tilesPerSide;
+    for (int z = 0; z < tilesPerSide; z++)
+    {
+        for (int x = 0; x < tilesPerSide; x++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            float    height = ((seed >> 8) & 0xFF) / 256.0f;
+            Vector3f halfSize(tileSize * 0.5f, 10.0f, tileSize * 0.5f);
+            Vector3f center((x + 0.5f) * tileSize, height - 10.0f, (z + 0.5f) * tileSize);
+            ground->PushBack(MakeCollisionHull(center, halfSize, 0, ((x + z) & 1) != 0));
+        }
+    }
+    return tilesPerSide * tileSize;
+}
+
+static bool GroundRayBruteForce(const Array<Ptr<CollisionModel> >& ground, const Vector3f& origin, float* distance)
+{
+    bool hit = false;
+    *distance = 10.0f;
+    for (UPInt i = 0; i < ground.GetSize(); i++)
+    {
+        float  checkLength = 10.0f;
+        Planef plane;
+        if (ground[i]->TestRay(origin, Vector3f(0, -1, 0), checkLength, &plane))
+        {
+            *distance = Alg::Min(*distance, checkLength);
+            hit = true;
+        }
+    }
+    return hit;
+}
+
+// Compares the grid with the per-model loop of Player::HandleCollision on a dense
+// set of points, then bakes a heightfield and checks every sample against the loop.
+// Between samples the heightfield must be within MaxStep of the loop wherever it
+// answers; across steps between tiles it must decline and leave it to the probe.
+static bool BenchmarkGroundGrid()
+{
+    static const int tileCounts[] = { 16, 64, 256 };
+    bool passed = true;
+
+    LogText("Ground probes, per-model loop vs. grid\n");
+    LogText("%8s %8s %8s %14s %14s %14s %8s\n", "Hulls", "Cells", "Probes",
+            "Loop ns/probe", "Grid ns/probe", "Field ns/probe", "Speedup");
+
+    for (UPInt c = 0; c < sizeof(tileCounts) / sizeof(tileCounts[0]); c++)
+    {
+        Array<Ptr<CollisionModel> > ground;
+        float size = MakeGroundScene(tileCounts[c], &ground);
+
+        GroundGrid grid;
+        grid.Build(ground);
+        GroundHeightfield heightfield;
+        heightfield.Bake(grid, 0.5f);
+
+        // The loop gets slow with many hulls; fewer probes keep the run short.
+        int probesPerSide = Alg::Max(32, Alg::Min(512, (int)(4096 / tileCounts[c])));
+        int probeCount    = probesPerSide * probesPerSide;
+        Array<Vector3f> probes;
+        for (int z = 0; z < probesPerSide; z++)
+            for (int x = 0; x < probesPerSide; x++)
+                probes.PushBack(Vector3f((x + 0.37f) * size / probesPerSide, 1.8f, (z + 0.61f) * size / probesPerSide));
+
+        Array<float> loopDistances, gridDistances;
+        loopDistances.Resize(probeCount);
+        gridDistances.Resize(probeCount);
+
+        double t0 = GetBenchmarkTime();
+        for (int i = 0; i < probeCount; i++)
+            GroundRayBruteForce(ground, probes[i], &loopDistances[i]);
+        double loopSeconds = GetBenchmarkTime() - t0;
+
+        t0 = GetBenchmarkTime();
+        for (int i = 0; i < probeCount; i++)
+        {
+            gridDistances[i] = 10.0f;
+            grid.TestRayDown(probes[i], gridDistances[i]);
+        }
+        double gridSeconds = GetBenchmarkTime() - t0;
+
+        float fieldSum = 0;
+        t0 = GetBenchmarkTime();
+        for (int i = 0; i < probeCount; i++)
+        {
+            float height = 0;
+            heightfield.GetHeight(probes[i].x, probes[i].z, &height);
+            fieldSum += height;
+        }
+        double fieldSeconds = GetBenchmarkTime() - t0;
+
+        int mismatches = 0;
+        for (int i = 0; i < probeCount; i++)
+            if (loopDistances[i] != gridDistances[i])
+                mismatches++;
+
+        LogText("%8d %8d %8d %14.1f %14.1f %14.1f %7.1fx", (int)ground.GetSize(),
+                grid.GetCellsX() * grid.GetCellsZ(), probeCount, loopSeconds * 1e9 / probeCount,
+                gridSeconds * 1e9 / probeCount, fieldSeconds * 1e9 / probeCount, loopSeconds / gridSeconds);
+        if (mismatches)
+        {
+            LogText("  ERROR: %d probes differ", mismatches);
+            passed = false;
+        }
+        LogText("\n");
+        OVR_UNUSED(fieldSum);
+    }
+
+    // Heightfield against the per-model loop at every sample.
+    Array<Ptr<CollisionModel> > ground;
+    MakeGroundScene(32, &ground);
+    GroundGrid grid;
+    grid.Build(ground);
+
+    GroundHeightfield heightfield;
+    double t0 = GetBenchmarkTime();
+    heightfield.Bake(grid, 0.25f);
+    double bakeSeconds = GetBenchmarkTime() - t0;
+
+    int   sampleMismatches = 0;
+    int   interpolated = 0, interpolatedOff = 0, declined = 0;
+    float maxError = 0;
+    for (int z = 0; z < heightfield.GetSamplesZ(); z++)
+    {
+        for (int x = 0; x < heightfield.GetSamplesX(); x++)
+        {
+            Vector3f pos = heightfield.GetSamplePosition(x, z);
+            float    distance, height;
+            bool     hit = GroundRayBruteForce(ground, pos, &distance);
+            bool     baked = heightfield.GetSampleHeight(x, z, &height);
+            if (hit != baked || (hit && height != pos.y - distance))
+                sampleMismatches++;
+
+            // Between samples, away from the cell centre the bake checks.
+            Vector3f mid = pos + Vector3f(0.08f, 0, 0.17f);
+            if (GroundRayBruteForce(ground, mid, &distance))
+            {
+                if (!heightfield.GetHeight(mid.x, mid.z, &height))
+                {
+                    declined++;
+                    continue;
+                }
+                float error = fabsf(height - (mid.y - distance));
+                maxError = Alg::Max(maxError, error);
+                interpolated++;
+                if (error > GroundHeightfield::MaxStep)
+                    interpolatedOff++;
+            }
+        }
+    }
+
+    LogText("Heightfield %dx%d baked in %.1f ms: %d samples differ from the loop%s\n",
+            heightfield.GetSamplesX(), heightfield.GetSamplesZ(), bakeSeconds * 1000.0, sampleMismatches,
+            sampleMismatches ? "  ERROR" : "");
+    LogText("Between samples: %d interpolated, %d left to the probe, %d off by more than %.2f, max %.3f%s\n",
+            interpolated, declined, interpolatedOff, GroundHeightfield::MaxStep, maxError,
+            interpolatedOff ? "  ERROR" : "");
+
+    return passed && !sampleMismatches && !interpolatedOff;
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** Capsule controller
+
+// Rooms 8 units across, split by 2 cm walls with a doorway in the middle of each
+// side, with pillars in every room and a cluttered block of crates in one.
+static void MakeRoomScene(int roomsPerSide, Array<Ptr<CollisionModel> >* walls)
+{
+    const float room = 8.0f, door = 1.2f, thickness = 0.01f;
+    const float segment = (room - door) * 0.5f;
+
+    for (int line = 0; line <= roomsPerSide; line++)
+    {
+        for (int r = 0; r < roomsPerSide; r++)
+        {
+            for (int side = 0; side < 2; side++)
+            {
+                float along = r * room + (side ? room - segment * 0.5f : segment * 0.5f);
+                walls->PushBack(MakeCollisionHull(Vector3f(line * room, 1.5f, along),
+                                                  Vector3f(thickness, 2.5f, segment * 0.5f), 0, false));
+                walls->PushBack(MakeCollisionHull(Vector3f(along, 1.5f, line * room),
+                                                  Vector3f(segment * 0.5f, 2.5f, thickness), 0, false));
+            }
+        }
+    }
+
+    unsigned seed = 11;
+    for (int z = 0; z < roomsPerSide; z++)
+    {
+        for (int x = 0; x < roomsPerSide; x++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            float offset = ((seed >> 8) & 0xFF) / 255.0f * 2.0f - 1.0f;
+            walls->PushBack(MakePrismHull(Vector3f(x * room + 2.5f + offset, 1.5f, z * room + 5.5f), 0.3f, 2.5f, 8));
+        }
+    }
+
+    for (int i = 0; i < 400; i++)
+    {
+        float v[3];
+        for (int j = 0; j < 3; j++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            v[j] = ((seed >> 8) & 0xFFFF) / 65535.0f;
+        }
+        walls->PushBack(MakeCollisionHull(Vector3f(room + 0.5f + v[0] * 7.0f, 0.5f, room + 0.5f + v[1] * 7.0f),
+                                          Vector3f(0.15f, 1.5f, 0.15f), v[2] * 3.0f, false));
+    }
+}
+
+// Input tapes of walks that mostly run at 75 fps but have long hitches, like a
+// frame lost to a loading stall, and stretches held on Shift.
+static void MakeReplayTape(unsigned seed, int frameCount, Array<ReplayFrame>* tape)
+{
+    float yaw   = 0;
+    bool  shift = false;
+    for (int i = 0; i < frameCount; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        unsigned r = seed >> 8;
+
+        ReplayFrame frame;
+        frame.Dt = (r % 100) < 5 ? 0.1f + (r % 7) * 0.07f : 1.0f / 75.0f;
+        if ((r % 200) == 0)
+            shift = !shift;
+        yaw += (((r >> 8) & 0xFF) / 255.0f - 0.5f) * 0.2f;
+        frame.Yaw     = yaw;
+        frame.Forward = (r % 50) != 0;
+        frame.Left    = ((r >> 4) % 16) == 0;
+        frame.Shift   = shift;
+        tape->PushBack(frame);
+    }
+}
+
+// The wall handling HandleCollision had before the capsule: an eye level ray
+// forward and a corner check at rail height. Kept to count how often it tunnels.
+static Vector3f LegacyWallStep(const CollisionTree& walls, const Vector3f& eye, Vector3f dir, float moveLength)
+{
+    float  checkLength = moveLength;
+    Planef plane;
+    if (walls.TestRay(eye, dir, checkLength, &plane))
+    {
+        Vector3f slide = dir - plane.N * (dir * plane.N);
+        if (walls.TestPoint(eye - Vector3f(0.0f, RailHeight, 0.0f) + slide * moveLength))
+            moveLength = 0;
+        else
+            dir = slide;
+    }
+    return eye + dir * moveLength;
+}
+
+// Whether the path of a point crosses any model.
+static bool PathCrossesModels(const CollisionTree& walls, const Vector3f& from, const Vector3f& to)
+{
+    CapsuleController point(0, 0);
+    Array<UInt32>     models;
+    Vector3f          boxMin(Alg::Min(from.x, to.x), Alg::Min(from.y, to.y), Alg::Min(from.z, to.z));
+    Vector3f          boxMax(Alg::Max(from.x, to.x), Alg::Max(from.y, to.y), Alg::Max(from.z, to.z));
+    walls.GetModelsInBox(boxMin, boxMax, &models);
+    for (UPInt i = 0; i < models.GetSize(); i++)
+    {
+        CapsuleSweep sweep;
+        if (point.Sweep(walls.GetModel(models[i]), from, to - from, &sweep))
+            return true;
+    }
+    return false;
+}
+
+// Replays input tapes through Player::HandleCollision twice and checks that the
+// runs match exactly, that the body never overlaps or passes through a wall and
+// that the plane tests per frame stay within the controller's budget.
+static bool BenchmarkCapsuleController()
+{
+    static const int tapeCount  = 8;
+    static const int frameCount = 3000;
+
+    Array<Ptr<CollisionModel> > wallModels, groundModels;
+    MakeRoomScene(4, &wallModels);
+    MakeGroundScene(8, &groundModels);
+
+    CollisionTree walls;
+    walls.Build(wallModels);
+    GroundGrid ground;
+    ground.Build(groundModels);
+
+    LogText("Capsule controller replay: %d walls, %d tapes of %d frames\n",
+            (int)wallModels.GetSize(), tapeCount, frameCount);
+    LogText("%5s %9s %9s %9s %11s %11s %9s %8s %8s\n", "Tape", "Overlaps", "Tunnels", "Replay", "Planes max",
+            "Planes avg", "us p99", "us max", "Old tun.");
+
+    Array<double> frameTimes;
+    int totalFailures = 0;
+
+    for (int t = 0; t < tapeCount; t++)
+    {
+        Array<ReplayFrame> tape;
+        MakeReplayTape(1000 + t, frameCount, &tape);
+
+        Vector3f positions[2];
+        int      overlaps = 0, tunnels = 0, legacyTunnels = 0, maxPlanes = 0;
+        double   planeSum = 0;
+        frameTimes.Clear();
+
+        for (int run = 0; run < 2; run++)
+        {
+            Player player;
+            player.EyePos = Vector3f(4.0f + t * 8.0f / tapeCount, player.EyeHeight, 4.0f);
+            Vector3f legacyEye = player.EyePos;
+
+            for (int f = 0; f < frameCount; f++)
+            {
+                const ReplayFrame& frame = tape[f];
+                player.EyeYaw      = frame.Yaw;
+                player.MoveForward = frame.Forward ? 1 : 0;
+                player.MoveLeft    = frame.Left ? 1 : 0;
+
+                Vector3f before = player.EyePos;
+                double   t0 = GetBenchmarkTime();
+                player.HandleCollision(frame.Dt, &walls, &ground, NULL, frame.Shift);
+                double   seconds = GetBenchmarkTime() - t0;
+
+                if (run == 0)
+                {
+                    Vector3f base = player.EyePos - Vector3f(0, player.Body.Height, 0);
+                    const CapsuleController::MoveStats& stats = player.Body.GetLastStats();
+                    frameTimes.PushBack(seconds);
+                    maxPlanes = Alg::Max(maxPlanes, stats.PlaneTests);
+                    planeSum += stats.PlaneTests;
+                    if (player.Body.Overlaps(walls, base, 1e-4f))
+                        overlaps++;
+                    if (PathCrossesModels(walls, before, player.EyePos) ||
+                        PathCrossesModels(walls, before - Vector3f(0, RailHeight, 0),
+                                          player.EyePos - Vector3f(0, RailHeight, 0)))
+                        tunnels++;
+
+                    // The old probes, moved along the same input in the horizontal plane.
+                    Vector3f dir = Matrix4f::RotationY(frame.Yaw).Transform(
+                                       (frame.Forward ? ForwardVector : Vector3f(0, 0, 0)) -
+                                       (frame.Left ? RightVector : Vector3f(0, 0, 0)));
+                    if (dir.LengthSq() > 0)
+                    {
+                        dir.Normalize();
+                        float    moveLength = Alg::Min(MoveSpeed * frame.Dt * (frame.Shift ? 3.0f : 1.0f), 1.0f);
+                        Vector3f next = LegacyWallStep(walls, legacyEye, dir, moveLength);
+                        if (PathCrossesModels(walls, legacyEye, next))
+                            legacyTunnels++;
+                        legacyEye = next;
+                    }
+                }
+            }
+            positions[run] = player.EyePos;
+        }
+
+        SortBenchmarkTimes(&frameTimes);
+
+        bool replayMatches = positions[0] == positions[1];
+        bool failed = overlaps || tunnels || !replayMatches || maxPlanes > CapsuleController::MaxPlaneTestsPerMove;
+        totalFailures += failed ? 1 : 0;
+
+        LogText("%5d %9d %9d %9s %11d %11.1f %9.2f %8.2f %8d%s\n", t, overlaps, tunnels,
+                replayMatches ? "same" : "DIFFERS", maxPlanes, planeSum / frameCount,
+                frameTimes[frameTimes.GetSize() * 99 / 100] * 1e6, frameTimes[frameTimes.GetSize() - 1] * 1e6,
+                legacyTunnels, failed ? "  ERROR" : "");
+    }
+
+    // The densest tape again with a plane test budget far below what its moves
+    // need: moves must stop short of the models they couldn't test, not pass
+    // through them, and the player must still get around.
+    static const int tightBudget = 48;
+    Array<ReplayFrame> tape;
+    MakeReplayTape(1003, frameCount, &tape);
+
+    float travelled[2] = { 0, 0 };
+    int   overlaps = 0, tunnels = 0, outOfBudget = 0, overBudget = 0;
+    for (int run = 0; run < 2; run++)
+    {
+        Player player;
+        player.EyePos = Vector3f(4.0f + 3 * 8.0f / tapeCount, player.EyeHeight, 4.0f);
+        int budget = run ? tightBudget : (int)CapsuleController::MaxPlaneTestsPerMove;
+
+        for (int f = 0; f < frameCount; f++)
+        {
+            const ReplayFrame& frame = tape[f];
+            player.EyeYaw      = frame.Yaw;
+            player.MoveForward = frame.Forward ? 1 : 0;
+            player.MoveLeft    = frame.Left ? 1 : 0;
+
+            Vector3f before = player.EyePos;
+            int      planes = player.HandleCollision(frame.Dt, &walls, &ground, NULL, frame.Shift, budget);
+            travelled[run] += (player.EyePos - before).Length();
+
+            if (run == 1)
+            {
+                Vector3f base = player.EyePos - Vector3f(0, player.Body.Height, 0);
+                if (planes && player.Body.GetLastStats().OutOfBudget)
+                    outOfBudget++;
+                if (planes > budget)
+                    overBudget++;
+                if (player.Body.Overlaps(walls, base, 1e-4f))
+                    overlaps++;
+                if (PathCrossesModels(walls, before, player.EyePos) ||
+                    PathCrossesModels(walls, before - Vector3f(0, RailHeight, 0),
+                                      player.EyePos - Vector3f(0, RailHeight, 0)))
+                    tunnels++;
+            }
+        }
+    }
+
+    bool tightFailed = overlaps || tunnels || overBudget || travelled[1] <= 0;
+    LogText("Budget of %d planes: %d of %d moves out of budget, %d over it, %d overlaps, %d tunnels, "
+            "%.1f m travelled of %.1f m%s\n", tightBudget, outOfBudget, frameCount, overBudget, overlaps,
+            tunnels, travelled[1], travelled[0], tightFailed ? "  ERROR" : "");
+
+    // The same tape through the fixed step clock, as the demo runs it: its hitches
+    // run up to MaxPhysicsStepsPerFrame steps in a frame, which together must stay
+    // within MaxPlaneTestsPerFrame.
+    Player player;
+    player.EyePos = Vector3f(4.0f + 3 * 8.0f / tapeCount, player.EyeHeight, 4.0f);
+    double time = 0;
+    player.ResetPhysicsClock(time);
+
+    int maxStepPlanes = 0, maxFramePlanes = 0, maxSteps = 0;
+    overlaps = tunnels = 0;
+    for (int f = 0; f < frameCount; f++)
+    {
+        const ReplayFrame& frame = tape[f];
+        player.EyeYaw      = frame.Yaw;
+        player.MoveForward = frame.Forward ? 1 : 0;
+        player.MoveLeft    = frame.Left ? 1 : 0;
+
+        time += frame.Dt;
+        int steps = player.GetDuePhysicsSteps(time);
+        int framePlanes = 0;
+        for (int i = 0; i < steps; i++)
+        {
+            Vector3f before = player.EyePos;
+            int      planes = player.StepPhysics(&walls, &ground, NULL, frame.Shift);
+            maxStepPlanes = Alg::Max(maxStepPlanes, planes);
+            framePlanes  += planes;
+
+            Vector3f base = player.EyePos - Vector3f(0, player.Body.Height, 0);
+            if (player.Body.Overlaps(walls, base, 1e-4f))
+                overlaps++;
+            if (PathCrossesModels(walls, before, player.EyePos) ||
+                PathCrossesModels(walls, before - Vector3f(0, RailHeight, 0),
+                                  player.EyePos - Vector3f(0, RailHeight, 0)))
+                tunnels++;
+        }
+        maxFramePlanes = Alg::Max(maxFramePlanes, framePlanes);
+        maxSteps       = Alg::Max(maxSteps, steps);
+    }
+
+    bool stepsFailed = overlaps || tunnels || maxStepPlanes > PlaneTestsPerPhysicsStep ||
+                       maxFramePlanes > MaxPlaneTestsPerFrame;
+    LogText("Fixed steps: up to %d steps and %d plane tests a frame (budget %d), %d a step (budget %d), "
+            "%d overlaps, %d tunnels%s\n", maxSteps, maxFramePlanes, MaxPlaneTestsPerFrame, maxStepPlanes,
+            PlaneTestsPerPhysicsStep, overlaps, tunnels, stepsFailed ? "  ERROR" : "");
+
+    bool passed = !totalFailures && !tightFailed && !stepsFailed;
+    LogText("%s\n", passed ? "All tapes passed" : "ERROR: capsule replay failed");
+
+    return passed;
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** Fixed timestep
+
+// The same input by step as a tape of frames, for replaying a capsule tape
+// through the fixed step clock.
+static void MakeStepInputFromTape(const Array<ReplayFrame>& tape, Array<ReplayFrame>* trace)
+{
+    double frameEnd = 0;
+    for (UPInt f = 0; f < tape.GetSize(); f++)
+    {
+        frameEnd += tape[f].Dt;
+        while ((double)trace->GetSize() / PhysicsStepsPerSecond < frameEnd)
+        {
+            ReplayFrame input = tape[f];
+            input.Dt = 1.0f / PhysicsStepsPerSecond;
+            trace->PushBack(input);
+        }
+    }
+}
+
+// Runs every step of trace through the fixed step clock at frameRate, or at an
+// irregular rate with hitches if it is 0, and records the position after each
+// and how many of the steps ran out of plane budget. variable, if given, is moved
+// by the frame time instead, as before the fixed steps. Returns the number of frames.
+static int ReplayFixedSteps(const CollisionTree& walls, const GroundGrid& ground,
+                            const Array<ReplayFrame>& trace, Player* fixed, float frameRate,
+                            Array<Vector3f>* positions, int* outOfBudget, Player* variable = NULL)
+{
+    static const double startTime = 1234.5;
+    fixed->ResetPhysicsClock(startTime);
+
+    UPInt    stepCount = trace.GetSize();
+    unsigned seed   = 99;
+    double   time   = startTime;
+    int      frames = 0;
+    *outOfBudget = 0;
+
+    while (positions->GetSize() < stepCount)
+    {
+        // A rate of 0 is irregular: 5 to 40 ms frames with a 200 ms stall now and then.
+        double frameTime;
+        if (frameRate > 0)
+        {
+            frameTime = 1.0 / frameRate;
+        }
+        else
+        {
+            seed = seed * 1103515245u + 12345u;
+            frameTime = ((seed >> 8) % 100) < 2 ? 0.2 : 0.005 + ((seed >> 8) % 36) * 0.001;
+        }
+        double lastTime = time;
+        time += frameTime;
+        frames++;
+
+        int steps = fixed->GetDuePhysicsSteps(time);
+        for (int i = 0; i < steps && positions->GetSize() < stepCount; i++)
+        {
+            const ReplayFrame& input = trace[positions->GetSize()];
+            ApplyReplayInput(fixed, input);
+            if (fixed->StepPhysics(&walls, &ground, NULL, input.Shift) && fixed->Body.GetLastStats().OutOfBudget)
+                (*outOfBudget)++;
+            positions->PushBack(fixed->EyePos);
+        }
+
+        // The old loop: input as sampled at the frame, moved by the frame time.
+        if (variable)
+        {
+            UPInt sample = Alg::Min((UPInt)((lastTime - startTime) * PhysicsStepsPerSecond), stepCount - 1);
+            ApplyReplayInput(variable, trace[sample]);
+            variable->HandleCollision(time - lastTime, &walls, &ground, NULL, trace[sample].Shift);
+        }
+    }
+    return frames;
+}
+
+static int CountMismatches(const Array<Vector3f>& positions, const Array<Vector3f>& reference)
+{
+    int mismatches = 0;
+    for (UPInt i = 0; i < positions.GetSize(); i++)
+    {
+        if (positions[i] != reference[i])
+            mismatches++;
+    }
+    return mismatches;
+}
+
+static void FormatFrameRate(float frameRate, char* text, UPInt size)
+{
+    if (frameRate > 0)
+        OVR_sprintf(text, size, "%.0f", frameRate);
+    else
+        OVR_sprintf(text, size, "jitter");
+}
+
+// Plays one input trace at several frame rates, including an irregular one with
+// hitches, and checks that every fixed step lands on exactly the same position.
+// The same frames stepped with the frame time, as before, are shown for comparison.
+// Then the densest tape of the capsule benchmark is played the same way with a
+// plane budget that most of its steps run out of, at low and irregular rates.
+static bool BenchmarkFixedTimestep()
+{
+    static const int   stepCount = PhysicsStepsPerSecond * 30;
+    static const float frameRates[] = { 240.0f, 144.0f, 90.0f, 75.0f, 60.0f, 30.0f, 13.0f, 0.0f };
+    static const float denseRates[] = { 240.0f, 60.0f, 13.0f, 5.0f, 0.0f };
+    static const int   denseBudget  = 48;
+
+    Array<Ptr<CollisionModel> > wallModels, groundModels;
+    MakeRoomScene(4, &wallModels);
+    MakeGroundScene(8, &groundModels);
+
+    // Closes the outer doorways so the walk stays on the ground.
+    for (int side = 0; side < 2; side++)
+    {
+        wallModels.PushBack(MakeCollisionHull(Vector3f(side * 32.0f, 1.5f, 16.0f), Vector3f(0.01f, 2.5f, 16.0f), 0, false));
+        wallModels.PushBack(MakeCollisionHull(Vector3f(16.0f, 1.5f, side * 32.0f), Vector3f(16.0f, 2.5f, 0.01f), 0, false));
+    }
+    CollisionTree walls;
+    walls.Build(wallModels);
+    GroundGrid ground;
+    ground.Build(groundModels);
+
+    Array<ReplayFrame> trace;
+    MakeStepInputTrace(7, stepCount, &trace);
+
+    Array<Vector3f> reference;
+    int             failures = 0;
+
+    LogText("Fixed timestep: %d steps at %d Hz\n", stepCount, PhysicsStepsPerSecond);
+    LogText("%8s %8s %10s %12s %14s\n", "FPS", "Frames", "Steps", "Mismatches", "Frame-dt off");
+
+    for (int r = 0; r < (int)(sizeof(frameRates) / sizeof(frameRates[0])); r++)
+    {
+        Player fixed, variable;
+        fixed.EyePos = variable.EyePos = Vector3f(4.0f, fixed.EyeHeight, 4.0f);
+
+        Array<Vector3f> positions;
+        int             outOfBudget;
+        int frames = ReplayFixedSteps(walls, ground, trace, &fixed, frameRates[r], &positions, &outOfBudget, &variable);
+        if (r == 0)
+            reference = positions;
+
+        int mismatches = CountMismatches(positions, reference);
+        failures += mismatches ? 1 : 0;
+
+        char rate[16];
+        FormatFrameRate(frameRates[r], rate, sizeof(rate));
+        LogText("%8s %8d %10d %12d %13.3fm%s\n", rate, frames, (int)positions.GetSize(), mismatches,
+                (variable.EyePos - reference.Back()).Length(), mismatches ? "  ERROR" : "");
+    }
+
+    // Starts where the capsule benchmark plays this tape, among the crates.
+    Array<ReplayFrame> tape, denseTrace;
+    MakeReplayTape(1003, 3000, &tape);
+    MakeStepInputFromTape(tape, &denseTrace);
+
+    LogText("Dense tape: %d steps, budget of %d planes a step\n", (int)denseTrace.GetSize(), denseBudget);
+    LogText("%8s %8s %10s %12s %14s\n", "FPS", "Frames", "Steps", "Mismatches", "Out of budget");
+
+    for (int r = 0; r < (int)(sizeof(denseRates) / sizeof(denseRates[0])); r++)
+    {
+        Player fixed;
+        fixed.EyePos            = Vector3f(7.0f, fixed.EyeHeight, 4.0f);
+        fixed.PlaneTestsPerStep = denseBudget;
+
+        Array<Vector3f> positions;
+        int             outOfBudget;
+        int frames = ReplayFixedSteps(walls, ground, denseTrace, &fixed, denseRates[r], &positions, &outOfBudget);
+        if (r == 0)
+            reference = positions;
+
+        // The budget has to bind, or this doesn't test anything.
+        int  mismatches = CountMismatches(positions, reference);
+        bool failed     = mismatches || !outOfBudget;
+        failures += failed ? 1 : 0;
+
+        char rate[16];
+        FormatFrameRate(denseRates[r], rate, sizeof(rate));
+        LogText("%8s %8d %10d %12d %14d%s\n", rate, frames, (int)positions.GetSize(), mismatches,
+                outOfBudget, failed ? "  ERROR" : "");
+    }
+
+    LogText("%s\n", failures ? "ERROR: trajectories depend on frame rate" : "All frame rates matched");
+
+    return failures == 0;
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** Hull optimization
+
+// Yawed and sloped boxes and prisms, each with a few of its planes repeated the
+// way scene exporters write them: exact copies, and copies with a scaled normal.
+static void MakeExportedHulls(int hullCount, float size, Array<Ptr<CollisionModel> >* hulls)
+{
+    unsigned seed = 321;
+    for (int i = 0; i < hullCount; i++)
+    {
+        float r[6];
+        for (int j = 0; j < 6; j++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            r[j] = ((seed >> 8) & 0xFFFF) / 65535.0f;
+        }
+
+        Vector3f            center(r[0] * size, 1.0f, r[1] * size);
+        Ptr<CollisionModel> shape = (i % 4 == 3) ?
+            MakePrismHull(center, 0.3f + r[3], 1.0f, 6 + (i % 3) * 2) :
+            MakeCollisionHull(center, Vector3f(0.2f + r[3], 0.5f + r[4], 0.2f + r[5]), r[2] * 3.0f, (i % 2) == 0);
+
+        Ptr<CollisionModel> hull = *new CollisionModel();
+        for (UPInt p = 0; p < shape->Planes.GetSize(); p++)
+        {
+            const Planef& plane = shape->Planes[p];
+            hull->Add(plane);
+            if ((p + i) % 3 == 0)
+                hull->Add(plane);
+            if ((p + i) % 4 == 1)
+                hull->Add(Planef(plane.N * 2.0f, plane.D * 2.0f));
+        }
+        hulls->PushBack(hull);
+    }
+}
+
+// Runs point and short ray queries against every hull, as the collision code did
+// before there was a tree, and through a tree. The optimized hulls must give the
+// same answers as the ones they were made from.
+static bool BenchmarkHullOptimization()
+{
+    static const int   hullCount  = 2000;
+    static const int   queryCount = 2000;
+    static const float size       = 90.0f;
+
+    Array<Ptr<CollisionModel> > raw, optimized;
+    MakeExportedHulls(hullCount, size, &raw);
+    UPInt rawPlanes = 0, optimizedPlanes = 0;
+    for (UPInt i = 0; i < raw.GetSize(); i++)
+    {
+        Ptr<CollisionModel> hull = *new CollisionModel();
+        for (UPInt p = 0; p < raw[i]->Planes.GetSize(); p++)
+            hull->Add(raw[i]->Planes[p]);
+        hull->Optimize();
+        optimized.PushBack(hull);
+        rawPlanes       += raw[i]->Planes.GetSize();
+        optimizedPlanes += hull->Planes.GetSize();
+    }
+
+    Array<Vector3f> points, dirs;
+    unsigned seed = 17;
+    for (int i = 0; i < queryCount; i++)
+    {
+        float r[4];
+        for (int j = 0; j < 4; j++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            r[j] = ((seed >> 8) & 0xFFFF) / 65535.0f;
+        }
+        points.PushBack(Vector3f(r[0] * size, r[1] * 2.5f, r[2] * size));
+        dirs.PushBack(Vector3f(cosf(r[3] * 6.2832f), 0, sinf(r[3] * 6.2832f)));
+    }
+
+    LogText("%d hulls: %d planes as loaded, %d after Optimize\n", hullCount, (int)rawPlanes, (int)optimizedPlanes);
+
+    // Per-query answers: points inside, and the shortest ray length.
+    Array<int>   results[2];
+    Array<float> lengths[2];
+    double       loopSeconds[2], treeSeconds[2];
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        const Array<Ptr<CollisionModel> >& hulls = pass ? optimized : raw;
+
+        double t0 = GetBenchmarkTime();
+        for (int q = 0; q < queryCount; q++)
+        {
+            int   inside = 0;
+            float length = 0.5f;
+            for (UPInt i = 0; i < hulls.GetSize(); i++)
+            {
+                if (hulls[i]->TestPoint(points[q]))
+                    inside++;
+                float len = 0.5f;
+                if (hulls[i]->TestRay(points[q], dirs[q], len))
+                    length = Alg::Min(length, len);
+            }
+            results[pass].PushBack(inside);
+            lengths[pass].PushBack(length);
+        }
+        loopSeconds[pass] = GetBenchmarkTime() - t0;
+
+        CollisionTree tree;
+        tree.Build(hulls);
+        int treeHits = 0;
+        t0 = GetBenchmarkTime();
+        for (int repeat = 0; repeat < 20; repeat++)
+        {
+            for (int q = 0; q < queryCount; q++)
+            {
+                float len = 0.5f;
+                treeHits += tree.TestPoint(points[q]) ? 1 : 0;
+                treeHits += tree.TestRayNearest(points[q], dirs[q], len) ? 1 : 0;
+            }
+        }
+        treeSeconds[pass] = (GetBenchmarkTime() - t0) / 20;
+        OVR_UNUSED(treeHits);
+    }
+
+    int mismatches = 0;
+    for (int q = 0; q < queryCount; q++)
+    {
+        if (results[0][q] != results[1][q] || fabsf(lengths[0][q] - lengths[1][q]) > 1e-4f)
+            mismatches++;
+    }
+
+    LogText("%-22s %12s %12s %9s\n", "", "As loaded", "Optimized", "Speedup");
+    LogText("%-22s %10.2f ms %10.2f ms %8.2fx\n", "Loop over all hulls",
+            loopSeconds[0] * 1000.0, loopSeconds[1] * 1000.0, loopSeconds[0] / loopSeconds[1]);
+    LogText("%-22s %10.2f ms %10.2f ms %8.2fx\n", "Collision tree",
+            treeSeconds[0] * 1000.0, treeSeconds[1] * 1000.0, treeSeconds[0] / treeSeconds[1]);
+    LogText("%d of %d queries differ%s\n", mismatches, queryCount, mismatches ? "  ERROR" : "");
+
+    return mismatches == 0;
+}
+
+//-------------------------------------------------------------------------------------
+// ***** Collision walk
+
+// The walk of "-collisionwalk" through the synthetic rooms.
+static bool BenchmarkCollisionWalk()
+{
+    Array<Ptr<CollisionModel> > wallModels, groundModels;
+    MakeRoomScene(4, &wallModels);
+    MakeGroundScene(8, &groundModels);
+
+    CollisionTree walls;
+    walls.Build(wallModels);
+    GroundGrid ground;
+    ground.Build(groundModels);
+
+    LogText("%d walls, %d ground models\n", (int)wallModels.GetSize(), (int)groundModels.GetSize());
+    ReplayCollisionWalk(walls, ground, Vector3f(4.0f, 1.8f, 4.0f), PhysicsStepsPerSecond * 60);
+
+    return true;
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** Null render device
+
+static const int   BoxGridSize    = 60;
+static const int   BoxGridFills   = 8;
+static const float BoxGridSpacing = 2.0f;
+
+// A grid of boxes, each with one of a few texture fills, in no particular order.
+static void MakeBoxGridScene(RenderDevice* ren, Scene* scene)
+{
+    Array<UByte> texels(64 * 64 * 4);
+    Array<Ptr<Fill> > fills;
+    for (int i = 0; i < BoxGridFills; i++)
+    {
+        memset(&texels[0], 32 * i, texels.GetSize());
+        Ptr<Texture> tex  = *ren->CreateTexture(Texture_RGBA | Texture_GenMipmaps, 64, 64, &texels[0]);
+        Ptr<Fill>    fill = *ren->CreateTextureFill(tex);
+        fills.PushBack(fill);
+    }
+
+    scene->SetAmbient(Vector4f(0.65f, 0.65f, 0.65f, 1));
+    scene->AddLight(Vector3f(0, 8.0f, 0), Vector4f(1, 1, 1, 1));
+    for (int z = 0; z < BoxGridSize; z++)
+    {
+        for (int x = 0; x < BoxGridSize; x++)
+        {
+            Ptr<Model> box = *Model::CreateBox(Color(200, 200, 200),
+                                               Vector3f(x * BoxGridSpacing, 0.5f, z * BoxGridSpacing),
+                                               Vector3f(1.0f, 1.0f + (x + z) % 3, 1.0f));
+            box->Fill = fills[(x * 7 + z * 3) % BoxGridFills];
+            box->ComputeBounds();
+            scene->World.Add(box);
+        }
+    }
+}
+
+// Renders a grid of textured boxes in stereo with distortion, the way the demo
+// draws a frame, through the null device: the time is scene traversal, culling
+// and command submission with no GPU or driver involved.
+static bool BenchmarkNullRender()
+{
+    static const int   gridSize   = BoxGridSize;
+    static const int   fillCount  = BoxGridFills;
+    static const int   frameCount = 600;
+    static const float spacing    = BoxGridSpacing;
+
+    Ptr<Null::RenderDevice> ren = *new Null::RenderDevice(RendererParams());
+    ren->SetWindowSize(1280, 800);
+
+    Scene scene;
+    MakeBoxGridScene(ren, &scene);
+
+    Matrix4f proj = Matrix4f::PerspectiveRH(DegreeToRad(100.0f), 640.0f / 800.0f, 0.01f, 1000.0f);
+    float    size = gridSize * spacing;
+
+    Array<double>    frameTimes;
+    Null::FrameStats total;
+    UPInt            firstUploadBytes = 0, commands = 0;
+    int              culled = 0;
+
+    for (int frame = 0; frame < frameCount; frame++)
+    {
+        // Circle the middle of the grid, looking along the path.
+        float    angle   = frame * 6.2832f / frameCount;
+        Vector3f eye     = Vector3f(size * 0.5f + cosf(angle) * size * 0.3f, 1.7f,
+                                    size * 0.5f + sinf(angle) * size * 0.3f);
+        Vector3f forward = Vector3f(-sinf(angle), 0, cosf(angle));
+        Vector3f right   = forward.Cross(Vector3f(0, 1, 0));
+
+        ren->ResetDrawStats();
+        double t0 = GetBenchmarkTime();
+
+        ren->BeginScene(PostProcess_Distortion);
+        for (int i = 0; i < 2; i++)
+        {
+            Vector3f eyePos = eye + right * (i ? 0.032f : -0.032f);
+            ren->SetViewport(Viewport(i * 640, 0, 640, 800));
+            ren->SetProjection(proj);
+            ren->SetDepthMode(true, true);
+            ren->Clear();
+            scene.Render(ren, Matrix4f::LookAtRH(eyePos, eyePos + forward, Vector3f(0, 1, 0)));
+        }
+        ren->FinishScene();
+        ren->Present();
+
+        frameTimes.PushBack(GetBenchmarkTime() - t0);
+
+        const Null::FrameStats& stats = ren->GetFrameStats();
+        if (frame == 0)
+        {
+            firstUploadBytes = stats.UploadBytes;
+            continue;
+        }
+        total.Draws        += stats.Draws;
+        total.Indices      += stats.Indices;
+        total.StateChanges += stats.StateChanges;
+        total.UniformBytes += stats.UniformBytes;
+        total.UploadBytes  += stats.UploadBytes;
+        commands           += ren->GetCommandLog().GetSize();
+        culled             += ren->GetDrawsCulled();
+    }
+
+    // The first frame builds every vertex and index buffer; the rest are steady.
+    double firstFrame = frameTimes[0];
+    frameTimes.RemoveAt(0);
+    SortBenchmarkTimes(&frameTimes);
+
+    int    frames = (int)frameTimes.GetSize();
+    double mean   = 0;
+    for (int i = 0; i < frames; i++)
+        mean += frameTimes[i];
+    mean /= frames;
+
+    LogText("%d boxes, %d fills, %d frames, %d KB of textures\n", gridSize * gridSize, fillCount,
+            frameCount, (int)(ren->GetTotalTextureMemoryUsage() / 1024));
+    LogText("First frame %.2f ms, %d KB of buffer uploads\n", firstFrame * 1000.0, (int)(firstUploadBytes / 1024));
+    LogText("Per frame: mean %.3f ms, p50 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+            mean * 1000.0, frameTimes[frames / 2] * 1000.0, frameTimes[frames * 99 / 100] * 1000.0,
+            frameTimes[frames - 1] * 1000.0);
+    LogText("Per frame: %d draws, %d culled, %d indices, %d state changes, %d commands\n",
+            total.Draws / frames, culled / frames, (int)(total.Indices / frames),
+            total.StateChanges / frames, (int)(commands / frames));
+    LogText("Per frame: %d KB of uniforms, %d bytes of uploads\n",
+            (int)(total.UniformBytes / frames / 1024), (int)(total.UploadBytes / frames));
+
+    return true;
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** Render queue
+
+// Draws the box grid from the middle, looking around, in file order and then
+// sorted by the render queue, and compares the binds the null device sees.
+static bool BenchmarkRenderQueue()
+{
+    static const int frameCount = 360;
+
+    Ptr<Null::RenderDevice> ren = *new Null::RenderDevice(RendererParams());
+    ren->SetWindowSize(1280, 800);
+    ren->SetKeepCommandLog(false);
+
+    Scene scene;
+    MakeBoxGridScene(ren, &scene);
+
+    Matrix4f proj   = Matrix4f::PerspectiveRH(DegreeToRad(100.0f), 640.0f / 800.0f, 0.01f, 1000.0f);
+    float    center = BoxGridSize * BoxGridSpacing * 0.5f;
+
+    for (int sorted = 0; sorted < 2; sorted++)
+    {
+        scene.SortDraws = sorted != 0;
+
+        Array<double> frameTimes;
+        int           stateChanges = 0, saved = 0, draws = 0;
+        for (int frame = 0; frame < frameCount; frame++)
+        {
+            float    angle   = frame * 6.2832f / frameCount;
+            Vector3f eye     = Vector3f(center, 1.7f, center);
+            Vector3f forward = Vector3f(-sinf(angle), 0, cosf(angle));
+
+            ren->ResetDrawStats();
+            double t0 = GetBenchmarkTime();
+
+            for (int i = 0; i < 2; i++)
+            {
+                ren->SetViewport(Viewport(i * 640, 0, 640, 800));
+                ren->BeginScene(PostProcess_Distortion);
+                ren->SetProjection(proj);
+                ren->SetDepthMode(true, true);
+                ren->Clear();
+                scene.Render(ren, Matrix4f::LookAtRH(eye, eye + forward, Vector3f(0, 1, 0)));
+                ren->FinishScene();
+            }
+            ren->Present();
+
+            frameTimes.PushBack(GetBenchmarkTime() - t0);
+            if (frame > 0)
+            {
+                stateChanges += ren->GetFrameStats().StateChanges;
+                saved        += ren->GetStateChangesSaved();
+                draws        += ren->GetDrawsSubmitted();
+            }
+        }
+        frameTimes.RemoveAt(0);
+        SortBenchmarkTimes(&frameTimes);
+
+        int frames = (int)frameTimes.GetSize();
+        LogText("%-10s %d draws, %d state changes, %d binds saved by sorting, p50 %.3f ms per frame\n",
+                sorted ? "Sorted:" : "File order:", draws / frames, stateChanges / frames, saved / frames,
+                frameTimes[frames / 2] * 1000.0);
+    }
+
+    return true;
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** Single pass stereo
+
+// Draws the box grid for both eyes through the null device, first traversing the
+// scene once per eye and then once per frame, and compares the CPU frame times.
+static bool BenchmarkStereoSubmission()
+{
+    static const int frameCount = 360;
+
+    Ptr<Null::RenderDevice> ren = *new Null::RenderDevice(RendererParams());
+    ren->SetWindowSize(1280, 800);
+    ren->SetKeepCommandLog(false);
+
+    Scene scene;
+    MakeBoxGridScene(ren, &scene);
+
+    // Eye parameters like StereoConfig gives for the DK1.
+    StereoEyeParams eyes[2];
+    for (int i = 0; i < 2; i++)
+    {
+        float side = i ? 1.0f : -1.0f;
+        eyes[i].Eye        = i ? StereoEye_Right : StereoEye_Left;
+        eyes[i].VP         = Viewport(i * 640, 0, 640, 800);
+        eyes[i].ViewAdjust = Matrix4f::Translation(-side * 0.032f, 0, 0);
+        eyes[i].Projection = Matrix4f::Translation(-side * 0.15f, 0, 0) *
+                             Matrix4f::PerspectiveRH(DegreeToRad(110.0f), 640.0f / 800.0f, 0.01f, 1000.0f);
+    }
+
+    float  center = BoxGridSize * BoxGridSpacing * 0.5f;
+    double p50[2];
+
+    for (int singlePass = 0; singlePass < 2; singlePass++)
+    {
+        Array<double> frameTimes;
+        int           draws = 0, culled = 0;
+        for (int frame = 0; frame < frameCount; frame++)
+        {
+            float    angle   = frame * 6.2832f / frameCount;
+            Vector3f eye     = Vector3f(center, 1.7f, center);
+            Matrix4f view    = Matrix4f::LookAtRH(eye, eye + Vector3f(-sinf(angle), 0, cosf(angle)), Vector3f(0, 1, 0));
+
+            ren->ResetDrawStats();
+            double t0 = GetBenchmarkTime();
+
+            if (singlePass)
+            {
+                scene.CollectStereo(ren, view, eyes[0], eyes[1]);
+            }
+            for (int i = 0; i < 2; i++)
+            {
+                ren->BeginScene(PostProcess_Distortion);
+                ren->ApplyStereoParams(eyes[i]);
+                ren->SetDepthMode(true, true);
+                ren->Clear();
+                if (singlePass)
+                {
+                    scene.RenderEye(ren, eyes[i]);
+                }
+                else
+                {
+                    scene.Render(ren, eyes[i].ViewAdjust * view);
+                }
+                ren->FinishScene();
+            }
+            ren->Present();
+
+            frameTimes.PushBack(GetBenchmarkTime() - t0);
+            if (frame > 0)
+            {
+                draws  += ren->GetDrawsSubmitted();
+                culled += ren->GetDrawsCulled();
+            }
+        }
+        frameTimes.RemoveAt(0);
+        SortBenchmarkTimes(&frameTimes);
+
+        int frames = (int)frameTimes.GetSize();
+        p50[singlePass] = frameTimes[frames / 2];
+        LogText("%-12s %d draws, %d culled, p50 %.3f ms, p99 %.3f ms per frame\n",
+                singlePass ? "Single pass:" : "Multipass:", draws / frames, culled / frames,
+                frameTimes[frames / 2] * 1000.0, frameTimes[frames * 99 / 100] * 1000.0);
+    }
+
+    LogText("Single pass saves %.3f ms per frame (%.0f%%)\n",
+            (p50[0] - p50[1]) * 1000.0, p50[0] > 0 ? (p50[0] - p50[1]) * 100.0 / p50[0] : 0.0);
+
+    return true;
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** Transform cache
+
+// The world matrices Container::Collect computed before they were cached: a
+// matrix multiply for every node on every traversal.
+static void ComputeWorldUncached(Node* node, const Matrix4f& parent, Array<Matrix4f>* worlds)
+{
+    Matrix4f m = parent * node->GetMatrix();
+    if (node->GetType() == Node::Node_Model)
+    {
+        worlds->PushBack(m);
+    }
+    else if (node->GetType() == Node::Node_Container)
+    {
+        Container* container = (Container*)node;
+        for (UPInt i = 0; i < container->Nodes.GetSize(); i++)
+        {
+            ComputeWorldUncached(container->Nodes[i], m, worlds);
+        }
+    }
+}
+
+// 10000 models in a four level tree of containers: times bringing the world
+// matrices up to date, and the whole Collect into a render queue without culling,
+// with nothing moving, with 1% of the models moving and with one container of
+// 1000 models turning each frame, against computing every matrix each time.
+static bool BenchmarkTransformCache()
+{
+    static const int fanOut     = 10;
+    static const int frameCount = 300;
+
+    Container world;
+    Array<Ptr<Container> > groups;
+    Array<Ptr<Model> >     models;
+    for (int a = 0; a < fanOut; a++)
+    {
+        Ptr<Container> area = *new Container;
+        area->SetPosition(Vector3f(a * 200.0f, 0, 0));
+        world.Add(area);
+        groups.PushBack(area);
+        for (int b = 0; b < fanOut; b++)
+        {
+            Ptr<Container> block = *new Container;
+            block->SetPosition(Vector3f(0, 0, b * 20.0f));
+            block->SetOrientation(Quatf(Vector3f(0, 1, 0), b * 0.1f));
+            area->Add(block);
+            for (int c = 0; c < fanOut; c++)
+            {
+                Ptr<Container> group = *new Container;
+                group->SetPosition(Vector3f(c * 2.0f, 0, 0));
+                block->Add(group);
+                for (int i = 0; i < fanOut; i++)
+                {
+                    Ptr<Model> model = *new Model;
+                    model->SetPosition(Vector3f(0, i * 0.2f, 0));
+                    group->Add(model);
+                    models.PushBack(model);
+                }
+            }
+        }
+    }
+
+    Matrix4f        view = Matrix4f::LookAtRH(Vector3f(0, 10, -20), Vector3f(100, 0, 100), Vector3f(0, 1, 0));
+    RenderQueue     queue;
+    Array<Matrix4f> worlds;
+
+    static const char* caseNames[] = { "Uncached:", "Static:", "1% moving:", "1000 turning:" };
+    for (int c = 0; c < 4; c++)
+    {
+        Array<double> updateTimes, collectTimes;
+        for (int frame = 0; frame < frameCount; frame++)
+        {
+            if (c == 2)
+            {
+                for (UPInt i = frame % 100; i < models.GetSize(); i += 100)
+                {
+                    models[i]->Move(Vector3f(0, (frame & 1) ? 0.01f : -0.01f, 0));
+                }
+            }
+            else if (c == 3)
+            {
+                groups[frame % fanOut]->Rotate(Quatf(Vector3f(0, 1, 0), 0.01f));
+            }
+
+            double t0 = GetBenchmarkTime();
+            if (c == 0)
+            {
+                worlds.Clear();
+                ComputeWorldUncached(&world, Matrix4f(), &worlds);
+            }
+            else
+            {
+                world.UpdateWorldMatrices();
+            }
+            double t1 = GetBenchmarkTime();
+
+            queue.Clear();
+            if (c == 0)
+            {
+                for (UPInt i = 0; i < worlds.GetSize(); i++)
+                {
+                    queue.Add(models[i], view * worlds[i]);
+                }
+            }
+            else
+            {
+                world.Collect(view, NULL, &queue);
+            }
+            double t2 = GetBenchmarkTime();
+
+            updateTimes.PushBack(t1 - t0);
+            collectTimes.PushBack(t2 - t0);
+        }
+        OVR_ASSERT(queue.GetSize() == models.GetSize());
+
+        // The first frame builds the flat array.
+        updateTimes.RemoveAt(0);
+        collectTimes.RemoveAt(0);
+        SortBenchmarkTimes(&updateTimes);
+        SortBenchmarkTimes(&collectTimes);
+
+        int frames = (int)updateTimes.GetSize();
+        LogText("%-14s %d models, world matrices p50 %.3f ms, collect p50 %.3f ms, p99 %.3f ms\n",
+                caseNames[c], (int)queue.GetSize(), updateTimes[frames / 2] * 1000.0,
+                collectTimes[frames / 2] * 1000.0, collectTimes[frames * 99 / 100] * 1000.0);
+    }
+
+    return true;
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** Render list
+
+// Counts the cache misses of the calling thread with the CPU's performance
+// counters. Only on Linux, where perf_event_open may also be refused; then
+// IsAvailable is false.
+class CacheMissCounter
+{
+public:
+    CacheMissCounter() : Fd(-1)
+    {
+#if defined(OVR_OS_LINUX)
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.type           = PERF_TYPE_HARDWARE;
+        attr.size           = sizeof(attr);
+        attr.config         = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled       = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        Fd = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+    }
+    ~CacheMissCounter()
+    {
+#if defined(OVR_OS_LINUX)
+        if (Fd >= 0)
+            close(Fd);
+#endif
+    }
+
+    bool IsAvailable() const { return Fd >= 0; }
+
+    void Start()
+    {
+#if defined(OVR_OS_LINUX)
+        if (Fd >= 0)
+        {
+            ioctl(Fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(Fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    // Returns the misses since Start.
+    UInt64 Stop()
+    {
+        UInt64 count = 0;
+#if defined(OVR_OS_LINUX)
+        if (Fd >= 0)
+        {
+            ioctl(Fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(Fd, &count, sizeof(count)) != sizeof(count))
+                count = 0;
+        }
+#endif
+        return count;
+    }
+
+private:
+    int Fd;
+};
+
+// How scenes were drawn before containers kept render lists: a virtual
+// Node::Render for every node, each model read through its node pointer.
+static void RenderNodeWalk(Node* node, const Matrix4f& ltw, RenderDevice* ren)
+{
+    if (node->GetType() == Node::Node_Container)
+    {
+        Container* container = (Container*)node;
+        Matrix4f   m         = ltw * container->GetMatrix();
+        for (UPInt i = 0; i < container->Nodes.GetSize(); i++)
+        {
+            RenderNodeWalk(container->Nodes[i], m, ren);
+        }
+    }
+    else
+    {
+        node->Render(ltw, ren);
+    }
+}
+
+// Draws the box grid for both eyes through the null device, walking the nodes
+// and then the render list, and reports time and cache misses per frame.
+static bool BenchmarkRenderList()
+{
+    static const int frameCount = 200;
+
+    Ptr<Null::RenderDevice> ren = *new Null::RenderDevice(RendererParams());
+    ren->SetWindowSize(1280, 800);
+    ren->SetKeepCommandLog(false);
+
+    Scene scene;
+    MakeBoxGridScene(ren, &scene);
+
+    // Touch memory between frames, so each one starts with a cold cache the way it
+    // would after the rest of a frame's work.
+    Array<UByte> flush(8 * 1024 * 1024);
+
+    CacheMissCounter counter;
+    if (!counter.IsAvailable())
+    {
+        LogText("Cache miss counts are not available on this system\n");
+    }
+
+    Matrix4f proj   = Matrix4f::PerspectiveRH(DegreeToRad(100.0f), 640.0f / 800.0f, 0.01f, 1000.0f);
+    float    center = BoxGridSize * BoxGridSpacing * 0.5f;
+
+    for (int useList = 0; useList < 2; useList++)
+    {
+        Array<double> frameTimes;
+        UInt64        misses = 0;
+        int           draws  = 0;
+        for (int frame = 0; frame < frameCount; frame++)
+        {
+            float    angle = frame * 6.2832f / frameCount;
+            Vector3f eye   = Vector3f(center, 1.7f, center);
+            Matrix4f view  = Matrix4f::LookAtRH(eye, eye + Vector3f(-sinf(angle), 0, cosf(angle)), Vector3f(0, 1, 0));
+
+            memset(&flush[0], frame, flush.GetSize());
+            ren->ResetDrawStats();
+            counter.Start();
+            double t0 = GetBenchmarkTime();
+
+            for (int i = 0; i < 2; i++)
+            {
+                ren->SetViewport(Viewport(i * 640, 0, 640, 800));
+                ren->SetProjection(proj);
+                if (useList)
+                {
+                    scene.World.Render(view, ren);
+                }
+                else
+                {
+                    RenderNodeWalk(&scene.World, view, ren);
+                }
+            }
+            ren->Present();
+
+            frameTimes.PushBack(GetBenchmarkTime() - t0);
+            if (frame > 0)
+            {
+                misses += counter.Stop();
+                draws  += ren->GetDrawsSubmitted();
+            }
+        }
+        frameTimes.RemoveAt(0);
+        SortBenchmarkTimes(&frameTimes);
+
+        int  frames = (int)frameTimes.GetSize();
+        char missText[48] = "";
+        if (counter.IsAvailable())
+        {
+            OVR_sprintf(missText, sizeof(missText), ", %u cache misses", (unsigned)(misses / frames));
+        }
+        LogText("%-12s %d draws, p50 %.3f ms, p99 %.3f ms%s per frame\n",
+                useList ? "Render list:" : "Node walk:", draws / frames,
+                frameTimes[frames / 2] * 1000.0, frameTimes[frames * 99 / 100] * 1000.0, missText);
+    }
+
+    return true;
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** Software rasterizer
+
+// A scene for the software device that uses every builtin shader the demo draws
+// the world with, on a fixed camera path.
+struct SoftScene
+{
+    Scene World;
+    int   FrameCount;
+};
+
+static Ptr<Texture> MakeCheckerTexture(RenderDevice* ren, int size, Color a, Color b)
+{
+    Array<UByte> texels(size * size * 4);
+    for (int y = 0; y < size; y++)
+    {
+        for (int x = 0; x < size; x++)
+        {
+            Color  c = ((x / 8 + y / 8) & 1) ? a : b;
+            UByte* t = &texels[(y * size + x) * 4];
+            t[0] = c.R; t[1] = c.G; t[2] = c.B; t[3] = c.A;
+        }
+    }
+    Ptr<Texture> tex = *ren->CreateTexture(Texture_RGBA | Texture_GenMipmaps, size, size, &texels[0]);
+    return tex;
+}
+
+static Ptr<Fill> MakeBuiltinFill(RenderDevice* ren, int pixelShader, Texture* tex0, Texture* tex1)
+{
+    ShaderSet* shaders = ren->CreateShaderSet();
+    shaders->SetShader(ren->LoadBuiltinShader(Shader_Vertex, VShader_MVP));
+    shaders->SetShader(ren->LoadBuiltinShader(Shader_Fragment, pixelShader));
+
+    Ptr<ShaderFill> fill = *new ShaderFill(*shaders);
+    if (tex0)
+        fill->SetTexture(0, tex0);
+    if (tex1)
+        fill->SetTexture(1, tex1);
+    return fill;
+}
+
+static void MakeSoftScene(RenderDevice* ren, SoftScene* scene)
+{
+    static const int   gridSize = 12;
+    static const float spacing  = 2.0f;
+
+    Ptr<Texture> checker   = MakeCheckerTexture(ren, 64, Color(220, 220, 220), Color(90, 60, 40));
+    Ptr<Texture> lightmap  = MakeCheckerTexture(ren, 32, Color(160, 160, 160), Color(100, 100, 120));
+    Ptr<Texture> cutout    = MakeCheckerTexture(ren, 64, Color(40, 200, 40), Color(0, 0, 0, 0));
+
+    Ptr<Fill> fills[] =
+    {
+        MakeBuiltinFill(ren, FShader_Gouraud,      NULL,     NULL),
+        MakeBuiltinFill(ren, FShader_Texture,      checker,  NULL),
+        MakeBuiltinFill(ren, FShader_LitGouraud,   NULL,     NULL),
+        MakeBuiltinFill(ren, FShader_LitTexture,   checker,  NULL),
+        MakeBuiltinFill(ren, FShader_MultiTexture, checker,  lightmap),
+        MakeBuiltinFill(ren, FShader_Texture,      cutout,   NULL)
+    };
+    const int fillCount = sizeof(fills) / sizeof(fills[0]);
+
+    Ptr<Fill> floorFill = MakeBuiltinFill(ren, FShader_Solid, NULL, NULL);
+    ((ShaderFill*)floorFill.GetPtr())->GetShaders()->SetUniform4f("Color", 0.3f, 0.35f, 0.3f, 1.0f);
+
+    scene->World.SetAmbient(Vector4f(0.35f, 0.35f, 0.35f, 1));
+    scene->World.AddLight(Vector3f(gridSize, 6.0f, gridSize), Vector4f(8, 8, 7, 1));
+    scene->World.AddLight(Vector3f(0, 3.0f, 0), Vector4f(3, 2, 2, 1));
+
+    Ptr<Model> floor = *Model::CreateBox(Color(255, 255, 255), Vector3f(gridSize, -0.5f, gridSize),
+                                         Vector3f(gridSize * spacing, 1.0f, gridSize * spacing));
+    floor->Fill = floorFill;
+    scene->World.World.Add(floor);
+
+    for (int z = 0; z < gridSize; z++)
+    {
+        for (int x = 0; x < gridSize; x++)
+        {
+            Ptr<Model> box = *Model::CreateBox(Color(60 + x * 15, 200, 60 + z * 15),
+                                               Vector3f(x * spacing + 1.0f, 0.5f, z * spacing + 1.0f),
+                                               Vector3f(1.0f, 1.0f + (x + z) % 3, 1.0f));
+            box->Fill = fills[(x * 7 + z * 3) % fillCount];
+            box->ComputeBounds();
+            scene->World.World.Add(box);
+        }
+    }
+    scene->FrameCount = 48;
+}
+
+// Renders frame i of the camera path in stereo with distortion, and a blended
+// rectangle over each eye.
+static void RenderSoftFrame(RenderDevice* ren, SoftScene* scene, int w, int h, int frame)
+{
+    float size = 24.0f;
+
+    float    angle   = frame * 6.2832f / scene->FrameCount;
+    Vector3f eye     = Vector3f(size * 0.5f + cosf(angle) * size * 0.3f, 1.7f,
+                                size * 0.5f + sinf(angle) * size * 0.3f);
+    Vector3f forward = Vector3f(-sinf(angle), -0.1f, cosf(angle));
+    Vector3f right   = forward.Cross(Vector3f(0, 1, 0)).Normalized();
+
+    Matrix4f proj = Matrix4f::PerspectiveRH(DegreeToRad(100.0f), (w * 0.5f) / h, 0.01f, 1000.0f);
+    Matrix4f flipY(1,  0, 0, 0,
+                   0, -1, 0, 0,
+                   0,  0, 0, 0,
+                   0,  0, 0, 1);
+
+    // Like the demo, each eye is drawn and distorted on its own.
+    for (int i = 0; i < 2; i++)
+    {
+        Vector3f eyePos = eye + right * (i ? 0.032f : -0.032f);
+        ren->SetViewport(Viewport(i * w / 2, 0, w / 2, h));
+        ren->BeginScene(PostProcess_Distortion);
+        ren->SetProjection(proj);
+        ren->SetDepthMode(true, true);
+        ren->Clear(0.1f, 0.1f, 0.2f, 1.0f);
+        scene->World.Render(ren, Matrix4f::LookAtRH(eyePos, eyePos + forward, Vector3f(0, 1, 0)));
+
+        ren->SetProjection(flipY);
+        ren->SetDepthMode(false, false);
+        ren->FillRect(-0.5f, 0.6f, 0.5f, 0.8f, Color(40, 40, 100, 160));
+        ren->FinishScene();
+    }
+    ren->Present();
+}
+
+// FNV-1a, 64-bit.
+static UInt64 HashFrame(const Soft::Texture* frame)
+{
+    UInt64 hash = 14695981039346656037ULL;
+    for (UPInt i = 0; i < frame->Texels.GetSize(); i++)
+    {
+        hash = (hash ^ frame->Texels[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Renders the camera path at 640x400 with 1, 2, 4 and one thread per core,
+// checking that every thread count draws the same images.
+static bool BenchmarkSoftRender()
+{
+    static const int threadCounts[] = { 1, 2, 4, 0 };
+    bool passed = true;
+
+    Array<UInt64> referenceHashes;
+    double        referenceFps = 0;
+
+    for (int t = 0; t < (int)(sizeof(threadCounts) / sizeof(threadCounts[0])); t++)
+    {
+        Ptr<Soft::RenderDevice> ren = *new Soft::RenderDevice(RendererParams(), NULL, threadCounts[t]);
+        ren->SetWindowSize(640, 400);
+
+        SoftScene scene;
+        MakeSoftScene(ren, &scene);
+
+        // One untimed frame builds the vertex buffers.
+        RenderSoftFrame(ren, &scene, 640, 400, 0);
+
+        Array<UInt64> hashes;
+        Array<double> frameTimes;
+        for (int frame = 0; frame < scene.FrameCount; frame++)
+        {
+            double t0 = GetBenchmarkTime();
+            RenderSoftFrame(ren, &scene, 640, 400, frame);
+            frameTimes.PushBack(GetBenchmarkTime() - t0);
+            hashes.PushBack(HashFrame(ren->GetFrameBuffer()));
+        }
+        SortBenchmarkTimes(&frameTimes);
+
+        double total = 0;
+        for (UPInt i = 0; i < frameTimes.GetSize(); i++)
+            total += frameTimes[i];
+        double fps = frameTimes.GetSize() / total;
+
+        bool match = true;
+        if (t == 0)
+        {
+            referenceHashes = hashes;
+            referenceFps    = fps;
+        }
+        else
+        {
+            for (UPInt i = 0; i < hashes.GetSize(); i++)
+                match = match && hashes[i] == referenceHashes[i];
+        }
+
+        LogText("%2d threads: %6.1f fps, p50 %.2f ms, max %.2f ms, %.2fx, images %s\n",
+                ren->GetThreadCount(), fps, frameTimes[frameTimes.GetSize() / 2] * 1000.0,
+                frameTimes.Back() * 1000.0, fps / referenceFps, match ? "identical" : "DIFFER");
+        passed = passed && match;
+    }
+
+    return passed;
+}
+
+// Writes an uncompressed 32-bit TGA, rows top to bottom.
+static bool WriteSoftFrameTga(const char* path, const Soft::Texture* frame)
+{
+    SysFile f(path, File::Open_Write | File::Open_Create | File::Open_Truncate);
+    if (!f.IsValid())
+    {
+        return false;
+    }
+
+    UByte header[18];
+    memset(header, 0, sizeof(header));
+    header[2]  = 2;
+    header[12] = (UByte)(frame->Width & 0xff);
+    header[13] = (UByte)(frame->Width >> 8);
+    header[14] = (UByte)(frame->Height & 0xff);
+    header[15] = (UByte)(frame->Height >> 8);
+    header[16] = 32;
+    header[17] = 0x28;
+
+    Array<UByte> bgra(frame->Texels.GetSize());
+    for (UPInt i = 0; i < bgra.GetSize(); i += 4)
+    {
+        bgra[i]     = frame->Texels[i + 2];
+        bgra[i + 1] = frame->Texels[i + 1];
+        bgra[i + 2] = frame->Texels[i];
+        bgra[i + 3] = frame->Texels[i + 3];
+    }
+    return f.Write(header, sizeof(header)) == sizeof(header) &&
+           f.Write(&bgra[0], (int)bgra.GetSize()) == (int)bgra.GetSize();
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** Uniform handles
+
+// Sets the builtin uniform names on a shader set for every pair of builtin shaders
+// of the software device, once by name and once by handle, and compares the cost
+// of a SetUniform call.
+static bool BenchmarkUniformHandles()
+{
+    static const int   roundCount = 9;
+    static const int   passCount  = 2000;
+    static const char* names[] =
+    {
+        "Color", "Ambient", "LightCount", "LightPos", "LightColor", "Texm",
+        "LensCenter", "ScreenCenter", "Scale", "ScaleIn", "HmdWarpParam"
+    };
+    static const int   nameCount  = sizeof(names) / sizeof(names[0]);
+
+    Ptr<Soft::RenderDevice> ren = *new Soft::RenderDevice(RendererParams());
+
+    Array<Ptr<ShaderSet> > sets;
+    for (int v = 0; v < VShader_Count; v++)
+    {
+        for (int f = 0; f < FShader_Count; f++)
+        {
+            Ptr<ShaderSet> shaders = *ren->CreateShaderSet();
+            shaders->SetShader(ren->LoadBuiltinShader(Shader_Vertex, v));
+            shaders->SetShader(ren->LoadBuiltinShader(Shader_Fragment, f));
+            sets.PushBack(shaders);
+        }
+    }
+
+    UniformHandle handles[nameCount];
+    for (int i = 0; i < nameCount; i++)
+        handles[i] = UniformHandle(names[i]);
+
+    // No two builtin names, View and Proj included, may share a hash.
+    int hashCollisions = 0;
+    for (int i = 0; i < nameCount; i++)
+    {
+        for (int j = i + 1; j < nameCount; j++)
+            hashCollisions += handles[i] == handles[j];
+        hashCollisions += handles[i] == UniformHandle::Literal("View");
+        hashCollisions += handles[i] == UniformHandle::Literal("Proj");
+    }
+    hashCollisions += UniformHandle::Literal("View") == UniformHandle::Literal("Proj");
+
+    // The literal form must hash the same as the run-time one.
+    bool literalsMatch = UniformHandle::Literal("HmdWarpParam") == UniformHandle("HmdWarpParam") &&
+                         UniformHandle::Literal("LightPos") == handles[3] &&
+                         UniformHandle::Literal("") == UniformHandle("");
+
+    const float   value[16] = { 0 };
+    Array<double> nameTimes, handleTimes;
+    int           nameSets = 0, handleSets = 0;
+
+    for (int round = 0; round < roundCount; round++)
+    {
+        double t0 = GetBenchmarkTime();
+        for (int pass = 0; pass < passCount; pass++)
+            for (UPInt s = 0; s < sets.GetSize(); s++)
+                for (int i = 0; i < nameCount; i++)
+                    nameSets += sets[s]->SetUniform(names[i], 4, value);
+
+        double t1 = GetBenchmarkTime();
+        for (int pass = 0; pass < passCount; pass++)
+            for (UPInt s = 0; s < sets.GetSize(); s++)
+                for (int i = 0; i < nameCount; i++)
+                    handleSets += sets[s]->SetUniform(handles[i], 4, value);
+
+        nameTimes.PushBack(t1 - t0);
+        handleTimes.PushBack(GetBenchmarkTime() - t1);
+    }
+
+    SortBenchmarkTimes(&nameTimes);
+    SortBenchmarkTimes(&handleTimes);
+
+    double calls    = double(passCount) * sets.GetSize() * nameCount;
+    double byName   = nameTimes[roundCount / 2] / calls * 1e9;
+    double byHandle = handleTimes[roundCount / 2] / calls * 1e9;
+
+    LogText("%d shader sets, %d uniforms, %d calls per round\n",
+            (int)sets.GetSize(), nameCount, (int)calls);
+    LogText("By name:   p50 %.1f ns per call\n", byName);
+    LogText("By handle: p50 %.1f ns per call (%.2fx)\n", byHandle, byName / byHandle);
+    LogText("Same uniforms set: %s, literal handles match: %s, hash collisions: %d\n",
+            nameSets == handleSets ? "yes" : "NO", literalsMatch ? "yes" : "NO", hashCollisions);
+
+    return nameSets == handleSets && literalsMatch && !hashCollisions;
+}
+
+
+//-------------------------------------------------------------------------------------
+// ***** Benchmark table
+
+struct BenchmarkEntry
+{
+    const char* Name;
+    const char* Description;
+    bool        (*Run)();   // False if a result check failed.
+};
+
+static const BenchmarkEntry Benchmarks[] =
+{
+    { "indices", "Scene loader index parsing, 10k-500k indices", BenchmarkIndexParsing },
+    { "decode",  "Parallel scene model decode on 1, 2, 4 and 8 threads", BenchmarkParallelDecode },
+    { "tga",     "TGA decoding, per-pixel reads vs. bulk read and SIMD swizzle", BenchmarkTgaDecode },
+    { "mips",    "Mip chain generation per filter path, checked bit-exact against scalar", BenchmarkMipChain },
+    { "bc",      "BC1/BC3 compression speed and PSNR on the scene's TGA textures", BenchmarkBlockCompression },
+    { "bvh",     "Collision tree queries along a player path, 100 to 100k hulls", BenchmarkCollisionTree },
+    { "hull",    "Batched ray vs. hull kernels per path, checked against scalar TestRay", BenchmarkCollisionKernel },
+    { "ground",  "Ground probes through the XZ grid and heightfield, checked against the loop", BenchmarkGroundGrid },
+    { "capsule", "Capsule controller replay: determinism, no penetration, per-frame cost", BenchmarkCapsuleController },
+    { "timestep", "Fixed-step movement gives the same trajectory at any frame rate", BenchmarkFixedTimestep },
+    { "hullopt", "Duplicate plane removal, plane order and bounds pretest of collision hulls", BenchmarkHullOptimization },
+    { "walk",    "Collision query rate and per-frame cost on a walk through synthetic rooms", BenchmarkCollisionWalk },
+    { "render",  "Headless frame time, draws and state changes through the null render device", BenchmarkNullRender },
+    { "sort",    "State changes with draws in file order vs. sorted by the render queue", BenchmarkRenderQueue },
+    { "stereo",  "CPU frame time traversing the scene once per eye vs. once per frame", BenchmarkStereoSubmission },
+    { "xform",   "Scene traversal with cached world matrices, static and partly moving", BenchmarkTransformCache },
+    { "list",    "Frame time and cache misses walking nodes vs. the flattened render list", BenchmarkRenderList },
+    { "soft",    "Software rasterizer frame rate on a camera path, 1 to N threads, checked identical", BenchmarkSoftRender },
+    { "uniform", "SetUniform cost by name vs. by precomputed handle over the builtin shaders", BenchmarkUniformHandles },
+};
+
+static const UPInt BenchmarkCount = sizeof(Benchmarks) / sizeof(Benchmarks[0]);
+
+bool RunBenchmark(const char* name, bool* passed)
+{
+    bool found = false;
+    *passed = true;
+    for (UPInt i = 0; i < BenchmarkCount; i++)
+    {
+        if (!OVR_stricmp(name, "all") || !OVR_stricmp(name, Benchmarks[i].Name))
+        {
+            LogText("--- %s: %s\n", Benchmarks[i].Name, Benchmarks[i].Description);
+            if (!Benchmarks[i].Run())
+            {
+                LogText("--- %s FAILED\n", Benchmarks[i].Name);
+                *passed = false;
+            }
+            found = true;
+        }
+    }
+    return found;
+}
+
+void ListBenchmarks()
+{
+    LogText("Available benchmarks (run with -bench <name> or -bench all):\n");
+    for (UPInt i = 0; i < BenchmarkCount; i++)
+    {
+        LogText("  %-12s %s\n", Benchmarks[i].Name, Benchmarks[i].Description);
+    }
+}
+
+bool RunSoftGolden(const char* dir)
+{
+    static const int width = 640, height = 400;
+    static const int goldenFrames = 4;
+    // Channels may differ by this much, and this fraction of pixels may differ by
+    // more, before a frame fails; float results vary a little between compilers.
+    static const int    channelTolerance = 2;
+    static const double pixelTolerance   = 0.001;
+
+    Ptr<Soft::RenderDevice> ren = *new Soft::RenderDevice(RendererParams());
+    ren->SetWindowSize(width, height);
+
+    SoftScene scene;
+    MakeSoftScene(ren, &scene);
+
+    bool passed = true;
+    for (int i = 0; i < goldenFrames; i++)
+    {
+        int frame = i * scene.FrameCount / goldenFrames;
+        RenderSoftFrame(ren, &scene, width, height, frame);
+        const Soft::Texture* image = ren->GetFrameBuffer();
+
+        char path[512];
+        OVR_sprintf(path, sizeof(path), "%s/soft_frame%02d.tga", dir, frame);
+
+        SysFile          f(path);
+        Ptr<TextureData> golden;
+        if (f.IsValid())
+            golden = *LoadTextureDataTga(&f);
+        f.Close();
+        if (!golden)
+        {
+            bool written = WriteSoftFrameTga(path, image);
+            LogText("%s: %s\n", path, written ? "written" : "could not be written");
+            passed = passed && written;
+            continue;
+        }
+        if (golden->Width != width || golden->Height != height)
+        {
+            LogText("%s: FAILED, %dx%d instead of %dx%d\n", path, golden->Width, golden->Height, width, height);
+            passed = false;
+            continue;
+        }
+
+        // The TGA loader returns rows bottom to top.
+        int badPixels = 0, maxDiff = 0;
+        for (int y = 0; y < height; y++)
+        {
+            const UByte* a = &image->Texels[(UPInt)y * width * 4];
+            const UByte* b = golden->pData + (UPInt)(height - 1 - y) * width * 4;
+            for (int x = 0; x < width * 4; x += 4)
+            {
+                int diff = 0;
+                for (int c = 0; c < 4; c++)
+                    diff = Alg::Max(diff, abs(a[x + c] - b[x + c]));
+                maxDiff = Alg::Max(maxDiff, diff);
+                if (diff > channelTolerance)
+                    badPixels++;
+            }
+        }
+
+        bool match = badPixels <= (int)(pixelTolerance * width * height);
+        LogText("%s: %s, %d pixels differ, max difference %d\n", path,
+                match ? "ok" : "FAILED", badPixels, maxDiff);
+        passed = passed && match;
+    }
+    return passed;
+}
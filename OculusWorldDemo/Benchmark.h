@@ -0,0 +1,66 @@
+/************************************************************************************
+
+Filename    :   Benchmark.h
+Content     :   Command-line micro-benchmarks for the loader, collision and renderer
+Created     :   October 17, 2026
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*************************************************************************************/
+
+#ifndef OVR_WorldDemo_Benchmark_h
+#define OVR_WorldDemo_Benchmark_h
+
+#include "OVR.h"
+
+using namespace OVR;
+
+// Benchmarks are run with "OculusWorldDemo -bench <name>" ("-bench all" runs every
+// one of them). They work on synthetic data, need no HMD, Hydra or scene assets,
+// and report their results through LogText. The process exits with 1 if a
+// benchmark's result check fails, so they can be run as tests.
+
+// Runs the named benchmark; returns false if there is no benchmark by that name.
+// passed is set to false if any of the benchmark's result checks failed.
+bool RunBenchmark(const char* name, bool* passed);
+
+// Logs the list of available benchmarks.
+void ListBenchmarks();
+
+// Renders frames of a synthetic scene with the software device and compares them
+// with the golden TGA images in dir, writing the ones that are missing. Returns
+// false if a frame differs or can't be written.
+bool RunSoftGolden(const char* dir);
+
+// Returns the current time in seconds, for timing benchmark loops.
+inline double GetBenchmarkTime()
+{
+    return Timer::GetTicks() * (1.0 / (double)Timer::MksPerSecond);
+}
+
+// Sorts times in place, for taking percentiles.
+inline void SortBenchmarkTimes(Array<double>* times)
+{
+    for (UPInt i = 1; i < times->GetSize(); i++)
+    {
+        double v = (*times)[i];
+        UPInt  j = i;
+        for (; j > 0 && (*times)[j - 1] > v; j--)
+            (*times)[j] = (*times)[j - 1];
+        (*times)[j] = v;
+    }
+}
+
+#endif // OVR_WorldDemo_Benchmark_h
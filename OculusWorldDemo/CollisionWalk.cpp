@@ -0,0 +1,131 @@
+/************************************************************************************
+
+Filename    :   CollisionWalk.cpp
+Content     :   Scripted walks through a scene's collision hulls
+Created     :   October 17, 2026
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*************************************************************************************/
+
+#include "CollisionWalk.h"
+#include "Benchmark.h"
+#include "../CommonSrc/Render/Render_XmlSceneLoader.h"
+
+void MakeStepInputTrace(unsigned seed, int stepCount, Array<ReplayFrame>* trace)
+{
+    ReplayFrame input;
+    int         held = 0;
+    input.Dt = 1.0f / PhysicsStepsPerSecond;
+    input.Yaw = 0;
+    for (int i = 0; i < stepCount; i++)
+    {
+        if (held-- <= 0)
+        {
+            seed = seed * 1103515245u + 12345u;
+            unsigned r = seed >> 8;
+            held          = 50 + (int)(r % 450);
+            input.Yaw    += ((r >> 4) % 628) * 0.01f;
+            input.Forward = (r % 5) != 0;
+            input.Left    = (r % 7) == 0;
+            input.Shift   = (r % 3) == 0;
+        }
+        trace->PushBack(input);
+    }
+}
+
+void ApplyReplayInput(Player* player, const ReplayFrame& input)
+{
+    player->EyeYaw      = input.Yaw;
+    player->MoveForward = input.Forward ? 1 : 0;
+    player->MoveLeft    = input.Left ? 1 : 0;
+}
+
+Vector3f ReplayCollisionWalk(const CollisionTree& walls, const GroundGrid& ground,
+                             const Vector3f& start, int stepCount)
+{
+    Array<ReplayFrame> trace;
+    MakeStepInputTrace(5, stepCount, &trace);
+
+    Player player;
+    player.EyePos = start;
+    player.ResetPhysicsClock(0);
+
+    Array<double>       frameTimes;
+    CollisionQueryStats total;
+    double              totalSeconds = 0;
+    int                 steps = 0;
+
+    for (double time = 1.0 / 75; steps < stepCount; time += 1.0 / 75)
+    {
+        int due = player.GetDuePhysicsSteps(time);
+
+        CollisionModel::ResetQueryStats();
+        double t0 = GetBenchmarkTime();
+        for (int i = 0; i < due && steps < stepCount; i++, steps++)
+        {
+            ApplyReplayInput(&player, trace[steps]);
+            player.StepPhysics(&walls, &ground, NULL, trace[steps].Shift);
+        }
+        double seconds = GetBenchmarkTime() - t0;
+
+        const CollisionQueryStats& stats = CollisionModel::GetQueryStats();
+        total.RayTests   += stats.RayTests;
+        total.PointTests += stats.PointTests;
+        total.SweepTests += stats.SweepTests;
+        total.PlaneTests += stats.PlaneTests;
+        totalSeconds     += seconds;
+        frameTimes.PushBack(seconds);
+    }
+
+    SortBenchmarkTimes(&frameTimes);
+    UPInt    frames  = frameTimes.GetSize();
+    unsigned queries = total.RayTests + total.PointTests + total.SweepTests;
+
+    LogText("%d steps in %d frames: %u rays, %u points, %u sweeps, %u planes\n",
+            steps, (int)frames, total.RayTests, total.PointTests, total.SweepTests, total.PlaneTests);
+    LogText("%.2f M queries/s, %.1f M planes/s\n",
+            queries / totalSeconds * 1e-6, total.PlaneTests / totalSeconds * 1e-6);
+    LogText("Per frame: p50 %.2f us, p99 %.2f us, max %.2f us\n",
+            frameTimes[frames / 2] * 1e6, frameTimes[frames * 99 / 100] * 1e6, frameTimes[frames - 1] * 1e6);
+    return player.EyePos;
+}
+
+bool RunCollisionWalk(const char* sceneFile)
+{
+    XmlHandler loader;
+    double     t0 = GetBenchmarkTime();
+    if (!loader.ParseCollisionFile(sceneFile))
+    {
+        LogText("Could not load %s\n", sceneFile);
+        return false;
+    }
+
+    Array<Ptr<CollisionModel> > wallModels, groundModels;
+    loader.AddCollisionModels(&wallModels, &groundModels);
+
+    CollisionTree walls;
+    walls.Build(wallModels);
+    GroundGrid ground;
+    ground.Build(groundModels);
+
+    LogText("%s: %d collision models, %d ground models, loaded in %.2f s\n", sceneFile,
+            (int)wallModels.GetSize(), (int)groundModels.GetSize(), GetBenchmarkTime() - t0);
+
+    Player start;
+    Vector3f end = ReplayCollisionWalk(walls, ground, start.EyePos, PhysicsStepsPerSecond * 60);
+    LogText("Walk ended at %.2f, %.2f, %.2f\n", end.x, end.y, end.z);
+    return true;
+}
@@ -0,0 +1,57 @@
+/************************************************************************************
+
+Filename    :   CollisionWalk.h
+Content     :   Scripted walks through a scene's collision hulls, for benchmarks
+                and the standalone collision walk tool
+Created     :   October 17, 2026
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*************************************************************************************/
+
+#ifndef OVR_WorldDemo_CollisionWalk_h
+#define OVR_WorldDemo_CollisionWalk_h
+
+#include "Player.h"
+
+// Nothing here touches a renderer, HMD or Hydra, so this builds into the demo's
+// benchmarks and into the standalone tool in CollisionWalkTool alike.
+
+// One frame of recorded input.
+struct ReplayFrame
+{
+    float Dt;
+    float Yaw;
+    bool  Forward, Left, Shift;
+};
+
+// Input held for a random number of steps at a time, indexed by physics step.
+void MakeStepInputTrace(unsigned seed, int stepCount, Array<ReplayFrame>* trace);
+
+// Sets the player's yaw and movement keys from input.
+void ApplyReplayInput(Player* player, const ReplayFrame& input);
+
+// Walks the player through the models at 75 frames per second and logs the rate
+// of collision queries and the collision time per frame. Returns the final eye
+// position.
+Vector3f ReplayCollisionWalk(const CollisionTree& walls, const GroundGrid& ground,
+                             const Vector3f& start, int stepCount);
+
+// Loads the collision hulls of a scene XML, without a renderer, and replays a
+// walk through them, logging query rates and per-frame cost. Returns false if
+// the scene could not be loaded.
+bool RunCollisionWalk(const char* sceneFile);
+
+#endif // OVR_WorldDemo_CollisionWalk_h
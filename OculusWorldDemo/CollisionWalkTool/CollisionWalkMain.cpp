@@ -0,0 +1,44 @@
+/************************************************************************************
+
+Filename    :   CollisionWalkMain.cpp
+Content     :   Standalone collision walk: loads a scene's collision hulls and
+                times a scripted walk through them, with no renderer or HMD
+Created     :   October 17, 2026
+
+Copyright   :   Copyright 2013 Oculus VR, Inc. All Rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*************************************************************************************/
+
+#include "../CollisionWalk.h"
+
+#include <stdio.h>
+
+// Usage: CollisionWalk <scene.xml>
+// Logs the query rate (queries/s) and the p50/p99 collision time per frame, as
+// "OculusWorldDemo -collisionwalk" does. Exits with 1 if the scene can't be loaded.
+int main(int argc, char** argv)
+{
+    if (argc != 2)
+    {
+        fprintf(stderr, "Usage: %s <scene.xml>\n", argv[0]);
+        return 2;
+    }
+
+    System::Init(Log::ConfigureDefaultLog(LogMask_All));
+    bool loaded = RunCollisionWalk(argv[1]);
+    System::Destroy();
+
+    return loaded ? 0 : 1;
+}
@@ -59,10 +59,15 @@ void SixenseCallBack( sixenseUtils::ControllerManager::setup_step step )
 OculusWorldDemoApp::OculusWorldDemoApp()
     : pRender(0),
       LastUpdate(0),
+      LastDrawsSubmitted(0), LastDrawsCulled(0), LastStateChangesSaved(0), LastUniformBytes(0),
+      LastCollisionSteps(0), LastCollisionMicros(0),
+      TextureQuality(TextureCompress_None),
+      HeightfieldSpacing(0),
       LoadingState(LoadingState_Frame0),
       // Initial location
       SConfig(),
       PostProcess(PostProcess_Distortion),
+      SinglePassStereo(true),
       DistortionClearColor(0, 0, 0),
 
       ShiftDown(false),
@@ -101,6 +106,9 @@ OculusWorldDemoApp::~OculusWorldDemoApp()
     }
     pSensor.Clear();
     pHMD.Clear();
+	CollisionHulls.Clear();
+	GroundCollisionGrid.Clear();
+	GroundHeights.Clear();
 	CollisionModels.ClearAndRelease();
 	GroundCollisionModels.ClearAndRelease();
 	sixenseExit();
@@ -108,6 +116,51 @@ OculusWorldDemoApp::~OculusWorldDemoApp()
 
 int OculusWorldDemoApp::OnStartup(int argc, const char** argv)
 {
+    // "-compile <scene.xml>" writes the compiled scene next to the XML and exits
+    // without touching the Hydra, HMD or renderer.
+    if (argc == 3 && !strcmp(argv[1], "-compile"))
+    {
+        String compiledPath = GetCompiledScenePath(argv[2]);
+        bool   compiled     = CompileScene(argv[2], compiledPath.ToCStr());
+        LogText("Compiling %s to %s %s\n", argv[2], compiledPath.ToCStr(),
+                compiled ? "succeeded" : "FAILED");
+        pPlatform->Exit(compiled ? 0 : 1);
+        return 0;
+    }
+
+    // "-collisionwalk <scene.xml>" loads only the scene's collision hulls, replays
+    // a walk through them and exits; like -bench, it needs no GPU or HMD.
+    // CollisionWalkTool builds the same walk as a standalone Linux program.
+    if (argc == 3 && !strcmp(argv[1], "-collisionwalk"))
+    {
+        bool loaded = RunCollisionWalk(argv[2]);
+        pPlatform->Exit(loaded ? 0 : 1);
+        return 0;
+    }
+
+    // "-softgolden <dir>" renders test frames with the software device and checks
+    // them against the golden images in dir, writing any that are missing.
+    if (argc == 3 && !strcmp(argv[1], "-softgolden"))
+    {
+        bool passed = RunSoftGolden(argv[2]);
+        pPlatform->Exit(passed ? 0 : 1);
+        return 0;
+    }
+
+    // "-bench <name>" runs a benchmark on synthetic data and exits, with 1 if it
+    // isn't found or one of its result checks fails.
+    if (argc >= 2 && !strcmp(argv[1], "-bench"))
+    {
+        bool passed = false;
+        bool found  = (argc == 3) && RunBenchmark(argv[2], &passed);
+        if (!found)
+        {
+            ListBenchmarks();
+        }
+        pPlatform->Exit((found && passed) ? 0 : 1);
+        return 0;
+    }
+
 	// *** Razer Hydra init
 
 	int base = 0;
@@ -226,6 +279,9 @@ int OculusWorldDemoApp::OnStartup(int argc, const char** argv)
     // *** Initialize Rendering
 
     const char* graphics = "d3d11";
+    int         loaderThreads = 0;
+    bool        rebuildTextureCache = false;
+    float       renderScale = 1.0f;
 
     // Select renderer based on command line arguments.
     for(int i = 1; i < argc; i++)
@@ -234,8 +290,30 @@ int OculusWorldDemoApp::OnStartup(int argc, const char** argv)
             graphics = argv[i + 1];
         else if(!strcmp(argv[i], "-fs"))
             RenderParams.Fullscreen = true;
+        else if(!strcmp(argv[i], "-loadthreads") && i < argc - 1)
+            loaderThreads = atoi(argv[i + 1]);
+        else if(!strcmp(argv[i], "-rebuildcache"))
+            rebuildTextureCache = true;
+        else if(!strcmp(argv[i], "-multipass"))
+            SinglePassStereo = false;
+        else if(!strcmp(argv[i], "-renderscale") && i < argc - 1)
+            renderScale = (float)atof(argv[i + 1]);
+        else if(!strcmp(argv[i], "-heightfield") && i < argc - 1)
+            HeightfieldSpacing = (float)atof(argv[i + 1]);
+        else if(!strcmp(argv[i], "-texcompress") && i < argc - 1)
+        {
+            if (!OVR_stricmp(argv[i + 1], "fast"))
+                TextureQuality = TextureCompress_Fast;
+            else if (!OVR_stricmp(argv[i + 1], "normal"))
+                TextureQuality = TextureCompress_Normal;
+            else if (!OVR_stricmp(argv[i + 1], "high"))
+                TextureQuality = TextureCompress_High;
+        }
     }
 
+    // Scene loading decodes models on one thread per core unless told otherwise.
+    pLoaderPool = *new WorkerPool(loaderThreads);
+
     // Enable multi-sampling by default.
     RenderParams.Multisample = 4;
     pRender = pPlatform->SetupGraphics(OVR_DEFAULT_RENDER_DEVICE_SET,
@@ -258,7 +336,8 @@ int OculusWorldDemoApp::OnStartup(int argc, const char** argv)
         else        
             SConfig.SetDistortionFitPointVP(0.0f, 1.0f);
 
-    pRender->SetSceneRenderScale(SConfig.GetDistortionScale());
+    // "-renderscale 0.5" draws the scene at a lower resolution, e.g. with "-r soft".
+    pRender->SetSceneRenderScale(SConfig.GetDistortionScale() * renderScale);
     //pRender->SetSceneRenderScale(0.8f);
 
     SConfig.Set2DAreaFov(DegreeToRad(85.0f));
@@ -267,7 +346,7 @@ int OculusWorldDemoApp::OnStartup(int argc, const char** argv)
     // *** Identify Scene File & Prepare for Loading
    
     // This creates lights and models.
-    if (argc == 2)
+    if (argc == 2 && argv[1][0] != '-')
     {        
         MainFilePath = argv[1];
         PopulateLODFileNames();
@@ -292,6 +371,11 @@ int OculusWorldDemoApp::OnStartup(int argc, const char** argv)
             MainFilePath = prefixPath3 + MainFilePath;
     }
 
+    // Decoded and mipmapped textures are kept next to the scene; "-rebuildcache"
+    // regenerates every entry.
+    String textureCachePath = MainFilePath.GetPath() + "TextureCache";
+    pTextureCache = *new TextureCache(textureCachePath.ToCStr(), rebuildTextureCache);
+
     PopulatePreloadScene();
 
     LastUpdate = pPlatform->GetAppTime();
@@ -670,7 +754,8 @@ void OculusWorldDemoApp::OnKey(KeyCode key, int chr, bool down, int modifiers)
 
         // Reset the camera position in case we get stuck
     case Key_T:
-        Player.EyePos = Vector3f(10.0f, 1.6f, 10.0f);
+        Player.EyePos     = Vector3f(10.0f, 1.6f, 10.0f);
+        Player.PrevEyePos = Player.EyePos;
         break;
 
     case Key_C:
@@ -683,7 +768,7 @@ void OculusWorldDemoApp::OnKey(KeyCode key, int chr, bool down, int modifiers)
                 Render::Model*          pNode = nodePtr.GetPtr();
                 if(pNode->IsCollisionModel)
                 {
-                    pNode->Visible = !pNode->Visible;
+                    pNode->SetVisible(!pNode->Visible);
                 }
             }
             break;
@@ -711,14 +796,30 @@ void OculusWorldDemoApp::OnIdle()
 		sixenseUtils::getTheControllerManager()->update( &acd );
 	}
 
+    // Scene file reading, parsing and texture decoding happen on a loader thread;
+    // here we only create GPU resources, a few milliseconds' worth per frame.
     if (LoadingState == LoadingState_DoLoad)
     {
-        PopulateScene(MainFilePath.ToCStr());
-		if(FoundHydra)
-			LoadingState = LoadingState_InitHydra;
-		else
-			LoadingState = LoadingState_Finished;
-        return;
+        pSceneLoader = *new AsyncSceneLoader(pLoaderPool, pTextureCache);
+        pSceneLoader->SetTextureCompression(TextureQuality);
+        pSceneLoader->Start(MainFilePath.ToCStr());
+        LoadingState = LoadingState_Streaming;
+    }
+    if (LoadingState == LoadingState_Streaming)
+    {
+        const double loadBudgetSeconds = 0.004;
+        AsyncSceneLoader::LoadState state =
+            pSceneLoader->Update(pRender, &MainScene, &CollisionModels, &GroundCollisionModels,
+                                 loadBudgetSeconds);
+        if (state == AsyncSceneLoader::Load_Finished || state == AsyncSceneLoader::Load_Failed)
+        {
+            FinishPopulateScene(state == AsyncSceneLoader::Load_Finished);
+            pSceneLoader.Clear();
+            if(FoundHydra)
+                LoadingState = LoadingState_InitHydra;
+            else
+                LoadingState = LoadingState_Finished;
+        }
     }
 
 	if(LoadingState == LoadingState_InitHydra && HydraSetupFinished)
@@ -782,14 +883,34 @@ void OculusWorldDemoApp::OnIdle()
         ConsecutiveLowFPSFrames = 0;
     }
 
-    if(ConsecutiveLowFPSFrames > 200)
+    if(ConsecutiveLowFPSFrames > 200 && LoadingState == LoadingState_Finished)
     {
         DropLOD();
         ConsecutiveLowFPSFrames = 0;
     }
 
     Player.EyeYaw -= Player.GamepadRotate.x * dt;
-	Player.HandleCollision(dt, &CollisionModels, &GroundCollisionModels, ShiftDown);
+
+    // Hold position until the collision hulls have been loaded.
+    if (LoadingState == LoadingState_Finished || LoadingState == LoadingState_InitHydra)
+    {
+        CollisionModel::ResetQueryStats();
+        UInt64 collisionStart = Timer::GetTicks();
+
+        int steps = Player.GetDuePhysicsSteps(curtime);
+        for (int i = 0; i < steps; i++)
+        {
+            Player.StepPhysics(&CollisionHulls, &GroundCollisionGrid, &GroundHeights, ShiftDown);
+        }
+
+        LastCollisionSteps  = steps;
+        LastCollisionMicros = Timer::GetTicks() - collisionStart;
+        LastCollisionStats  = CollisionModel::GetQueryStats();
+    }
+    else
+    {
+        Player.ResetPhysicsClock(curtime);
+    }
 
     if(!pSensor)
     {
@@ -919,12 +1040,12 @@ void OculusWorldDemoApp::OnIdle()
 	{
 		Player.AdjustedEyePos = forward * -((HydraLeftPos.z/1000.f) * 2);
 		Player.AdjustedEyePos.y = 0;
-		Player.AdjustedEyePos += Player.EyePos;
+		Player.AdjustedEyePos += Player.GetRenderEyePos();
 		Player.AdjustedEyePos += UpVector * (HydraLeftPos.y/1000.f);
 		Player.AdjustedEyePos += right * ((HydraLeftPos.x/1000.f)*2);
 	}
 	else
-		Player.AdjustedEyePos = Player.EyePos;
+		Player.AdjustedEyePos = Player.GetRenderEyePos();
 	
 	Vector3f shiftedEyePos = Player.AdjustedEyePos + rollPitchYaw.Transform(eyeCenterInHeadFrame);
     shiftedEyePos.y -= eyeCenterInHeadFrame.y; // Bring the head back down to original height
@@ -940,6 +1061,13 @@ void OculusWorldDemoApp::OnIdle()
     //         Matrix4f::Translation(-EyePos);
 
 
+    // The stats screen is drawn mid-frame, so it shows the previous frame's totals.
+    LastDrawsSubmitted = pRender->GetDrawsSubmitted();
+    LastDrawsCulled    = pRender->GetDrawsCulled();
+    LastStateChangesSaved = pRender->GetStateChangesSaved();
+    LastUniformBytes   = pRender->GetUniformBytesUploaded();
+    pRender->ResetDrawStats();
+
     switch(SConfig.GetStereoMode())
     {
     case Stereo_None:
@@ -948,6 +1076,11 @@ void OculusWorldDemoApp::OnIdle()
 
     case Stereo_LeftRight_Multipass:
         //case Stereo_LeftDouble_Multipass:
+        if (SinglePassStereo && SceneMode != Scene_Grid)
+        {
+            MainScene.CollectStereo(pRender, View, SConfig.GetEyeRenderParams(StereoEye_Left),
+                                    SConfig.GetEyeRenderParams(StereoEye_Right));
+        }
         Render(SConfig.GetEyeRenderParams(StereoEye_Left));
         Render(SConfig.GetEyeRenderParams(StereoEye_Right));
         break;
@@ -1012,7 +1145,21 @@ void OculusWorldDemoApp::Render(const StereoEyeParams& stereo)
     pRender->SetDepthMode(true, true);
     if (SceneMode != Scene_Grid)
     {
-        MainScene.Render(pRender, stereo.ViewAdjust * View);
+        if (SinglePassStereo && stereo.Eye != StereoEye_Center)
+            MainScene.RenderEye(pRender, stereo);
+        else
+            MainScene.Render(pRender, stereo.ViewAdjust * View);
+    }
+
+    // The loading screen-shot is placed in front of the starting view.
+    if (LoadingState != LoadingState_Finished && LoadingState != LoadingState_InitHydra)
+    {
+        if (LoadingState == LoadingState_Frame0)
+        {
+            Matrix4f yaw = Matrix4f::RotationY(Player.EyeYaw);
+            LoadingPanelTransform = Matrix4f::Translation(Player.EyePos + yaw.Transform(ForwardVector) * 1.5f) * yaw;
+        }
+        LoadingScene.Render(pRender, stereo.ViewAdjust * View * LoadingPanelTransform);
     }
 
 
@@ -1032,13 +1179,19 @@ void OculusWorldDemoApp::Render(const StereoEyeParams& stereo)
         GridScene.Render(pRender, Matrix4f::Translation(unitPixel,unitPixel,0));
     }
 
-    // Display Loading screen-shot in frame 0.
+    // Display loading message and progress until the scene is in.
     if (LoadingState != LoadingState_Finished && LoadingState != LoadingState_InitHydra)
     {
-        LoadingScene.Render(pRender, Matrix4f());
         String loadMessage = String("Loading ") + MainFilePath;
         DrawTextBox(pRender, 0, 0.25f, textHeight, loadMessage.ToCStr(), DrawText_HCenter);
-        LoadingState = LoadingState_DoLoad;
+
+        float progress = pSceneLoader ? pSceneLoader->GetProgress() : 0.0f;
+        float barTop   = 0.25f + textHeight + 0.06f;
+        pRender->FillRect(-0.3f, barTop, 0.3f, barTop + 0.03f, Color(40,40,100,210));
+        pRender->FillRect(-0.3f, barTop, -0.3f + 0.6f * progress, barTop + 0.03f, Color(255,255,0,210));
+
+        if (LoadingState == LoadingState_Frame0)
+            LoadingState = LoadingState_DoLoad;
     }
 
 	if(LoadingState == LoadingState_InitHydra)
@@ -1056,20 +1209,29 @@ void OculusWorldDemoApp::Render(const StereoEyeParams& stereo)
     {
     case Text_Orientation:
     {
-        char buf[256];
+        char buf[512];
         size_t texMemInMB = pRender->GetTotalTextureMemoryUsage() / 1058576;
         OVR_sprintf(buf, sizeof(buf),
                     " Yaw:%4.0f  Pitch:%4.0f  Roll:%4.0f \n"
                     " FPS: %d  Frame: %d \n Pos: %3.2f, %3.2f, %3.2f \n"
 					" HX: %3.2f, %3.2f, %3.2f \n"
 					" RX: %3.2f, %3.2f, %3.2f, %3.2f \n"
-                    " GPU Tex: %u MB \n EyeHeight: %3.2f",
+                    " GPU Tex: %u MB \n EyeHeight: %3.2f \n"
+                    " Draws: %d  Culled: %d  Saved binds: %d \n"
+                    " Uniforms: %u KB \n"
+                    " Collision: %d steps  %4.2f ms \n"
+                    " Rays: %u  Points: %u  Sweeps: %u  Planes: %u",
                     RadToDegree(Player.EyeYaw), RadToDegree(Player.EyePitch), RadToDegree(Player.EyeRoll),
                     FPS, FrameCounter, Player.EyePos.x, Player.EyePos.y, Player.EyePos.z, 
 					(HydraLeftPos.x/1000.f), (HydraLeftPos.y/1000.f), (HydraLeftPos.z/1000.f), 
 					HydraControlRotation[0], HydraControlRotation[1], HydraControlRotation[2], HydraControlRotation[3],
 					
-					texMemInMB, Player.AdjustedEyePos.y);
+					texMemInMB, Player.AdjustedEyePos.y,
+                    LastDrawsSubmitted, LastDrawsCulled, LastStateChangesSaved,
+                    (unsigned)(LastUniformBytes / 1024),
+                    LastCollisionSteps, LastCollisionMicros * 0.001,
+                    LastCollisionStats.RayTests, LastCollisionStats.PointTests,
+                    LastCollisionStats.SweepTests, LastCollisionStats.PlaneTests);
             DrawTextBox(pRender, 0, 0.05f, textHeight, buf, DrawText_HCenter);
     }
     break;
@@ -1168,6 +1330,7 @@ void OculusWorldDemoApp::AdjustEyeHeight(float dt)
 
     Player.EyeHeight += dist;
     Player.EyePos.y += dist;
+    Player.PrevEyePos.y += dist;
 
     SetAdjustMessage("EyeHeight: %4.2f", Player.EyeHeight);
 }
@@ -1176,12 +1339,37 @@ void OculusWorldDemoApp::AdjustEyeHeight(float dt)
 // Loads the scene data
 void OculusWorldDemoApp::PopulateScene(const char *fileName)
 {    
-    XmlHandler xmlHandler;     
-    if(!xmlHandler.ReadFile(fileName, pRender, &MainScene, &CollisionModels, &GroundCollisionModels))
+    XmlHandler xmlHandler;
+    xmlHandler.SetTextureCache(pTextureCache);
+    xmlHandler.SetTextureCompression(TextureQuality);
+    bool       loaded = ParseSceneFile(&xmlHandler, fileName, pLoaderPool);
+
+    if (loaded)
+    {
+        xmlHandler.BuildScene(pRender, &MainScene, &CollisionModels, &GroundCollisionModels);
+    }
+    FinishPopulateScene(loaded);
+}
+
+void OculusWorldDemoApp::FinishPopulateScene(bool loaded)
+{
+    if (!loaded)
     {
         SetAdjustMessage("---------------------------------\nFILE LOAD FAILED\n---------------------------------");
         SetAdjustMessageTimeout(10.0f);
-    }    
+    }
+
+    if (pTextureCache)
+    {
+        pTextureCache->LogStats();
+    }
+
+    CollisionHulls.Build(CollisionModels);
+    GroundCollisionGrid.Build(GroundCollisionModels);
+    if (HeightfieldSpacing > 0)
+    {
+        GroundHeights.Bake(GroundCollisionGrid, HeightfieldSpacing);
+    }
 
     MainScene.SetAmbient(Vector4f(1.0f, 1.0f, 1.0f, 1.0f));
     
@@ -1275,6 +1463,10 @@ void OculusWorldDemoApp::PopulateLODFileNames()
 
 void OculusWorldDemoApp::DropLOD()
 {
+    // Switching files while the initial load is still streaming in is not supported.
+    if (pSceneLoader)
+        return;
+
     if(CurrentLODFileIndex < (int)(LODFilePaths.GetSize() - 1))
     {
         ClearScene();
@@ -1285,6 +1477,10 @@ void OculusWorldDemoApp::DropLOD()
 
 void OculusWorldDemoApp::RaiseLOD()
 {
+    // Switching files while the initial load is still streaming in is not supported.
+    if (pSceneLoader)
+        return;
+
     if(CurrentLODFileIndex > 0)
     {
         ClearScene();
@@ -3,9 +3,15 @@
 #include "OVR.h"
 
 #include "Player.h"
+#include "Benchmark.h"
+#include "CollisionWalk.h"
 #include "../CommonSrc/Platform/Platform_Default.h"
 #include "../CommonSrc/Render/Render_Device.h"
 #include "../CommonSrc/Render/Render_XMLSceneLoader.h"
+#include "../CommonSrc/Render/Render_CompiledScene.h"
+#include "../CommonSrc/Render/Render_AsyncSceneLoader.h"
+#include "../CommonSrc/Render/Render_CollisionTree.h"
+#include "../CommonSrc/Render/Render_GroundGrid.h"
 #include "../CommonSrc/Render/Render_FontEmbed_DejaVu48.h"
 
 #include <Kernel/OVR_SysFile.h>
@@ -107,6 +113,7 @@ public:
 
     // Adds room model to scene.
     void         PopulateScene(const char* fileName);
+    void         FinishPopulateScene(bool loaded);
     void         PopulatePreloadScene();
     void		 ClearScene();
 
@@ -131,9 +138,30 @@ protected:
     int                 FPS;
     int                 FrameCounter;
     double              NextFPSUpdate;
+    // Model draws of the previous frame, for the stats screen.
+    int                 LastDrawsSubmitted;
+    int                 LastDrawsCulled;
+    int                 LastStateChangesSaved;
+    UPInt               LastUniformBytes;
+    // Movement steps of the previous frame, their time and collision queries.
+    int                 LastCollisionSteps;
+    UInt64              LastCollisionMicros;
+    CollisionQueryStats LastCollisionStats;
 
     Array<Ptr<CollisionModel> > CollisionModels;
     Array<Ptr<CollisionModel> > GroundCollisionModels;
+    // Built from the arrays above once the scene has loaded.
+    CollisionTree               CollisionHulls;
+    GroundGrid                  GroundCollisionGrid;
+    GroundHeightfield           GroundHeights;
+
+    // Threads used to decode scene files; see "-loadthreads".
+    Ptr<WorkerPool>     pLoaderPool;
+    Ptr<TextureCache>   pTextureCache;
+    // Block compression for RGBA scene textures; see "-texcompress".
+    TextureCompression  TextureQuality;
+    // Sample spacing of the baked ground heightfield, 0 if off; see "-heightfield".
+    float               HeightfieldSpacing;
 
     // Loading process displays screenshot in first frame
     // and then proceeds to load until finished.
@@ -141,6 +169,7 @@ protected:
     {
         LoadingState_Frame0,
         LoadingState_DoLoad,
+        LoadingState_Streaming,
 		LoadingState_InitHydra,
         LoadingState_Finished
     };
@@ -153,11 +182,18 @@ protected:
     Scene               GridScene;
     LoadingStateType    LoadingState;
 
+    // Background scene load; the loading screen is world-locked at LoadingPanelTransform
+    // so it responds to head tracking while the scene streams in.
+    Ptr<AsyncSceneLoader> pSceneLoader;
+    Matrix4f            LoadingPanelTransform;
+
     Ptr<ShaderFill>     LitSolid, LitTextures[4];
 
     // Stereo view parameters.
     StereoConfig        SConfig;
     PostProcessType     PostProcess;
+    // Traverse MainScene once for both eyes; "-multipass" turns it off.
+    bool                SinglePassStereo;
 
     // LOD
     String	            MainFilePath;
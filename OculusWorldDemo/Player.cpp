@@ -22,16 +22,20 @@ limitations under the License.
 
 #include "Player.h"
 #include <Kernel/OVR_Alg.h>
+#include <math.h>
 
 Player::Player(void)
 	: EyeHeight(1.8f),
 	  EyePos(7.7f, 1.8f, -1.0f),
       EyeYaw(YawInitial), EyePitch(0), EyeRoll(0),
-      LastSensorYaw(0)
+      LastSensorYaw(0),
+      Body(BodyRadius, RailHeight - BodyRadius),
+      PhysicsStep(0), PhysicsStepFraction(0), PlaneTestsPerStep(PlaneTestsPerPhysicsStep)
 {
 	MoveForward = MoveBack = MoveLeft = MoveRight = 0;
     GamepadMove = Vector3f(0);
     GamepadRotate = Vector3f(0);
+    PrevEyePos = EyePos;
 }
 
 
@@ -39,8 +43,51 @@ Player::~Player(void)
 {
 }
 
-void Player::HandleCollision(double dt, Array<Ptr<CollisionModel> >* collisionModels,
-	                         Array<Ptr<CollisionModel> >* groundCollisionModels, bool shiftDown)
+void Player::ResetPhysicsClock(double time)
+{
+    PhysicsStep         = (UInt64)floor(time * PhysicsStepsPerSecond);
+    PhysicsStepFraction = 0;
+    PrevEyePos          = EyePos;
+}
+
+int Player::GetDuePhysicsSteps(double time)
+{
+    // Steps are counted from app time 0 rather than accumulated from frame
+    // times, so the same times give the same steps however they are split.
+    double steps  = time * PhysicsStepsPerSecond;
+    UInt64 target = (UInt64)floor(steps);
+    PhysicsStepFraction = (float)(steps - (double)target);
+    if (target <= PhysicsStep)
+    {
+        return 0;
+    }
+
+    if (target - PhysicsStep > (UInt64)MaxPhysicsStepsPerFrame)
+    {
+        PhysicsStep = target - MaxPhysicsStepsPerFrame;
+    }
+    return (int)(target - PhysicsStep);
+}
+
+int Player::StepPhysics(const CollisionTree* collisionModels, const GroundGrid* groundCollisionModels,
+                        const GroundHeightfield* groundHeights, bool shiftDown)
+{
+    PrevEyePos = EyePos;
+    int planeTests = HandleCollision(1.0 / PhysicsStepsPerSecond, collisionModels, groundCollisionModels,
+                                     groundHeights, shiftDown, PlaneTestsPerStep);
+    PhysicsStep++;
+    return planeTests;
+}
+
+Vector3f Player::GetRenderEyePos() const
+{
+    return PrevEyePos + (EyePos - PrevEyePos) * PhysicsStepFraction;
+}
+
+int Player::HandleCollision(double dt, const CollisionTree* collisionModels,
+	                         const GroundGrid* groundCollisionModels,
+	                         const GroundHeightfield* groundHeights, bool shiftDown,
+	                         int planeBudget)
 {
 	if(MoveForward || MoveBack || MoveLeft || MoveRight || GamepadMove.LengthSq() > 0)
     {
@@ -84,77 +131,29 @@ void Player::HandleCollision(double dt, Array<Ptr<CollisionModel> >* collisionMo
 
         float moveLength = OVR::Alg::Min<float>(MoveSpeed * (float)dt * (shiftDown ? 3.0f : 1.0f), 1.0f);
 
-        float   checkLengthForward = moveLength;
-        Planef  collisionPlaneForward;
-        float   checkLengthLeft = moveLength;
-        Planef  collisionPlaneLeft;
-        float   checkLengthRight = moveLength;
-        Planef  collisionPlaneRight;
-        bool    gotCollision = false;
-        bool    gotCollisionLeft = false;
-        bool    gotCollisionRight = false;
-
-        for(unsigned int i = 0; i < collisionModels->GetSize(); ++i)
-        {
-            // Checks for collisions at eye level, which should prevent us from
-			// slipping under walls
-            if (collisionModels->At(i)->TestRay(EyePos, orientationVector, checkLengthForward,
-				                                &collisionPlaneForward))
-            {
-                gotCollision = true;
-            }
-
-            Matrix4f leftRotation = Matrix4f::RotationY(45 * (Math<float>::Pi / 180.0f));
-            Vector3f leftVector   = leftRotation.Transform(orientationVector);
-            if (collisionModels->At(i)->TestRay(EyePos, leftVector, checkLengthLeft,
-				                                &collisionPlaneLeft))
-            {
-                gotCollisionLeft = true;
-            }
-            Matrix4f rightRotation = Matrix4f::RotationY(-45 * (Math<float>::Pi / 180.0f));
-            Vector3f rightVector   = rightRotation.Transform(orientationVector);
-            if (collisionModels->At(i)->TestRay(EyePos, rightVector, checkLengthRight,
-				                                &collisionPlaneRight))
-            {
-                gotCollisionRight = true;
-            }
-        }
-
-        if (gotCollision)
-        {
-            // Project orientationVector onto the plane
-            Vector3f slideVector = orientationVector - collisionPlaneForward.N
-				* (orientationVector * collisionPlaneForward.N);
+        // The body is swept as a capsule from rail height up to the eyes, sliding
+        // along walls; it can't pass through thin walls however large the step.
+        Vector3f bodyBase = EyePos - Vector3f(0.0f, Body.Height, 0.0f);
+        Vector3f movedTo  = Body.Move(*collisionModels, bodyBase, orientationVector * moveLength, planeBudget);
 
-            // Make sure we aren't in a corner
-            for(unsigned int j = 0; j < collisionModels->GetSize(); ++j)
-            {
-                if (collisionModels->At(j)->TestPoint(EyePos - Vector3f(0.0f, RailHeight, 0.0f) +
-					                                  (slideVector * (moveLength))) )
-                {
-                    moveLength = 0;
-                }
-            }
-            if (moveLength != 0)
-            {
-                orientationVector = slideVector;
-            }
-        }
         // Checks for collisions at foot level, which allows us to follow terrain
-        orientationVector *= moveLength;
-        EyePos += orientationVector;
+        EyePos += movedTo - bodyBase;
 
         Planef collisionPlaneDown;
         float finalDistanceDown = 10;
 
-        for(unsigned int i = 0; i < groundCollisionModels->GetSize(); ++i)
+        float groundHeight;
+
+        // The heightfield only holds the topmost surface, so the probe is still
+        // needed below it, e.g. under a bridge, and across steps it declines.
+        if (groundHeights && groundHeights->GetHeight(EyePos.x, EyePos.z, &groundHeight) &&
+            EyePos.y > groundHeight && EyePos.y - groundHeight < finalDistanceDown)
         {
-            float checkLengthDown = 10;
-            if (groundCollisionModels->At(i)->TestRay(EyePos, Vector3f(0.0f, -1.0f, 0.0f),
-				                                      checkLengthDown, &collisionPlaneDown))
-            {
-                finalDistanceDown = Alg::Min(finalDistanceDown, checkLengthDown);
-            }
+            finalDistanceDown = EyePos.y - groundHeight;
+        }
+        else
+        {
+            groundCollisionModels->TestRayDown(EyePos, finalDistanceDown, &collisionPlaneDown);
         }
 
         // Maintain the minimum camera height
@@ -162,5 +161,7 @@ void Player::HandleCollision(double dt, Array<Ptr<CollisionModel> >* collisionMo
         {
             EyePos.y += EyeHeight - finalDistanceDown;
         }
+        return Body.GetLastStats().PlaneTests;
     }
+    return 0;
 }
@@ -26,6 +26,9 @@ limitations under the License.
 
 #include "OVR.h"
 #include "../CommonSrc/Render/Render_Device.h"
+#include "../CommonSrc/Render/Render_CollisionTree.h"
+#include "../CommonSrc/Render/Render_GroundGrid.h"
+#include "../CommonSrc/Render/Render_CapsuleController.h"
 
 using namespace OVR;
 using namespace OVR::Render;
@@ -44,8 +47,20 @@ const float		YawInitial	= 3.141592f;
 const float		Sensitivity	= 1.0f;
 const float		MoveSpeed	= 3.0f; // m/s
 
+// Movement and collision run in fixed steps of app time, whatever the frame rate.
+// A frame that is more than MaxPhysicsStepsPerFrame behind, e.g. after a stall,
+// drops the rest instead of catching up.
+const int		PhysicsStepsPerSecond	= 240;
+const int		MaxPhysicsStepsPerFrame	= 60;
+// Capsule plane tests a frame may make, split evenly over its steps. Every step
+// gets the same budget, so a move never depends on how many steps share its frame;
+// see CapsuleController::Move.
+const int		MaxPlaneTestsPerFrame	= 4 * CapsuleController::MaxPlaneTestsPerMove;
+const int		PlaneTestsPerPhysicsStep = MaxPlaneTestsPerFrame / MaxPhysicsStepsPerFrame;
+
 // These are used for collision detection
 const float		RailHeight	= 0.8f;
+const float		BodyRadius	= 0.2f;
 
 
 //-------------------------------------------------------------------------------------
@@ -71,10 +86,36 @@ public:
     UByte               MoveRight;
     Vector3f            GamepadMove, GamepadRotate;
 
+    // Collision body, a capsule from RailHeight below the eyes to BodyRadius above them.
+    CapsuleController   Body;
+
+    // Fixed step clock: the number of steps since app time 0 that have been run,
+    // and EyePos before the last of them, which rendering interpolates from.
+    UInt64              PhysicsStep;
+    float               PhysicsStepFraction;
+    Vector3f            PrevEyePos;
+    // Plane tests each step's move may make, PlaneTestsPerPhysicsStep by default.
+    int                 PlaneTestsPerStep;
+
 	Player(void);
 	~Player(void);
-	void HandleCollision(double dt, Array<Ptr<CollisionModel> >* collisionModels,
-		                 Array<Ptr<CollisionModel> >* groundCollisionModels, bool shiftDown);
+
+    // Restarts the step clock at time without moving, e.g. while the scene loads.
+    void     ResetPhysicsClock(double time);
+    // Returns how many steps are due by time; run them with StepPhysics.
+    int      GetDuePhysicsSteps(double time);
+    // Moves by one fixed step of the current input; returns the plane tests it made.
+    int      StepPhysics(const CollisionTree* collisionModels, const GroundGrid* groundCollisionModels,
+                         const GroundHeightfield* groundHeights, bool shiftDown);
+    // EyePos between the last two steps, at the time last passed to GetDuePhysicsSteps.
+    Vector3f GetRenderEyePos() const;
+
+	// groundHeights may be NULL; where it has a height it replaces the ground probe.
+	// The body's move makes at most planeBudget plane tests; returns how many it made.
+	int  HandleCollision(double dt, const CollisionTree* collisionModels,
+		                 const GroundGrid* groundCollisionModels,
+		                 const GroundHeightfield* groundHeights, bool shiftDown,
+		                 int planeBudget = CapsuleController::MaxPlaneTestsPerMove);
 };
 
 #endif